@@ -6,7 +6,8 @@
 // <vec2 - position, vec2 - uv>
 //layout(location = 0) in vec4 in_Vertex;
 layout(location = 0) in vec4 in_Vertex;
-layout(location = 1) in mat4 in_InstanceModel;
+// <vec2 - position, vec2 - size>
+layout(location = 1) in vec4 in_InstanceTransform;
 
 out vec2 uv;
 
@@ -20,6 +21,6 @@ void main()
 {
     uv = in_Vertex.zw;
 
-    vec2 position = in_Vertex.xy;
-    gl_Position = u_VP * in_InstanceModel * vec4(position, 0.f, 1.f);
+    vec2 position = in_InstanceTransform.xy + in_Vertex.xy * in_InstanceTransform.zw;
+    gl_Position = u_VP * vec4(position, 0.f, 1.f);
 }
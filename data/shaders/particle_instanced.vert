@@ -5,9 +5,10 @@
 
 // <vec2 - position, vec2 - uv>
 layout(location = 0) in vec4 in_Vertex;
-layout(location = 1) in mat4 in_InstanceModel;
-//layout(location = 5) in vec2 in_InstanceUVOffset;
-layout(location = 5) in vec4 in_InstanceColor;
+// <vec2 - position, vec2 - size>
+layout(location = 1) in vec4 in_InstanceTransform;
+//layout(location = 2) in vec2 in_InstanceUVOffset;
+layout(location = 2) in vec4 in_InstanceColor;
 
 //out vec2 uv;
 //out vec2 instanceUVOffset;
@@ -30,6 +31,6 @@ void main()
 
     Color = in_InstanceColor;
 
-    vec2 position = in_Vertex.xy;
-    gl_Position = u_VP * in_InstanceModel * vec4(position, 0.f, 1.f);
+    vec2 position = in_InstanceTransform.xy + in_Vertex.xy * in_InstanceTransform.zw;
+    gl_Position = u_VP * vec4(position, 0.f, 1.f);
 }
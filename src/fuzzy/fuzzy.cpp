@@ -16,12 +16,16 @@
 
 #include "fuzzy_math.cpp"
 #include "fuzzy_random.cpp"
+#include "fuzzy_physics.cpp"
 #include "fuzzy_containers.cpp"
+#include "fuzzy_strings.cpp"
 #include "fuzzy_tiled.cpp"
 #include "fuzzy_text.cpp"
 #include "fuzzy_renderer.cpp"
 #include "fuzzy_animations.cpp"
 #include "fuzzy_assets.cpp"
+#include "fuzzy_snapshot.cpp"
+#include "fuzzy_events.cpp"
 
 #include "fuzzy.h"
 
@@ -89,97 +93,352 @@ GetRandomInRange(f32 Min, f32 Max)
     return Result;
 }
 
-inline b32
-IntersectAABB(const aabb& Box1, const aabb& Box2)
+inline entity_state
+GetCurrentEntityState(behavior_component *Behavior)
+{
+    entity_state Result = Top(&Behavior->StatesStack);
+
+    return Result;
+}
+
+// note: swap-removes the entity, its render info and components, handles to other entities stay valid
+internal void
+DespawnEntity(game_state *GameState, slot_handle Handle)
 {
-    // Separating Axis Theorem
-    b32 XCollision = Box1.Position.x + Box1.Size.x > Box2.Position.x && Box1.Position.x < Box2.Position.x + Box2.Size.x;
-    b32 YCollision = Box1.Position.y + Box1.Size.y > Box2.Position.y && Box1.Position.y < Box2.Position.y + Box2.Size.y;
+    entity *Entity = Get(&GameState->DrawableEntities, Handle);
 
-    return XCollision && YCollision;
+    if (Entity)
+    {
+        Remove(&GameState->Bodies, Handle);
+        Remove(&GameState->Colliders, Handle);
+        Remove(&GameState->Animators, Handle);
+        Remove(&GameState->Behaviors, Handle);
+
+        Remove(&GameState->EntityRenderInfos, Entity->RenderInfo);
+        Remove(&GameState->DrawableEntities, Handle);
+    }
 }
 
-// basic Minkowski-based collision detection
-internal vec2
-SweptAABB(const vec2 Point, const vec2 Delta, const aabb& Box, const vec2 Padding)
+// note: every attribute of the burst comes out of a single bulk fill instead of one scalar draw per value,
+// the simulated ones are lerped in sim types so the fixed-point build doesn't depend on f32 rounding
+internal particle_burst
+GenerateParticleBurst(memory_arena *Arena, random_lanes *Entropy, u32 Count, f32 MinVelocityY, f32 MaxVelocityY)
 {
-    vec2 Time = vec2(1.f);
+    particle_burst Result = {};
 
-    f32 LeftTime = 1.f;
-    f32 RightTime = 1.f;
-    f32 TopTime = 1.f;
-    f32 BottomTime = 1.f;
+    u32 SimAttributeCount = 4;
+    u32 ColorAttributeCount = 3;
+    u32 ValueCount = (SimAttributeCount + ColorAttributeCount) * Count;
 
-    vec2 Position = Box.Position - Padding;
-    vec2 Size = Box.Size + Padding;
+    f32 *Values = PushArray<f32>(Arena, ValueCount, MEMORY_TAG_SCRATCH, CACHE_LINE_SIZE);
+    sim_f32 *SimValues = PushArray<sim_f32>(Arena, SimAttributeCount * Count, MEMORY_TAG_SCRATCH, CACHE_LINE_SIZE);
 
-    if (Delta.x != 0.f && Position.y < Point.y && Point.y < Position.y + Size.y)
+    RandomFill01(Entropy, Values, ValueCount);
+
+    Result.OffsetX = SimValues + 0 * Count;
+    Result.OffsetY = SimValues + 1 * Count;
+    Result.VelocityX = SimValues + 2 * Count;
+    Result.VelocityY = SimValues + 3 * Count;
+    Result.Red = Values + 4 * Count;
+    Result.Green = Values + 5 * Count;
+    Result.Blue = Values + 6 * Count;
+
+    for (u32 Index = 0; Index < Count; ++Index)
     {
-        LeftTime = (Position.x - Point.x) / Delta.x;
-        if (LeftTime < Time.x)
-        {
-            Time.x = LeftTime;
-        }
+        Result.OffsetX[Index] = SimLerp(SimScalar(-0.1f), SimScalar(Values[0 * Count + Index]), SimScalar(0.1f));
+        Result.OffsetY[Index] = SimLerp(SimScalar(0.f), SimScalar(Values[1 * Count + Index]), SimScalar(0.1f));
+        Result.VelocityX[Index] = SimLerp(SimScalar(-0.5f), SimScalar(Values[2 * Count + Index]), SimScalar(0.5f));
+        Result.VelocityY[Index] = SimLerp(SimScalar(MinVelocityY), SimScalar(Values[3 * Count + Index]), SimScalar(MaxVelocityY));
+        Result.Red[Index] = Lerp(0.75f, Result.Red[Index], 1.f);
+        Result.Green[Index] = Lerp(0.75f, Result.Green[Index], 1.f);
+        Result.Blue[Index] = Lerp(0.75f, Result.Blue[Index], 1.f);
+    }
 
-        RightTime = (Position.x + Size.x - Point.x) / Delta.x;
-        if (RightTime < Time.x)
-        {
-            Time.x = RightTime;
-        }
+    return Result;
+}
+
+// note: hits spawn in one pass, once MAX_PLAYER_DIVE_PARTICLE_COUNT particles are alive the rest of the hits' particles are dropped
+internal void
+SpawnPlayerDiveParticles(game_state *GameState, event_player_dive_hit *Hits, u32 HitCount)
+{
+    u32 ParticlesPerHit = 20;
+    memory_pool<particle> *Pool = &GameState->PlayerDiveParticles;
+
+    u32 SpawnCount = HitCount * ParticlesPerHit;
+    u32 FreeCount = MAX_PLAYER_DIVE_PARTICLE_COUNT - Pool->LiveCount;
+
+    if (SpawnCount > FreeCount)
+    {
+        SpawnCount = FreeCount;
     }
 
-    if (Delta.y != 0.f && Position.x < Point.x && Point.x < Position.x + Size.x)
+    particle_burst Burst = GenerateParticleBurst(&GameState->FrameArena, &GameState->Entropy, SpawnCount, 4.f, 4.2f);
+
+    for (u32 SpawnIndex = 0; SpawnIndex < SpawnCount; ++SpawnIndex)
     {
-        TopTime = (Position.y - Point.y) / Delta.y;
-        if (TopTime < Time.y)
-        {
-            Time.y = TopTime;
-        }
+        event_player_dive_hit *Hit = Hits + SpawnIndex / ParticlesPerHit;
+        particle *Particle = PoolAlloc(Pool);
+
+        u32 BurstIndex = SpawnIndex;
+
+        Particle->Position = SimVec2(Burst.OffsetX[BurstIndex], Burst.OffsetY[BurstIndex]) + Hit->Position;
+        Particle->Velocity = SimVec2(Burst.VelocityX[BurstIndex], Burst.VelocityY[BurstIndex]);
+        Particle->Acceleration = SimVec2(vec2(0.f, -6.5f));
+        Particle->Color = vec4(Burst.Red[BurstIndex], Burst.Green[BurstIndex], Burst.Blue[BurstIndex], 1.0f);
+        Particle->dColor = vec4(0.f, 0.f, 0.f, -0.6f);
+        Particle->Size = SimVec2(vec2(0.1f));
+        Particle->dSize = SimVec2(vec2(-0.02f));
+        // note: render infos are packed from the live particles every frame
+        Particle->RenderInfo = 0;
+    }
+}
+
+inline vec2
+GetScreenCenterInWorldUnits(game_state *GameState)
+{
+    vec2 Result = vec2(GameState->ScreenWidthInWorldUnits / 2.f, GameState->ScreenHeightInWorldUnits / 2.f);
+    return Result;
+}
+
+// note: the inputs BuildInstanceTransforms packs into the uploaded transforms
+struct instance_inputs
+{
+    f32 *X;
+    f32 *Y;
+    f32 *Width;
+    f32 *Height;
+};
+
+// note: staged in the ring, so the inputs stay valid for a few frames after their upload, the frame arena takes over if the ring is full
+internal instance_inputs
+PushInstanceInputs(game_state *GameState, u32 Count)
+{
+    instance_inputs Result = {};
+
+    Result.X = PushRingArray<f32>(GameState->StagingArena, Count, CACHE_LINE_SIZE);
+    Result.Y = PushRingArray<f32>(GameState->StagingArena, Count, CACHE_LINE_SIZE);
+    Result.Width = PushRingArray<f32>(GameState->StagingArena, Count, CACHE_LINE_SIZE);
+    Result.Height = PushRingArray<f32>(GameState->StagingArena, Count, CACHE_LINE_SIZE);
+
+    if (!Result.X || !Result.Y || !Result.Width || !Result.Height)
+    {
+        Result.X = PushArray<f32>(&GameState->FrameArena, Count, MEMORY_TAG_STAGING, CACHE_LINE_SIZE);
+        Result.Y = PushArray<f32>(&GameState->FrameArena, Count, MEMORY_TAG_STAGING, CACHE_LINE_SIZE);
+        Result.Width = PushArray<f32>(&GameState->FrameArena, Count, MEMORY_TAG_STAGING, CACHE_LINE_SIZE);
+        Result.Height = PushArray<f32>(&GameState->FrameArena, Count, MEMORY_TAG_STAGING, CACHE_LINE_SIZE);
+    }
+
+    return Result;
+}
+
+// note: Inflate scales every entity around its center, the border pass draws slightly bigger copies
+internal void
+BuildEntityInstanceTransforms(game_state *GameState, f32 Inflate)
+{
+    slot_map<entity_render_info> *EntityRenderInfos = &GameState->EntityRenderInfos;
+    u32 Count = EntityRenderInfos->Count;
+
+    instance_inputs Inputs = PushInstanceInputs(GameState, Count);
+    f32 *X = Inputs.X;
+    f32 *Y = Inputs.Y;
+    f32 *Width = Inputs.Width;
+    f32 *Height = Inputs.Height;
+
+    vec2 ScreenCenter = GetScreenCenterInWorldUnits(GameState);
+
+    for (u32 DrawableEntityIndex = 0; DrawableEntityIndex < GameState->DrawableEntities.Count; ++DrawableEntityIndex)
+    {
+        entity *Entity = GameState->DrawableEntities.Values + DrawableEntityIndex;
+        entity_render_info *RenderInfo = Get(EntityRenderInfos, Entity->RenderInfo);
 
-        BottomTime = (Position.y + Size.y - Point.y) / Delta.y;
-        if (BottomTime < Time.y)
+        // note: the inputs follow the render infos' dense order, which isn't necessarily the entities' one
+        u32 InstanceIndex = (u32)(RenderInfo - EntityRenderInfos->Values);
+
+        vec2 EntitySize = ToVec2(Entity->Size);
+        vec2 Size = EntitySize * Inflate;
+        vec2 Position = ScreenCenter + ToVec2(Entity->Position) - (Size - EntitySize) / 2.f;
+
+        X[InstanceIndex] = Position.x;
+        Y[InstanceIndex] = Position.y;
+        Width[InstanceIndex] = Size.x;
+        Height[InstanceIndex] = Size.y;
+    }
+
+    BuildInstanceTransforms(Count, X, Y, Width, Height, &EntityRenderInfos->Values[0].Transform, sizeof(entity_render_info));
+}
+
+internal void
+BuildBoxInstanceTransforms(game_state *GameState, sim_aabb *Boxes, u32 Count, instance_transform *Transforms)
+{
+    instance_inputs Inputs = PushInstanceInputs(GameState, Count);
+    f32 *X = Inputs.X;
+    f32 *Y = Inputs.Y;
+    f32 *Width = Inputs.Width;
+    f32 *Height = Inputs.Height;
+
+    for (u32 BoxIndex = 0; BoxIndex < Count; ++BoxIndex)
+    {
+        sim_aabb *Box = Boxes + BoxIndex;
+
+        X[BoxIndex] = ToF32(Box->Position.x);
+        Y[BoxIndex] = ToF32(Box->Position.y);
+        Width[BoxIndex] = ToF32(Box->Size.x);
+        Height[BoxIndex] = ToF32(Box->Size.y);
+    }
+
+    BuildInstanceTransforms(Count, X, Y, Width, Height, Transforms);
+}
+
+// note: the physics bodies follow the order of the Bodies set, returns the player's index among them
+internal u32
+GatherPhysicsBodies(game_state *GameState)
+{
+    u32 Result = 0;
+    b32 FoundPlayer = false;
+
+    physics_system *Physics = GameState->Physics;
+    Physics->BodyCount = GameState->Bodies.Count;
+
+    for (u32 BodyIndex = 0; BodyIndex < GameState->Bodies.Count; ++BodyIndex)
+    {
+        slot_handle EntityHandle = GameState->Bodies.Entities[BodyIndex];
+
+        entity *Entity = Get(&GameState->DrawableEntities, EntityHandle);
+        collider_component *Collider = Get(&GameState->Colliders, EntityHandle);
+
+        physics_body *PhysicsBody = Physics->Bodies + BodyIndex;
+        PhysicsBody->Body = GameState->Bodies.Values + BodyIndex;
+        PhysicsBody->Position = &Entity->Position;
+
+        // note: a collider's boxes were pushed one after another
+        PhysicsBody->Boxes = Collider && Collider->BoxCount > 0 ? Collider->Boxes[0].Box : 0;
+        PhysicsBody->BoxCount = Collider ? Collider->BoxCount : 0;
+
+        if (EntityHandle == GameState->Player)
         {
-            Time.y = BottomTime;
+            Result = BodyIndex;
+            FoundPlayer = true;
         }
     }
 
-    return Time;
+    Assert(FoundPlayer);
+
+    return Result;
+}
+
+// note: particles collide as points with the tiles and bounce off them; their positions are relative to the map origin
+internal void
+MoveParticle(tile_grid *TileGrid, particle *Particle, sim_vec2 Move)
+{
+    sim_f32 One = SimScalar(1.f);
+    sim_f32 CoefficientOfRestitution = SimScalar(0.3f);
+
+    sim_vec2 CollisionTime = SimVec2(One, One);
+    SweepTileGrid(TileGrid, TileGrid->Origin + Particle->Position, SimVec2(vec2(0.f)), Move, &CollisionTime);
+
+    Particle->Position += Move * CollisionTime;
+
+    if (CollisionTime.x < One)
+    {
+        Particle->Velocity.x = -Particle->Velocity.x * CoefficientOfRestitution;
+    }
+
+    if (CollisionTime.y < One)
+    {
+        Particle->Velocity.y = -Particle->Velocity.y * CoefficientOfRestitution;
+    }
 }
 
-inline entity_state
-GetCurrentEntityState(entity *Entity)
+// note: dead particles collapse to an empty quad
+internal void
+BuildParticleInstanceTransforms(game_state *GameState, particle *Particles, u32 Count)
 {
-    entity_state Result = Top(&Entity->StatesStack);
+    instance_inputs Inputs = PushInstanceInputs(GameState, Count);
+    f32 *X = Inputs.X;
+    f32 *Y = Inputs.Y;
+    f32 *Width = Inputs.Width;
+    f32 *Height = Inputs.Height;
 
-    return Result;
+    vec2 ScreenCenter = GetScreenCenterInWorldUnits(GameState);
+
+    for (u32 ParticleIndex = 0; ParticleIndex < Count; ++ParticleIndex)
+    {
+        particle *Particle = Particles + ParticleIndex;
+        b32 IsAlive = Particle->Color.a > 0.f;
+
+        X[ParticleIndex] = IsAlive ? ScreenCenter.x + ToF32(Particle->Position.x) : 0.f;
+        Y[ParticleIndex] = IsAlive ? ScreenCenter.y + ToF32(Particle->Position.y) : 0.f;
+        Width[ParticleIndex] = IsAlive ? ToF32(Particle->Size.x) : 0.f;
+        Height[ParticleIndex] = IsAlive ? ToF32(Particle->Size.y) : 0.f;
+    }
+
+    // note: particle render infos are laid out in the same order as the particles
+    BuildInstanceTransforms(Count, X, Y, Width, Height, &Particles[0].RenderInfo->Transform, sizeof(particle_render_info));
 }
 
-inline void
-EmitEvent(game_state *GameState, event_type Type)
+internal u32
+FormatMemoryStats(memory_arena *Arena, const char *ArenaName, char *Buffer, u32 BufferSize)
 {
-    event Event = {};
-    Event.Type = Type;
+    u32 Length = 0;
+
+    FormatString(Buffer, BufferSize, "%s,total,%zu,%zu,%u,%zu,%zu\n", 
+        ArenaName, Arena->Stats.Used, Arena->Stats.HighWaterMark, Arena->Stats.AllocationCount, Arena->Size, Arena->CommittedSize);
+    Length += StringLength(Buffer);
+
+    for (u32 TagIndex = 0; TagIndex < MEMORY_TAG_COUNT; ++TagIndex)
+    {
+        memory_stats *TagStats = Arena->TagStats + TagIndex;
 
-    Enqueue(&GameState->EventQueue, Event);
+        if (TagStats->HighWaterMark > 0)
+        {
+            FormatString(Buffer + Length, BufferSize - Length, "%s,%s,%zu,%zu,%u,,\n", 
+                ArenaName, GetMemoryTagName((memory_tag)TagIndex), TagStats->Used, TagStats->HighWaterMark, TagStats->AllocationCount);
+            Length += StringLength(Buffer + Length);
+        }
+    }
+
+    return Length;
 }
 
-inline void
-EmitEvent(game_state *GameState, event_type Type, event_data Data)
+internal void
+PrintHashTableStats(platform_api *Platform, const char *Name, hash_table_stats Stats)
+{
+    char Output[256];
+    FormatString(Output, sizeof(Output), "%s: %u / %u, load: %.2f, probes: %.2f avg, %u max\n",
+        Name, Stats.Count, Stats.Capacity, Stats.LoadFactor, Stats.AverageProbeLength, Stats.MaxProbeLength);
+    Platform->PrintOutput(Output);
+}
+
+internal void
+DumpMemoryStats(game_state *GameState, platform_api *Platform)
 {
-    event Event = {};
-    Event.Type = Type;
-    Event.Data = PushStruct<event_data>(&GameState->WorldArena);
+    u32 BufferSize = (u32)Kilobytes(16);
+    char *Buffer = PushString(&GameState->FrameArena, BufferSize, MEMORY_TAG_DEBUG);
 
-    Enqueue(&GameState->EventQueue, Event);
+    FormatString(Buffer, BufferSize, "arena,tag,used,high_water_mark,allocations,size,committed\n");
+    u32 Length = StringLength(Buffer);
+
+    Length += FormatMemoryStats(&GameState->WorldArena, "world", Buffer + Length, BufferSize - Length);
+    Length += FormatMemoryStats(&GameState->TransientArena, "transient", Buffer + Length, BufferSize - Length);
+    Length += FormatMemoryStats(&GameState->FrameArena, "frame", Buffer + Length, BufferSize - Length);
+
+    if (!Platform->WriteFile("memory_stats.csv", Length, Buffer))
+    {
+        Platform->PrintOutput("Failed to write memory stats\n");
+    }
 }
 
 internal void
 ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
 {
-    entity_state PlayerState = GetCurrentEntityState(GameState->Player);
+    entity *Player = Get(&GameState->DrawableEntities, GameState->Player);
+    body_component *PlayerBody = Get(&GameState->Bodies, GameState->Player);
+    behavior_component *PlayerBehavior = Get(&GameState->Behaviors, GameState->Player);
 
-    f32 JumpAcceleration = 25.f;
-    f32 RunAcceleration = 5.f;
+    entity_state PlayerState = GetCurrentEntityState(PlayerBehavior);
+
+    sim_f32 JumpAcceleration = SimScalar(25.f);
+    sim_f32 RunAcceleration = SimScalar(5.f);
 
     // todo: move out common parts
     switch (PlayerState)
@@ -187,48 +446,48 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
     case ENTITY_STATE_IDLE:
         if (Input->Left.isPressed || Input->Right.isPressed)
         {
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_RUN);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_RUN);
         }
         if (Input->Jump.isPressed && !Input->Jump.isProcessed)
         {
             Input->Jump.isProcessed = true;
 
-            GameState->Player->Acceleration.y = JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
         }
         if (Input->Down.isPressed)
         {
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_DUCK);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_DUCK);
         }
         if (Input->Attack.isPressed && !Input->Attack.isProcessed)
         {
             Input->Attack.isProcessed = true;
 
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_ATTACK);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_ATTACK);
         }
         break;
     case ENTITY_STATE_RUN:
         if (!Input->Left.isPressed && !Input->Right.isPressed)
         {
-            Pop(&GameState->Player->StatesStack);
+            Pop(&PlayerBehavior->StatesStack);
         }
         if (Input->Jump.isPressed && !Input->Jump.isProcessed)
         {
             Input->Jump.isProcessed = true;
 
             // todo: duplicate
-            GameState->Player->Acceleration.y = JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
         }
         if (Input->Down.isPressed)
         {
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_DUCK);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_DUCK);
         }
         if (Input->Attack.isPressed && !Input->Attack.isProcessed)
         {
             Input->Attack.isProcessed = true;
 
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_ATTACK);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_ATTACK);
         }
         break;
     case ENTITY_STATE_JUMP:
@@ -236,22 +495,22 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
         {
             Input->Attack.isProcessed = true;
 
-            //Push(&GameState->Player->StatesStack, ENTITY_STATE_ATTACK);
+            //Push(&PlayerBehavior->StatesStack, ENTITY_STATE_ATTACK);
         }
         if (Input->Jump.isPressed && !Input->Jump.isProcessed)
         {
             Input->Jump.isProcessed = true;
 
-            GameState->Player->Acceleration.y = JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
         }
         if (Input->Down.isPressed)
         {
-            GameState->Player->Acceleration.y = -JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = -JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
 
-            Pop(&GameState->Player->StatesStack);
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_DIVE);
+            Pop(&PlayerBehavior->StatesStack);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_DIVE);
         }
         break;
     case ENTITY_STATE_FALL:
@@ -259,28 +518,28 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
         {
             Input->Attack.isProcessed = true;
 
-            //Push(&GameState->Player->StatesStack, ENTITY_STATE_ATTACK);
+            //Push(&PlayerBehavior->StatesStack, ENTITY_STATE_ATTACK);
         }
         if (Input->Jump.isPressed && !Input->Jump.isProcessed)
         {
             Input->Jump.isProcessed = true;
 
-            GameState->Player->Acceleration.y = JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
         }
         if (Input->Down.isPressed)
         {
-            GameState->Player->Acceleration.y = -JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = -JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
 
-            Pop(&GameState->Player->StatesStack);
-            Push(&GameState->Player->StatesStack, ENTITY_STATE_DIVE);
+            Pop(&PlayerBehavior->StatesStack);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_DIVE);
         }
         break;
     case ENTITY_STATE_DUCK:
         if (!Input->Down.isPressed)
         {
-            Pop(&GameState->Player->StatesStack);
+            Pop(&PlayerBehavior->StatesStack);
         }
         break;
     case ENTITY_STATE_ATTACK:
@@ -290,20 +549,20 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
         {
             Input->Jump.isProcessed = true;
 
-            GameState->Player->Acceleration.y = JumpAcceleration;
-            GameState->Player->Velocity.y = 0.f;
+            PlayerBody->Acceleration.y = JumpAcceleration;
+            PlayerBody->Velocity.y = SimScalar(0.f);
 
-            Pop(&GameState->Player->StatesStack);
-            //Push(&GameState->Player->StatesStack, ENTITY_STATE_JUMP);
+            Pop(&PlayerBehavior->StatesStack);
+            //Push(&PlayerBehavior->StatesStack, ENTITY_STATE_JUMP);
         }
         break;
     //case ENTITY_STATE_DIVE:
     //    if (Input->Down.isPressed)
     //    {
-    //        GameState->Player->Acceleration.y = -JumpAcceleration;
-    //        GameState->Player->Velocity.y = 0.f;
+    //        PlayerBody->Acceleration.y = -JumpAcceleration;
+    //        PlayerBody->Velocity.y = 0.f;
 
-    //        Pop(&GameState->Player->StatesStack);
+    //        Pop(&PlayerBehavior->StatesStack);
     //    }
     //    break;
     default:
@@ -314,10 +573,10 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
     {
         if (PlayerState != ENTITY_STATE_DUCK)
         {
-            GameState->Player->Acceleration.x = -RunAcceleration;
+            PlayerBody->Acceleration.x = -RunAcceleration;
 
             // todo: in future handle flipped vertically/diagonally
-            GameState->Player->RenderInfo->Flipped = true;
+            Get(&GameState->EntityRenderInfos, Player->RenderInfo)->Flipped = true;
         }
     }
 
@@ -325,9 +584,9 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
     {
         if (PlayerState != ENTITY_STATE_DUCK)
         {
-            GameState->Player->Acceleration.x = RunAcceleration;
+            PlayerBody->Acceleration.x = RunAcceleration;
 
-            GameState->Player->RenderInfo->Flipped = false;
+            Get(&GameState->EntityRenderInfos, Player->RenderInfo)->Flipped = false;
         }
     }
 
@@ -343,6 +602,160 @@ ProcessInput(game_state *GameState, game_input *Input, f32 Delta)
     }
 }
 
+// note: tile boxes are in pixels with y pointing down, Origin is the bottom-left corner of the tile in world units
+inline sim_aabb
+GetSimBox(tileset *Tileset, aabb *TileBox, sim_vec2 Origin)
+{
+    sim_aabb Result;
+
+    sim_f32 PixelsToWorldUnitsX = SimScalar(Tileset->TilesetWidthPixelsToWorldUnits);
+    sim_f32 PixelsToWorldUnitsY = SimScalar(Tileset->TilesetHeightPixelsToWorldUnits);
+
+    Result.Position.x = Origin.x + SimScalar(TileBox->Position.x) * PixelsToWorldUnitsX;
+    Result.Position.y = Origin.y +
+        (SimScalar((f32)Tileset->TileHeightInPixels) - SimScalar(TileBox->Position.y) - SimScalar(TileBox->Size.y)) * PixelsToWorldUnitsY;
+
+    Result.Size.x = SimScalar(TileBox->Size.x) * PixelsToWorldUnitsX;
+    Result.Size.y = SimScalar(TileBox->Size.y) * PixelsToWorldUnitsY;
+
+    return Result;
+}
+
+// note: in tile units from the map origin, so the shared edge of two neighbouring tiles comes out exactly equal for both
+inline sim_aabb
+GetTileUnitBox(tileset *Tileset, aabb *TileBox, i32 TileMapX, i32 TileMapY)
+{
+    sim_aabb Result;
+
+    f32 TileWidth = (f32)Tileset->TileWidthInPixels;
+    f32 TileHeight = (f32)Tileset->TileHeightInPixels;
+
+    Result.Position.x = SimScalar((f32)TileMapX + TileBox->Position.x / TileWidth);
+    Result.Position.y = SimScalar((f32)TileMapY + (TileHeight - TileBox->Position.y - TileBox->Size.y) / TileHeight);
+
+    Result.Size.x = SimScalar(TileBox->Size.x / TileWidth);
+    Result.Size.y = SimScalar(TileBox->Size.y / TileHeight);
+
+    return Result;
+}
+
+inline sim_aabb
+GetSimBoxFromTileUnits(tileset *Tileset, sim_aabb *TileUnitBox, sim_vec2 Origin)
+{
+    sim_aabb Result;
+
+    sim_vec2 TileSize = SimVec2(vec2(Tileset->TileWidthInWorldUnits, Tileset->TileHeightInWorldUnits));
+
+    Result.Position = Origin + TileUnitBox->Position * TileSize;
+    Result.Size = TileUnitBox->Size * TileSize;
+
+    return Result;
+}
+
+// note: tile boxes are stored once per tile id, the layers' chunks merge them and bake them into world units
+internal void
+InitializeTileGrid(
+    tile_grid *Grid,
+    tilemap *Map,
+    tileset *Tileset,
+    u32 FirstGID,
+    sim_vec2 Origin,
+    memory_arena *Arena,
+    memory_arena *ScratchArena
+)
+{
+    *Grid = {};
+
+    Grid->Origin = Origin;
+    Grid->TileSize = SimVec2(vec2(Tileset->TileWidthInWorldUnits, Tileset->TileHeightInWorldUnits));
+    Grid->FirstGID = FirstGID;
+
+    for (u32 TileIndex = 0; TileIndex < Tileset->Tiles.Capacity; ++TileIndex)
+    {
+        tile_meta_info *Tile = Tileset->Tiles.Values + TileIndex;
+
+        if (IsSlotOccupied(&Tileset->Tiles, TileIndex) && Tile->Id + 1 > Grid->TileIDCount)
+        {
+            Grid->TileIDCount = Tile->Id + 1;
+        }
+    }
+
+    Grid->TileBoxOffsets = PushArray<u32>(Arena, Grid->TileIDCount + 1, MEMORY_TAG_COLLISION);
+
+    for (u32 TileID = 0; TileID <= Grid->TileIDCount; ++TileID)
+    {
+        Grid->TileBoxOffsets[TileID] = 0;
+    }
+
+    for (u32 TileIndex = 0; TileIndex < Tileset->Tiles.Capacity; ++TileIndex)
+    {
+        tile_meta_info *Tile = Tileset->Tiles.Values + TileIndex;
+
+        if (IsSlotOccupied(&Tileset->Tiles, TileIndex))
+        {
+            Grid->TileBoxOffsets[Tile->Id + 1] = Tile->BoxCount;
+        }
+    }
+
+    for (u32 TileID = 0; TileID < Grid->TileIDCount; ++TileID)
+    {
+        Grid->TileBoxOffsets[TileID + 1] += Grid->TileBoxOffsets[TileID];
+    }
+
+    Grid->TileBoxes = PushArray<sim_aabb>(Arena, Grid->TileBoxOffsets[Grid->TileIDCount], MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    for (u32 TileIndex = 0; TileIndex < Tileset->Tiles.Capacity; ++TileIndex)
+    {
+        tile_meta_info *Tile = Tileset->Tiles.Values + TileIndex;
+
+        if (IsSlotOccupied(&Tileset->Tiles, TileIndex))
+        {
+            for (u32 BoxIndex = 0; BoxIndex < Tile->BoxCount; ++BoxIndex)
+            {
+                Grid->TileBoxes[Grid->TileBoxOffsets[Tile->Id] + BoxIndex] = GetTileUnitBox(Tileset, Tile->Boxes + BoxIndex, 0, 0);
+            }
+        }
+    }
+
+    Grid->Layers = PushArray<tile_grid_layer>(Arena, Map->TileLayerCount, MEMORY_TAG_COLLISION);
+
+    for (u32 TileLayerIndex = 0; TileLayerIndex < Map->TileLayerCount; ++TileLayerIndex)
+    {
+        tile_layer *TileLayer = Map->TileLayers + TileLayerIndex;
+
+        if (TileLayer->Visible && TileLayer->ChunkCount > 0)
+        {
+            map_chunk *FirstChunk = TileLayer->Chunks;
+
+            i32 MinX = FirstChunk->X;
+            i32 MaxX = FirstChunk->X;
+            i32 MinY = FirstChunk->Y;
+            i32 MaxY = FirstChunk->Y;
+
+            for (u32 ChunkIndex = 1; ChunkIndex < TileLayer->ChunkCount; ++ChunkIndex)
+            {
+                map_chunk *Chunk = TileLayer->Chunks + ChunkIndex;
+
+                Assert(Chunk->Width == FirstChunk->Width && Chunk->Height == FirstChunk->Height);
+
+                MinX = Chunk->X < MinX ? Chunk->X : MinX;
+                MaxX = Chunk->X > MaxX ? Chunk->X : MaxX;
+                MinY = Chunk->Y < MinY ? Chunk->Y : MinY;
+                MaxY = Chunk->Y > MaxY ? Chunk->Y : MaxY;
+            }
+
+            tile_grid_layer *Layer = Grid->Layers + Grid->LayerCount++;
+            InitializeTileGridLayer(Layer, (i32)FirstChunk->Width, (i32)FirstChunk->Height, MinX, MaxX, MinY, MaxY, Arena);
+
+            for (u32 ChunkIndex = 0; ChunkIndex < TileLayer->ChunkCount; ++ChunkIndex)
+            {
+                map_chunk *Chunk = TileLayer->Chunks + ChunkIndex;
+                SetTileGridChunk(Grid, Layer, Chunk->X, Chunk->Y, Chunk->GIDs, Arena, ScratchArena);
+            }
+        }
+    }
+}
+
 inline vec2
 GetUVOffset01FromTileID(tileset *Tileset, u32 TileID)
 {
@@ -367,20 +780,31 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     i32 ScreenHeight = Params->ScreenHeight;
     vec2 ScreenCenter = vec2(ScreenWidth / 2.f, ScreenHeight / 2.f);
 
-    InitializeMemoryArena(
+    InitializeGrowableMemoryArena(
         &GameState->WorldArena,
         Memory->PermanentStorageSize - sizeof(game_state),
-        (u8*)Memory->PermanentStorage + sizeof(game_state)
+        (u8*)Memory->PermanentStorage + sizeof(game_state),
+        Memory->PermanentStorageCommittedSize - sizeof(game_state),
+        Platform->CommitMemory
+    );
+
+    InitializeGrowableMemoryArena(
+        &GameState->TransientArena,
+        Memory->TransientStorageSize,
+        Memory->TransientStorage,
+        Memory->TransientStorageCommittedSize,
+        Platform->CommitMemory
     );
+    InitializeSubArena(&GameState->FrameArena, &GameState->TransientArena, Megabytes(32));
+
+    GameState->StagingArena = PushStruct<ring_arena>(&GameState->TransientArena, MEMORY_TAG_STAGING);
+    InitializeRingArena(GameState->StagingArena, &GameState->TransientArena, Megabytes(16), 3, MEMORY_TAG_STAGING);
+    // note: the uploads made while loading the level go into the ring's first frame
+    BeginRingArenaFrame(GameState->StagingArena);
 
     LoadGameAssets(&Memory->Platform, GameState, &GameState->WorldArena);
 
-    // initialize event queue (todo: move to separate function)
-    GameState->EventQueue = {};
-    GameState->EventQueue.Head = 0;
-    GameState->EventQueue.Tail = 0;
-    GameState->EventQueue.MaxCount = 10;
-    GameState->EventQueue.Values = PushArray<event>(&GameState->WorldArena, GameState->EventQueue.MaxCount);
+    BeginEventBusFrame(&GameState->Events, &GameState->FrameArena);
 
     GameState->CurrentFont = GameState->FontAssets + 1;
 
@@ -393,9 +817,31 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
     GameState->ScreenHeightInWorldUnits = ScreenHeight * PixelsToWorldUnits;
 
-    char *MapJson = (char *)Platform->ReadFile("maps/map01.json").Contents;
+    read_file_result MapFile = Platform->ReadFile("maps/map01.json");
     GameState->Map = {};
-    LoadMap(&GameState->Map, MapJson, &GameState->WorldArena, Platform);
+    LoadMap(&GameState->Map, (char *)MapFile.Contents, &GameState->WorldArena, &GameState->TransientArena, Platform);
+    Platform->FreeFile(MapFile);
+
+    u32 AnimationCount = 0;
+
+    for (u32 TilesetIndex = 0; TilesetIndex < GameState->Map.TilesetCount; ++TilesetIndex)
+    {
+        tileset_source *TilesetSource = GameState->Map.Tilesets + TilesetIndex;
+        tileset Tileset = TilesetSource->Source;
+
+        for (u32 TileIndex = 0; TileIndex < Tileset.Tiles.Capacity; ++TileIndex)
+        {
+            tile_meta_info *Tile = Tileset.Tiles.Values + TileIndex;
+
+            if (IsSlotOccupied(&Tileset.Tiles, TileIndex) && Tile->AnimationFrameCount > 0)
+            {
+                ++AnimationCount;
+            }
+        }
+    }
+
+    // note: the interned strings are the animation names of the map's tilesets and the shaders' uniform names
+    InitializeHashTable(&GameState->Strings, AnimationCount + MAX_UNIFORM_NAME_COUNT, &GameState->WorldArena, MEMORY_TAG_STRINGS);
 
     tile_meta_info *TileInfo = GetTileMetaInfo(&GameState->Map.Tilesets[0].Source, 544);
 
@@ -442,7 +888,7 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
         Renderer->glUseProgram(GameState->TilesShaderProgram.ProgramHandle);
 
-        shader_uniform *TileSizeUniform = GetUniform(&GameState->TilesShaderProgram, "u_TileSize");
+        shader_uniform *TileSizeUniform = GetUniform(&GameState->TilesShaderProgram, SID("u_TileSize"));
         SetShaderUniform(Renderer, TileSizeUniform->Location, TileSize01);
     }
 
@@ -463,7 +909,7 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
         Renderer->glUseProgram(GameState->DrawableEntitiesShaderProgram.ProgramHandle);
 
-        shader_uniform *TileSizeUniform = GetUniform(&GameState->DrawableEntitiesShaderProgram, "u_TileSize");
+        shader_uniform *TileSizeUniform = GetUniform(&GameState->DrawableEntitiesShaderProgram, SID("u_TileSize"));
         SetShaderUniform(Renderer, TileSizeUniform->Location, TileSize01);
     }
 
@@ -500,7 +946,7 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
         Renderer->glUseProgram(GameState->ParticlesShaderProgram.ProgramHandle);
 
-        /*shader_uniform *TileSizeUniform = GetUniform(&GameState->ParticlesShaderProgram, "u_TileSize");
+        /*shader_uniform *TileSizeUniform = GetUniform(&GameState->ParticlesShaderProgram, SID("u_TileSize"));
         SetShaderUniform(Memory, TileSizeUniform->Location, TileSize01);*/
     }
 
@@ -513,7 +959,7 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
         Renderer->glUseProgram(GameState->SpriteShaderProgram.ProgramHandle);
 
-        shader_uniform *TileSizeUniform = GetUniform(&GameState->SpriteShaderProgram, "u_TileSize");
+        shader_uniform *TileSizeUniform = GetUniform(&GameState->SpriteShaderProgram, SID("u_TileSize"));
         SetShaderUniform(Renderer, TileSizeUniform->Location, TileSize01);
     }
 
@@ -523,6 +969,12 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
         u32 transformsUniformBlockIndex = Renderer->glGetUniformBlockIndex(GameState->TextShaderProgram.ProgramHandle, "transforms");
         Renderer->glUniformBlockBinding(GameState->TextShaderProgram.ProgramHandle, transformsUniformBlockIndex, transformsBindingPoint);
+
+        text_shader_uniforms *TextUniforms = &GameState->TextUniforms;
+        TextUniforms->Model = GetUniform(&GameState->TextShaderProgram, SID("u_Model"));
+        TextUniforms->UVOffset = GetUniform(&GameState->TextShaderProgram, SID("u_UVOffset"));
+        TextUniforms->SpriteSize = GetUniform(&GameState->TextShaderProgram, SID("u_SpriteSize"));
+        TextUniforms->TextColor = GetUniform(&GameState->TextShaderProgram, SID("u_TextColor"));
     }
 
 
@@ -542,7 +994,7 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     u32 QuadVerticesSize = ArrayCount(QuadVerticesData) * sizeof(f32);
     GameState->QuadVerticesSize = QuadVerticesSize;
 
-    f32 *QuadVertices = PushArray<f32>(&GameState->WorldArena, ArrayCount(QuadVerticesData));
+    f32 *QuadVertices = PushArray<f32>(&GameState->WorldArena, ArrayCount(QuadVerticesData), MEMORY_TAG_RENDERER);
     for (u32 Index = 0; Index < ArrayCount(QuadVerticesData); ++Index)
     {
         f32 *QuadVertex = QuadVertices + Index;
@@ -611,36 +1063,18 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         }
     }
 
-    GameState->Animations.Count = 0;
+    InitializeHashTable(&GameState->Animations, AnimationCount, &GameState->WorldArena, MEMORY_TAG_ANIMATIONS);
 
     for (u32 TilesetIndex = 0; TilesetIndex < GameState->Map.TilesetCount; ++TilesetIndex)
     {
         tileset_source *TilesetSource = GameState->Map.Tilesets + TilesetIndex;
         tileset Tileset = TilesetSource->Source;
 
-        for (u32 TileIndex = 0; TileIndex < Tileset.Tiles.Count; ++TileIndex)
+        for (u32 TileIndex = 0; TileIndex < Tileset.Tiles.Capacity; ++TileIndex)
         {
             tile_meta_info *Tile = Tileset.Tiles.Values + TileIndex;
 
-            if (Tile->AnimationFrameCount > 0)
-            {
-                ++GameState->Animations.Count;
-            }
-        }
-    }
-
-    GameState->Animations.Values = PushArray<animation>(&GameState->WorldArena, GameState->Animations.Count);
-
-    for (u32 TilesetIndex = 0; TilesetIndex < GameState->Map.TilesetCount; ++TilesetIndex)
-    {
-        tileset_source *TilesetSource = GameState->Map.Tilesets + TilesetIndex;
-        tileset Tileset = TilesetSource->Source;
-
-        for (u32 TileIndex = 0; TileIndex < Tileset.Tiles.Count; ++TileIndex)
-        {
-            tile_meta_info *Tile = Tileset.Tiles.Values + TileIndex;
-
-            if (Tile->AnimationFrameCount > 0)
+            if (IsSlotOccupied(&Tileset.Tiles, TileIndex) && Tile->AnimationFrameCount > 0)
             {
                 char *AnimationName = 0;
                 b32 StopOnTheLastFrame = false;
@@ -662,13 +1096,13 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
                 Assert(AnimationName);
 
-                animation *Animation = CreateAnimation(GameState, AnimationName, &GameState->WorldArena);
+                animation *Animation = CreateAnimation(GameState, InternString(&GameState->Strings, AnimationName));
 
                 Animation->Name = AnimationName;
                 Animation->StopOnTheLastFrame = StopOnTheLastFrame;
                 Animation->CurrentFrameIndex = 0;
                 Animation->AnimationFrameCount = Tile->AnimationFrameCount;
-                Animation->AnimationFrames = PushArray<animation_frame>(&GameState->WorldArena, Animation->AnimationFrameCount);
+                Animation->AnimationFrames = PushArray<animation_frame>(&GameState->WorldArena, Animation->AnimationFrameCount, MEMORY_TAG_ANIMATIONS);
 
                 for (u32 AnimationFrameIndex = 0; AnimationFrameIndex < Tile->AnimationFrameCount; ++AnimationFrameIndex)
                 {
@@ -690,16 +1124,27 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         }
     }
 
-    vec2 ScreenCenterInWorldUnits = vec2(
-        GameState->ScreenWidthInWorldUnits / 2.f,
-        GameState->ScreenHeightInWorldUnits / 2.f
-    );
+    PrintHashTableStats(Platform, "animations", GetHashTableStats(&GameState->Animations));
+    for (u32 TilesetIndex = 0; TilesetIndex < GameState->Map.TilesetCount; ++TilesetIndex)
+    {
+        PrintHashTableStats(Platform, "tiles", GetHashTableStats(&GameState->Map.Tilesets[TilesetIndex].Source.Tiles));
+    }
+
+    vec2 ScreenCenterInWorldUnits = GetScreenCenterInWorldUnits(GameState);
 
-    mat4 *TileInstanceModels = PushArray<mat4>(&GameState->WorldArena, GameState->TotalTileCount);
-    vec2 *TileInstanceUVOffsets01 = PushArray<vec2>(&GameState->WorldArena, GameState->TotalTileCount);
+    // tile instance data is only needed until it's uploaded to the vertex buffer
+    instance_transform *TileInstanceTransforms = PushArray<instance_transform>(
+        &GameState->FrameArena, GameState->TotalTileCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
+    packed_uv *TileInstanceUVOffsets01 = PushArray<packed_uv>(&GameState->FrameArena, GameState->TotalTileCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
+    f32 *TileInstanceX = PushArray<f32>(&GameState->FrameArena, GameState->TotalTileCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
+    f32 *TileInstanceY = PushArray<f32>(&GameState->FrameArena, GameState->TotalTileCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
+    f32 *TileInstanceWidth = PushArray<f32>(&GameState->FrameArena, GameState->TotalTileCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
+    f32 *TileInstanceHeight = PushArray<f32>(&GameState->FrameArena, GameState->TotalTileCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
 
-    GameState->Boxes = PushArray<aabb>(&GameState->WorldArena, GameState->TotalBoxCount);
-    mat4 *BoxInstanceModels = PushArray<mat4>(&GameState->WorldArena, GameState->TotalBoxCount);
+    GameState->Boxes = PushArray<sim_aabb>(&GameState->WorldArena, GameState->TotalBoxCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    instance_transform *BoxInstanceTransforms = PushArray<instance_transform>(
+        &GameState->WorldArena, GameState->TotalBoxCount, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
+    GameState->BoxInstanceTransforms = BoxInstanceTransforms;
 
     u32 TileInstanceIndex = 0;
     u32 BoxIndex = 0;
@@ -720,49 +1165,28 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
                     {
                         u32 TileID = GID - TilesetFirstGID;
 
-                        // TileInstanceModel
-                        mat4* TileInstanceModel = TileInstanceModels + TileInstanceIndex;
-                        *TileInstanceModel = mat4(1.f);
-
                         i32 TileMapX = Chunk->X + (GIDIndex % Chunk->Width);
                         i32 TileMapY = Chunk->Y - (GIDIndex / Chunk->Height);
 
                         f32 TileXMeters = ScreenCenterInWorldUnits.x + TileMapX * Tileset->TileWidthInWorldUnits;
                         f32 TileYMeters = ScreenCenterInWorldUnits.y + TileMapY * Tileset->TileHeightInWorldUnits;
 
-                        *TileInstanceModel = translate(*TileInstanceModel, vec3(TileXMeters, TileYMeters, 0.f));
-                        *TileInstanceModel = scale(*TileInstanceModel,
-                            vec3(Tileset->TileWidthInWorldUnits, Tileset->TileHeightInWorldUnits, 0.f));
+                        // TileInstanceTransform
+                        TileInstanceX[TileInstanceIndex] = TileXMeters;
+                        TileInstanceY[TileInstanceIndex] = TileYMeters;
+                        TileInstanceWidth[TileInstanceIndex] = Tileset->TileWidthInWorldUnits;
+                        TileInstanceHeight[TileInstanceIndex] = Tileset->TileHeightInWorldUnits;
 
                         // TileInstanceUVOffset01
-                        vec2 * TileInstanceUVOffset01 = TileInstanceUVOffsets01 + TileInstanceIndex;
-                        *TileInstanceUVOffset01 = GetUVOffset01FromTileID(Tileset, TileID);
+                        TileInstanceUVOffsets01[TileInstanceIndex] = PackUV(GetUVOffset01FromTileID(Tileset, TileID));
 
                         tile_meta_info * TileInfo = GetTileMetaInfo(Tileset, TileID);
                         if (TileInfo)
                         {
-                            // Box
+                            // Box (in tile units, converted to world units below)
                             for (u32 CurrentBoxIndex = 0; CurrentBoxIndex < TileInfo->BoxCount; ++CurrentBoxIndex)
                             {
-                                aabb* Box = GameState->Boxes + BoxIndex;
-
-                                Box->Position.x = TileXMeters +
-                                    TileInfo->Boxes[CurrentBoxIndex].Position.x * Tileset->TilesetWidthPixelsToWorldUnits;
-                                Box->Position.y = TileYMeters +
-                                    ((Tileset->TileHeightInPixels -
-                                        TileInfo->Boxes[CurrentBoxIndex].Position.y -
-                                        TileInfo->Boxes[CurrentBoxIndex].Size.y) * Tileset->TilesetHeightPixelsToWorldUnits);
-
-                                Box->Size.x = TileInfo->Boxes[CurrentBoxIndex].Size.x * Tileset->TilesetWidthPixelsToWorldUnits;
-                                Box->Size.y = TileInfo->Boxes[CurrentBoxIndex].Size.y * Tileset->TilesetHeightPixelsToWorldUnits;
-
-                                mat4 * BoxInstanceModel = BoxInstanceModels + BoxIndex;
-                                *BoxInstanceModel = mat4(1.f);
-
-                                *BoxInstanceModel = translate(*BoxInstanceModel,
-                                    vec3(Box->Position.x, Box->Position.y, 0.f));
-                                *BoxInstanceModel = scale(*BoxInstanceModel,
-                                    vec3(Box->Size.x, Box->Size.y, 0.f));
+                                GameState->Boxes[BoxIndex] = GetTileUnitBox(Tileset, TileInfo->Boxes + CurrentBoxIndex, TileMapX, TileMapY);
 
                                 ++BoxIndex;
                             }
@@ -775,17 +1199,41 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         }
     }
 
+    GameState->TileBoxCount = BoxIndex;
+
+    sim_vec2 MapOrigin = SimVec2(ScreenCenterInWorldUnits);
+    for (u32 TileBoxIndex = 0; TileBoxIndex < GameState->TileBoxCount; ++TileBoxIndex)
+    {
+        sim_aabb *Box = GameState->Boxes + TileBoxIndex;
+        *Box = GetSimBoxFromTileUnits(Tileset, Box, MapOrigin);
+    }
+
+    // note: the tile boxes are only drawn, collision reads the tile grid's merged boxes
+    InitializeTileGrid(&GameState->TileGrid, &GameState->Map, Tileset, TilesetFirstGID, MapOrigin, &GameState->WorldArena, &GameState->FrameArena);
+
+    {
+        char Output[256];
+        FormatString(Output, sizeof(Output), "tile boxes: %u, merged: %u\n", GameState->TileGrid.BoxCount, GameState->TileGrid.MergedBoxCount);
+        Platform->PrintOutput(Output);
+    }
+
+    BuildInstanceTransforms(TileInstanceIndex, TileInstanceX, TileInstanceY, TileInstanceWidth, TileInstanceHeight, TileInstanceTransforms);
+
     // todo: i don't like the concept of entities and separate drawable entities
     // think about this
-    entity *Entities = PushArray<entity>(&GameState->WorldArena, GameState->TotalObjectCount);
+    entity *Entities = PushArray<entity>(&GameState->WorldArena, GameState->TotalObjectCount, MEMORY_TAG_ENTITIES, CACHE_LINE_SIZE);
 
-    GameState->EntityRenderInfoCount = GameState->TotalDrawableObjectCount;
-    GameState->EntityRenderInfos = PushArray<entity_render_info>(&GameState->WorldArena, GameState->EntityRenderInfoCount);
+    InitializeSlotMap(&GameState->EntityRenderInfos, GameState->TotalDrawableObjectCount, &GameState->WorldArena, MEMORY_TAG_INSTANCES);
+    InitializeSlotMap(&GameState->DrawableEntities, GameState->TotalDrawableObjectCount, &GameState->WorldArena, MEMORY_TAG_ENTITIES);
 
-    GameState->DrawableEntities = PushArray<entity>(&GameState->WorldArena, GameState->TotalDrawableObjectCount);
+    // todo: only the player and sirens move and animate, size these properly once there are more kinds
+    u32 MaxEntityCount = GameState->TotalDrawableObjectCount;
+    InitializeSparseSet(&GameState->Bodies, MaxEntityCount, MaxEntityCount, &GameState->WorldArena, MEMORY_TAG_ENTITIES);
+    InitializeSparseSet(&GameState->Colliders, MaxEntityCount, MaxEntityCount, &GameState->WorldArena, MEMORY_TAG_ENTITIES);
+    InitializeSparseSet(&GameState->Animators, MaxEntityCount, MaxEntityCount, &GameState->WorldArena, MEMORY_TAG_ENTITIES);
+    InitializeSparseSet(&GameState->Behaviors, MaxEntityCount, MaxEntityCount, &GameState->WorldArena, MEMORY_TAG_ENTITIES);
 
     u32 EntityInstanceIndex = 0;
-    u32 BoxModelOffset = QuadVerticesSize;
     for (u32 ObjectLayerIndex = 0; ObjectLayerIndex < GameState->Map.ObjectLayerCount; ++ObjectLayerIndex)
     {
         object_layer *ObjectLayer = GameState->Map.ObjectLayers + ObjectLayerIndex;
@@ -800,106 +1248,86 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
                 *Entity = {};
                 Entity->ID = Object->ID;
                 // tile objects have their position at bottom-left (https://github.com/bjorn/tiled/issues/91)
-                Entity->Position = vec2(
-                    Object->X * Tileset->TilesetWidthPixelsToWorldUnits,
-                    (Object->Y + Object->Height) * Tileset->TilesetWidthPixelsToWorldUnits
+                Entity->Position = SimVec2(
+                    SimScalar(Object->X) * SimScalar(Tileset->TilesetWidthPixelsToWorldUnits),
+                    SimScalar(Object->Y + Object->Height) * SimScalar(Tileset->TilesetWidthPixelsToWorldUnits)
                 );
-                Entity->Size = vec2(
-                    Object->Width * Tileset->TilesetHeightPixelsToWorldUnits,
-                    Object->Height * Tileset->TilesetHeightPixelsToWorldUnits
+                Entity->Size = SimVec2(
+                    SimScalar(Object->Width) * SimScalar(Tileset->TilesetHeightPixelsToWorldUnits),
+                    SimScalar(Object->Height) * SimScalar(Tileset->TilesetHeightPixelsToWorldUnits)
                 );
 
                 Entity->Type = Object->Type;
 
-                entity_render_info * EntityRenderInfo = GameState->EntityRenderInfos + EntityInstanceIndex;
-                // todo: very fragile (deal with QuadVerticesSize part)!
-                EntityRenderInfo->Offset = EntityInstanceIndex * sizeof(entity_render_info) + QuadVerticesSize;
-
-                BoxModelOffset += BoxIndex * sizeof(mat4);
-                EntityRenderInfo->BoxModelOffset = BoxModelOffset;
-
                 if (Object->GID)
                 {
                     u32 TileID = Object->GID - TilesetFirstGID;
 
-                    // EntityInstanceModel
-                    EntityRenderInfo->InstanceModel = mat4(1.f);
+                    Entity->RenderInfo = Insert(&GameState->EntityRenderInfos, entity_render_info{});
 
-                    f32 EntityWorldXInWorldUnits = ScreenCenterInWorldUnits.x + Entity->Position.x;
-                    f32 EntityWorldYInWorldUnits = ScreenCenterInWorldUnits.y + Entity->Position.y;
+                    entity_render_info *EntityRenderInfo = Get(&GameState->EntityRenderInfos, Entity->RenderInfo);
+                    // note: the entity's boxes are pushed right after the ones already there
+                    EntityRenderInfo->BoxInstanceOffset = QuadVerticesSize + BoxIndex * sizeof(instance_transform);
 
-                    EntityRenderInfo->InstanceModel = translate(EntityRenderInfo->InstanceModel,
-                        vec3(EntityWorldXInWorldUnits, EntityWorldYInWorldUnits, 0.f));
-                    EntityRenderInfo->InstanceModel = scale(EntityRenderInfo->InstanceModel,
-                        vec3(Entity->Size.x, Entity->Size.y, 0.f));
+                    // note: EntityInstanceTransform is built for all entities at once after the loop
+                    sim_vec2 EntityOrigin = SimVec2(ScreenCenterInWorldUnits) + Entity->Position;
 
                     // EntityInstanceUVOffset01
-                    EntityRenderInfo->InstanceUVOffset01 = GetUVOffset01FromTileID(Tileset, TileID);
+                    EntityRenderInfo->InstanceUVOffset01 = PackUV(GetUVOffset01FromTileID(Tileset, TileID));
+
+                    // DrawableEntity
+                    // todo: hmm...
+                    slot_handle DrawableEntityHandle = Insert(&GameState->DrawableEntities, *Entity);
+                    entity* DrawableEntity = Get(&GameState->DrawableEntities, DrawableEntityHandle);
 
                     tile_meta_info * EntityTileInfo = GetTileMetaInfo(Tileset, TileID);
 
                     if (EntityTileInfo)
                     {
-                        Entity->BoxCount = EntityTileInfo->BoxCount;
-                        Entity->Boxes = PushArray<aabb_info>(&GameState->WorldArena, Entity->BoxCount);
+                        collider_component *Collider = Add(&GameState->Colliders, DrawableEntityHandle);
+                        Collider->BoxCount = EntityTileInfo->BoxCount;
+                        Collider->Boxes = PushArray<aabb_info>(&GameState->WorldArena, Collider->BoxCount, MEMORY_TAG_ENTITIES);
 
                         // Box
                         for (u32 CurrentBoxIndex = 0; CurrentBoxIndex < EntityTileInfo->BoxCount; ++CurrentBoxIndex)
                         {
-                            aabb* Box = GameState->Boxes + BoxIndex;
-
-                            Box->Position.x = EntityWorldXInWorldUnits +
-                                EntityTileInfo->Boxes[CurrentBoxIndex].Position.x * Tileset->TilesetWidthPixelsToWorldUnits;
-                            Box->Position.y = EntityWorldYInWorldUnits +
-                                ((Tileset->TileHeightInPixels -
-                                    EntityTileInfo->Boxes[CurrentBoxIndex].Position.y -
-                                    EntityTileInfo->Boxes[CurrentBoxIndex].Size.y) * Tileset->TilesetHeightPixelsToWorldUnits);
+                            sim_aabb *Box = GameState->Boxes + BoxIndex;
+                            *Box = GetSimBox(Tileset, EntityTileInfo->Boxes + CurrentBoxIndex, EntityOrigin);
 
-                            Box->Size.x = EntityTileInfo->Boxes[CurrentBoxIndex].Size.x * Tileset->TilesetWidthPixelsToWorldUnits;
-                            Box->Size.y = EntityTileInfo->Boxes[CurrentBoxIndex].Size.y * Tileset->TilesetHeightPixelsToWorldUnits;
-
-                            mat4 * BoxInstanceModel = BoxInstanceModels + BoxIndex;
-                            *BoxInstanceModel = mat4(1.f);
-
-                            *BoxInstanceModel = translate(*BoxInstanceModel,
-                                vec3(Box->Position.x, Box->Position.y, 0.f));
-                            *BoxInstanceModel = scale(*BoxInstanceModel,
-                                vec3(Box->Size.x, Box->Size.y, 0.f));
-
-                            Entity->Boxes[CurrentBoxIndex].Box = Box;
-                            Entity->Boxes[CurrentBoxIndex].Model = BoxInstanceModel;
+                            Collider->Boxes[CurrentBoxIndex].Box = Box;
+                            Collider->Boxes[CurrentBoxIndex].Instance = BoxInstanceTransforms + BoxIndex;
 
                             ++BoxIndex;
                         }
                     }
 
-                    Entity->RenderInfo = EntityRenderInfo;
-
-                    // DrawableEntity
-                    entity* DrawableEntity = GameState->DrawableEntities + EntityInstanceIndex;
-                    // todo: hmm...
-                    *DrawableEntity = *Entity;
-
                     // todo:
                     if (DrawableEntity->Type == ENTITY_PLAYER)
                     {
-                        GameState->Player = DrawableEntity;
-                        GameState->Player->StatesStack.MaxCount = 10;
-                        GameState->Player->StatesStack.Values = 
-                            PushArray<entity_state>(&GameState->WorldArena, GameState->Player->StatesStack.MaxCount);
+                        GameState->Player = DrawableEntityHandle;
+
+                        Add(&GameState->Bodies, DrawableEntityHandle);
 
-                        Push(&GameState->Player->StatesStack, ENTITY_STATE_IDLE);
-                        ChangeAnimation(GameState, GameState->Player, "PLAYER_IDLE");
+                        behavior_component *Behavior = Add(&GameState->Behaviors, DrawableEntityHandle);
+                        Behavior->StatesStack.MaxCount = 10;
+                        Behavior->StatesStack.Values = 
+                            PushArray<entity_state>(&GameState->WorldArena, Behavior->StatesStack.MaxCount, MEMORY_TAG_ENTITIES);
+
+                        Push(&Behavior->StatesStack, ENTITY_STATE_IDLE);
+                        ChangeAnimation(GameState, Add(&GameState->Animators, DrawableEntityHandle), SID("PLAYER_IDLE"));
                     }
 
                     if (DrawableEntity->Type == ENTITY_SIREN)
                     {
-                        DrawableEntity->StatesStack.MaxCount = 10;
-                        DrawableEntity->StatesStack.Values = 
-                            PushArray<entity_state>(&GameState->WorldArena, DrawableEntity->StatesStack.MaxCount);
+                        Add(&GameState->Bodies, DrawableEntityHandle);
+
+                        behavior_component *Behavior = Add(&GameState->Behaviors, DrawableEntityHandle);
+                        Behavior->StatesStack.MaxCount = 10;
+                        Behavior->StatesStack.Values = 
+                            PushArray<entity_state>(&GameState->WorldArena, Behavior->StatesStack.MaxCount, MEMORY_TAG_ENTITIES);
 
-                        Push(&DrawableEntity->StatesStack, ENTITY_STATE_IDLE);
-                        ChangeAnimation(GameState, DrawableEntity, "SIREN");
+                        Push(&Behavior->StatesStack, ENTITY_STATE_IDLE);
+                        ChangeAnimation(GameState, Add(&GameState->Animators, DrawableEntityHandle), SID("SIREN"));
                     }
 
                     ++EntityInstanceIndex;
@@ -908,6 +1336,43 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         }
     }
 
+    Assert(BoxIndex == GameState->TotalBoxCount);
+
+    BuildBoxInstanceTransforms(GameState, GameState->Boxes, BoxIndex, BoxInstanceTransforms);
+
+    // note: the boxes of colliders without a body never move, they are copied out for the grid
+    u32 StaticEntityBoxCount = 0;
+    for (u32 ColliderIndex = 0; ColliderIndex < GameState->Colliders.Count; ++ColliderIndex)
+    {
+        if (!Has(&GameState->Bodies, GameState->Colliders.Entities[ColliderIndex]))
+        {
+            StaticEntityBoxCount += GameState->Colliders.Values[ColliderIndex].BoxCount;
+        }
+    }
+
+    sim_aabb *StaticEntityBoxes = PushArray<sim_aabb>(&GameState->WorldArena, StaticEntityBoxCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    u32 StaticEntityBoxIndex = 0;
+    for (u32 ColliderIndex = 0; ColliderIndex < GameState->Colliders.Count; ++ColliderIndex)
+    {
+        collider_component *Collider = GameState->Colliders.Values + ColliderIndex;
+
+        if (!Has(&GameState->Bodies, GameState->Colliders.Entities[ColliderIndex]))
+        {
+            for (u32 ColliderBoxIndex = 0; ColliderBoxIndex < Collider->BoxCount; ++ColliderBoxIndex)
+            {
+                StaticEntityBoxes[StaticEntityBoxIndex++] = *Collider->Boxes[ColliderBoxIndex].Box;
+            }
+        }
+    }
+
+    // note: cells of 4x4 tiles, a fixed step moves a body well under one cell
+    InitializeBoxGrid(&GameState->BoxGrid, StaticEntityBoxes, StaticEntityBoxCount, SimScalar(4.f * Tileset->TileWidthInWorldUnits),
+        &GameState->WorldArena);
+    GameState->Physics = PushStruct<physics_system>(&GameState->TransientArena, MEMORY_TAG_COLLISION);
+    InitializePhysicsSystem(GameState->Physics, MaxEntityCount, &GameState->TileGrid, &GameState->BoxGrid, &GameState->TransientArena);
+    BuildEntityInstanceTransforms(GameState, 1.f);
+
     /*
     Chunk-based rendering.
 
@@ -921,13 +1386,13 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
 #pragma region Tiles
     GameState->TilesVertexBuffer = {};
-    GameState->TilesVertexBuffer.Size = QuadVerticesSize + GameState->TotalTileCount * (sizeof(mat4) + sizeof(vec2));
+    GameState->TilesVertexBuffer.Size = QuadVerticesSize + GameState->TotalTileCount * (sizeof(instance_transform) + sizeof(packed_uv));
     GameState->TilesVertexBuffer.Usage = GL_STATIC_DRAW;
 
-    GameState->TilesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena);
+    GameState->TilesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->TilesVertexBuffer.DataLayout->SubBufferCount = 3;
     GameState->TilesVertexBuffer.DataLayout->SubBuffers = PushArray<vertex_sub_buffer>(
-        &GameState->WorldArena, GameState->TilesVertexBuffer.DataLayout->SubBufferCount);
+        &GameState->WorldArena, GameState->TilesVertexBuffer.DataLayout->SubBufferCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_sub_buffer *SubBuffer = GameState->TilesVertexBuffer.DataLayout->SubBuffers + 0;
@@ -939,21 +1404,21 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     {
         vertex_sub_buffer *SubBuffer = GameState->TilesVertexBuffer.DataLayout->SubBuffers + 1;
         SubBuffer->Offset = QuadVerticesSize;
-        SubBuffer->Size = GameState->TotalTileCount * sizeof(mat4);
-        SubBuffer->Data = TileInstanceModels;
+        SubBuffer->Size = GameState->TotalTileCount * sizeof(instance_transform);
+        SubBuffer->Data = TileInstanceTransforms;
     }
 
     {
         vertex_sub_buffer *SubBuffer = GameState->TilesVertexBuffer.DataLayout->SubBuffers + 2;
-        SubBuffer->Offset = QuadVerticesSize + GameState->TotalTileCount * sizeof(mat4);
-        SubBuffer->Size = GameState->TotalTileCount * sizeof(vec2);
+        SubBuffer->Offset = QuadVerticesSize + GameState->TotalTileCount * sizeof(instance_transform);
+        SubBuffer->Size = GameState->TotalTileCount * sizeof(packed_uv);
         SubBuffer->Data = TileInstanceUVOffsets01;
     }
 
-    GameState->TilesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena);
-    GameState->TilesVertexBuffer.AttributesLayout->AttributeCount = 6;
+    GameState->TilesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
+    GameState->TilesVertexBuffer.AttributesLayout->AttributeCount = 3;
     GameState->TilesVertexBuffer.AttributesLayout->Attributes = PushArray<vertex_buffer_attribute>(
-        &GameState->WorldArena, GameState->TilesVertexBuffer.AttributesLayout->AttributeCount);
+        &GameState->WorldArena, GameState->TilesVertexBuffer.AttributesLayout->AttributeCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 0;
@@ -961,64 +1426,31 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         Attribute->Size = 4;
         Attribute->Type = GL_FLOAT;
         Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(vec4);
-        Attribute->Divisor = 0;
-        Attribute->OffsetPointer = (void *)0;
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 1;
-        Attribute->Index = 1;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize);
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 2;
-        Attribute->Index = 2;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 3;
-        Attribute->Index = 3;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + 2 * sizeof(vec4));
+        Attribute->Stride = sizeof(vec4);
+        Attribute->Divisor = 0;
+        Attribute->OffsetPointer = (void *)0;
     }
 
     {
-        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 4;
-        Attribute->Index = 4;
+        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 1;
+        Attribute->Index = 1;
         Attribute->Size = 4;
         Attribute->Type = GL_FLOAT;
         Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
+        Attribute->Stride = sizeof(instance_transform);
         Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + 3 * sizeof(vec4));
+        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize);
     }
 
     {
-        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 5;
-        Attribute->Index = 5;
+        vertex_buffer_attribute *Attribute = GameState->TilesVertexBuffer.AttributesLayout->Attributes + 2;
+        Attribute->Index = 2;
         Attribute->Size = 2;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(vec2);
+        Attribute->Type = GL_UNSIGNED_SHORT;
+        Attribute->Normalized = GL_TRUE;
+        Attribute->Stride = sizeof(packed_uv);
         Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + GameState->TotalTileCount * sizeof(mat4));
+        Attribute->OffsetPointer = (void *)(QuadVerticesSize + GameState->TotalTileCount * sizeof(instance_transform));
     }
 
     SetupVertexBuffer(Renderer, &GameState->TilesVertexBuffer);
@@ -1026,13 +1458,13 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
 #pragma region Tile Boxes
     GameState->BoxesVertexBuffer = {};
-    GameState->BoxesVertexBuffer.Size = QuadVerticesSize + GameState->TotalBoxCount * sizeof(mat4);
+    GameState->BoxesVertexBuffer.Size = QuadVerticesSize + GameState->TotalBoxCount * sizeof(instance_transform);
     GameState->BoxesVertexBuffer.Usage = GL_STREAM_DRAW;
 
-    GameState->BoxesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena);
+    GameState->BoxesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->BoxesVertexBuffer.DataLayout->SubBufferCount = 2;
     GameState->BoxesVertexBuffer.DataLayout->SubBuffers = PushArray<vertex_sub_buffer>(
-        &GameState->WorldArena, GameState->BoxesVertexBuffer.DataLayout->SubBufferCount);
+        &GameState->WorldArena, GameState->BoxesVertexBuffer.DataLayout->SubBufferCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_sub_buffer *SubBuffer = GameState->BoxesVertexBuffer.DataLayout->SubBuffers + 0;
@@ -1044,14 +1476,14 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     {
         vertex_sub_buffer *SubBuffer = GameState->BoxesVertexBuffer.DataLayout->SubBuffers + 1;
         SubBuffer->Offset = QuadVerticesSize;
-        SubBuffer->Size = GameState->TotalBoxCount * sizeof(mat4);
-        SubBuffer->Data = BoxInstanceModels;
+        SubBuffer->Size = GameState->TotalBoxCount * sizeof(instance_transform);
+        SubBuffer->Data = BoxInstanceTransforms;
     }
 
-    GameState->BoxesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena);
-    GameState->BoxesVertexBuffer.AttributesLayout->AttributeCount = 5;
+    GameState->BoxesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
+    GameState->BoxesVertexBuffer.AttributesLayout->AttributeCount = 2;
     GameState->BoxesVertexBuffer.AttributesLayout->Attributes = PushArray<vertex_buffer_attribute>(
-        &GameState->WorldArena, GameState->BoxesVertexBuffer.AttributesLayout->AttributeCount);
+        &GameState->WorldArena, GameState->BoxesVertexBuffer.AttributesLayout->AttributeCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_buffer_attribute *Attribute = GameState->BoxesVertexBuffer.AttributesLayout->Attributes + 0;
@@ -1070,56 +1502,23 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         Attribute->Size = 4;
         Attribute->Type = GL_FLOAT;
         Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
+        Attribute->Stride = sizeof(instance_transform);
         Attribute->Divisor = 1;
         Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize);
     }
 
-    {
-        vertex_buffer_attribute *Attribute = GameState->BoxesVertexBuffer.AttributesLayout->Attributes + 2;
-        Attribute->Index = 2;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->BoxesVertexBuffer.AttributesLayout->Attributes + 3;
-        Attribute->Index = 3;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + 2 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->BoxesVertexBuffer.AttributesLayout->Attributes + 4;
-        Attribute->Index = 4;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(mat4);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + 3 * sizeof(vec4));
-    }
-
     SetupVertexBuffer(Renderer, &GameState->BoxesVertexBuffer);
 #pragma endregion
 
 #pragma region Drawable Entities
     GameState->DrawableEntitiesVertexBuffer = {};
-    GameState->DrawableEntitiesVertexBuffer.Size = QuadVerticesSize + GameState->EntityRenderInfoCount * sizeof(entity_render_info);
+    GameState->DrawableEntitiesVertexBuffer.Size = QuadVerticesSize + GameState->EntityRenderInfos.MaxCount * sizeof(entity_render_info);
     GameState->DrawableEntitiesVertexBuffer.Usage = GL_STREAM_DRAW;
 
-    GameState->DrawableEntitiesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena);
+    GameState->DrawableEntitiesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->DrawableEntitiesVertexBuffer.DataLayout->SubBufferCount = 2;
     GameState->DrawableEntitiesVertexBuffer.DataLayout->SubBuffers = PushArray<vertex_sub_buffer>(
-        &GameState->WorldArena, GameState->DrawableEntitiesVertexBuffer.DataLayout->SubBufferCount);
+        &GameState->WorldArena, GameState->DrawableEntitiesVertexBuffer.DataLayout->SubBufferCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_sub_buffer *SubBuffer = GameState->DrawableEntitiesVertexBuffer.DataLayout->SubBuffers + 0;
@@ -1131,14 +1530,14 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     {
         vertex_sub_buffer *SubBuffer = GameState->DrawableEntitiesVertexBuffer.DataLayout->SubBuffers + 1;
         SubBuffer->Offset = QuadVerticesSize;
-        SubBuffer->Size = GameState->EntityRenderInfoCount * sizeof(entity_render_info);
-        SubBuffer->Data = GameState->EntityRenderInfos;
+        SubBuffer->Size = GameState->EntityRenderInfos.Count * sizeof(entity_render_info);
+        SubBuffer->Data = GameState->EntityRenderInfos.Values;
     }
 
-    GameState->DrawableEntitiesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena);
-    GameState->DrawableEntitiesVertexBuffer.AttributesLayout->AttributeCount = 7;
+    GameState->DrawableEntitiesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
+    GameState->DrawableEntitiesVertexBuffer.AttributesLayout->AttributeCount = 4;
     GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes = PushArray<vertex_buffer_attribute>(
-        &GameState->WorldArena, GameState->DrawableEntitiesVertexBuffer.AttributesLayout->AttributeCount);
+        &GameState->WorldArena, GameState->DrawableEntitiesVertexBuffer.AttributesLayout->AttributeCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 0;
@@ -1160,59 +1559,26 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         Attribute->Stride = sizeof(entity_render_info);
         Attribute->Divisor = 1;
         // todo: really need to deal with this offset thing, man
-        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(entity_render_info, InstanceModel));
+        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(entity_render_info, Transform));
     }
 
     {
         vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 2;
         Attribute->Index = 2;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(entity_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(entity_render_info, InstanceModel) + sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 3;
-        Attribute->Index = 3;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(entity_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(entity_render_info, InstanceModel) + 2 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 4;
-        Attribute->Index = 4;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(entity_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(entity_render_info, InstanceModel) + 3 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 5;
-        Attribute->Index = 5;
         Attribute->Size = 2;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
+        Attribute->Type = GL_UNSIGNED_SHORT;
+        Attribute->Normalized = GL_TRUE;
         Attribute->Stride = sizeof(entity_render_info);
         Attribute->Divisor = 1;
         Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(entity_render_info, InstanceUVOffset01));
     }
 
     {
-        vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 6;
-        Attribute->Index = 6;
+        vertex_buffer_attribute *Attribute = GameState->DrawableEntitiesVertexBuffer.AttributesLayout->Attributes + 3;
+        Attribute->Index = 3;
         Attribute->Size = 1;
         Attribute->Type = GL_UNSIGNED_INT;
-        Attribute->Stride = sizeof(u32);
+        Attribute->Stride = sizeof(entity_render_info);
         Attribute->Divisor = 1;
         Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(entity_render_info, Flipped));
     }
@@ -1221,16 +1587,16 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 #pragma endregion
 
 #pragma region Particles
-    GameState->ParticleRenderInfos = PushArray<particle_render_info>(&GameState->WorldArena, ArrayCount(GameState->Particles));
+    GameState->ParticleRenderInfos = PushArray<particle_render_info>(&GameState->WorldArena, ArrayCount(GameState->Particles), MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
 
     GameState->ParticlesVertexBuffer = {};
     GameState->ParticlesVertexBuffer.Size = QuadVerticesSize + ArrayCount(GameState->Particles) * sizeof(particle_render_info);
     GameState->ParticlesVertexBuffer.Usage = GL_STREAM_DRAW;
 
-    GameState->ParticlesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena);
+    GameState->ParticlesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->ParticlesVertexBuffer.DataLayout->SubBufferCount = 2;
     GameState->ParticlesVertexBuffer.DataLayout->SubBuffers = PushArray<vertex_sub_buffer>(
-        &GameState->WorldArena, GameState->ParticlesVertexBuffer.DataLayout->SubBufferCount);
+        &GameState->WorldArena, GameState->ParticlesVertexBuffer.DataLayout->SubBufferCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_sub_buffer *SubBuffer = GameState->ParticlesVertexBuffer.DataLayout->SubBuffers + 0;
@@ -1246,10 +1612,10 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         SubBuffer->Data = GameState->ParticleRenderInfos;
     }
 
-    GameState->ParticlesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena);
-    GameState->ParticlesVertexBuffer.AttributesLayout->AttributeCount = 6;
+    GameState->ParticlesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
+    GameState->ParticlesVertexBuffer.AttributesLayout->AttributeCount = 3;
     GameState->ParticlesVertexBuffer.AttributesLayout->Attributes = PushArray<vertex_buffer_attribute>(
-        &GameState->WorldArena, GameState->ParticlesVertexBuffer.AttributesLayout->AttributeCount);
+        &GameState->WorldArena, GameState->ParticlesVertexBuffer.AttributesLayout->AttributeCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_buffer_attribute *Attribute = GameState->ParticlesVertexBuffer.AttributesLayout->Attributes + 0;
@@ -1271,48 +1637,15 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         Attribute->Stride = sizeof(particle_render_info);
         Attribute->Divisor = 1;
         // todo: really need to deal with this offset thing, man
-        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(particle_render_info, Model));
+        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(particle_render_info, Transform));
     }
 
     {
         vertex_buffer_attribute *Attribute = GameState->ParticlesVertexBuffer.AttributesLayout->Attributes + 2;
         Attribute->Index = 2;
         Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(particle_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(particle_render_info, Model) + sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->ParticlesVertexBuffer.AttributesLayout->Attributes + 3;
-        Attribute->Index = 3;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(particle_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(particle_render_info, Model) + 2 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->ParticlesVertexBuffer.AttributesLayout->Attributes + 4;
-        Attribute->Index = 4;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(particle_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(particle_render_info, Model) + 3 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->ParticlesVertexBuffer.AttributesLayout->Attributes + 5;
-        Attribute->Index = 5;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
+        Attribute->Type = GL_UNSIGNED_BYTE;
+        Attribute->Normalized = GL_TRUE;
         Attribute->Stride = sizeof(particle_render_info);
         Attribute->Divisor = 1;
         Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(particle_render_info, Color));
@@ -1322,17 +1655,19 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 #pragma endregion
 
 #pragma region More Particles
+    InitializeMemoryPool(&GameState->PlayerDiveParticles, &GameState->WorldArena, 64, true, MEMORY_TAG_ENTITIES);
+
     GameState->PlayerDiveParticleRenderInfos = PushArray<particle_render_info>
-        (&GameState->WorldArena, ArrayCount(GameState->PlayerDiveParticles));
+        (&GameState->WorldArena, MAX_PLAYER_DIVE_PARTICLE_COUNT, MEMORY_TAG_INSTANCES, CACHE_LINE_SIZE);
 
     GameState->PlayerDiveParticlesVertexBuffer = {};
-    GameState->PlayerDiveParticlesVertexBuffer.Size = QuadVerticesSize + ArrayCount(GameState->PlayerDiveParticles) * sizeof(particle_render_info);
+    GameState->PlayerDiveParticlesVertexBuffer.Size = QuadVerticesSize + MAX_PLAYER_DIVE_PARTICLE_COUNT * sizeof(particle_render_info);
     GameState->PlayerDiveParticlesVertexBuffer.Usage = GL_STREAM_DRAW;
 
-    GameState->PlayerDiveParticlesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena);
+    GameState->PlayerDiveParticlesVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->PlayerDiveParticlesVertexBuffer.DataLayout->SubBufferCount = 2;
     GameState->PlayerDiveParticlesVertexBuffer.DataLayout->SubBuffers = PushArray<vertex_sub_buffer>(
-        &GameState->WorldArena, GameState->PlayerDiveParticlesVertexBuffer.DataLayout->SubBufferCount);
+        &GameState->WorldArena, GameState->PlayerDiveParticlesVertexBuffer.DataLayout->SubBufferCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_sub_buffer *SubBuffer = GameState->PlayerDiveParticlesVertexBuffer.DataLayout->SubBuffers + 0;
@@ -1344,14 +1679,14 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     {
         vertex_sub_buffer *SubBuffer = GameState->PlayerDiveParticlesVertexBuffer.DataLayout->SubBuffers + 1;
         SubBuffer->Offset = QuadVerticesSize;
-        SubBuffer->Size = ArrayCount(GameState->PlayerDiveParticles) * sizeof(particle_render_info);
+        SubBuffer->Size = MAX_PLAYER_DIVE_PARTICLE_COUNT * sizeof(particle_render_info);
         SubBuffer->Data = GameState->PlayerDiveParticleRenderInfos;
     }
 
-    GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena);
-    GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->AttributeCount = 6;
+    GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
+    GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->AttributeCount = 3;
     GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->Attributes = PushArray<vertex_buffer_attribute>(
-        &GameState->WorldArena, GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->AttributeCount);
+        &GameState->WorldArena, GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->AttributeCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_buffer_attribute *Attribute = GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->Attributes + 0;
@@ -1373,48 +1708,15 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         Attribute->Stride = sizeof(particle_render_info);
         Attribute->Divisor = 1;
         // todo: really need to deal with this offset thing, man
-        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(particle_render_info, Model));
+        Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(particle_render_info, Transform));
     }
 
     {
         vertex_buffer_attribute *Attribute = GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->Attributes + 2;
         Attribute->Index = 2;
         Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(particle_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(particle_render_info, Model) + sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->Attributes + 3;
-        Attribute->Index = 3;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(particle_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(particle_render_info, Model) + 2 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->Attributes + 4;
-        Attribute->Index = 4;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
-        Attribute->Stride = sizeof(particle_render_info);
-        Attribute->Divisor = 1;
-        Attribute->OffsetPointer = (void *)(QuadVerticesSize + StructOffset(particle_render_info, Model) + 3 * sizeof(vec4));
-    }
-
-    {
-        vertex_buffer_attribute *Attribute = GameState->PlayerDiveParticlesVertexBuffer.AttributesLayout->Attributes + 5;
-        Attribute->Index = 5;
-        Attribute->Size = 4;
-        Attribute->Type = GL_FLOAT;
-        Attribute->Normalized = GL_FALSE;
+        Attribute->Type = GL_UNSIGNED_BYTE;
+        Attribute->Normalized = GL_TRUE;
         Attribute->Stride = sizeof(particle_render_info);
         Attribute->Divisor = 1;
         Attribute->OffsetPointer = (void *)((u64)QuadVerticesSize + StructOffset(particle_render_info, Color));
@@ -1429,10 +1731,10 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     GameState->QuadVertexBuffer.Size = QuadVerticesSize;
     GameState->QuadVertexBuffer.Usage = GL_STATIC_DRAW;
 
-    GameState->QuadVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena);
+    GameState->QuadVertexBuffer.DataLayout = PushStruct<vertex_buffer_data_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->QuadVertexBuffer.DataLayout->SubBufferCount = 1;
     GameState->QuadVertexBuffer.DataLayout->SubBuffers = PushArray<vertex_sub_buffer>(
-        &GameState->WorldArena, GameState->QuadVertexBuffer.DataLayout->SubBufferCount);
+        &GameState->WorldArena, GameState->QuadVertexBuffer.DataLayout->SubBufferCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_sub_buffer *SubBuffer = GameState->QuadVertexBuffer.DataLayout->SubBuffers + 0;
@@ -1441,10 +1743,10 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         SubBuffer->Data = QuadVertices;
     }
 
-    GameState->QuadVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena);
+    GameState->QuadVertexBuffer.AttributesLayout = PushStruct<vertex_buffer_attributes_layout>(&GameState->WorldArena, MEMORY_TAG_RENDERER);
     GameState->QuadVertexBuffer.AttributesLayout->AttributeCount = 1;
     GameState->QuadVertexBuffer.AttributesLayout->Attributes = PushArray<vertex_buffer_attribute>(
-        &GameState->WorldArena, GameState->QuadVertexBuffer.AttributesLayout->AttributeCount);
+        &GameState->WorldArena, GameState->QuadVertexBuffer.AttributesLayout->AttributeCount, MEMORY_TAG_RENDERER);
 
     {
         vertex_buffer_attribute *Attribute = GameState->QuadVertexBuffer.AttributesLayout->Attributes + 0;
@@ -1465,9 +1767,10 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
     GameState->Time = 0.f;
 
     GameState->Zoom = 1.f / 1.f;
-    GameState->Camera = GameState->Player->Position;
+    GameState->Camera = Get(&GameState->DrawableEntities, GameState->Player)->Position;
 
-    GameState->Entropy = RandomSequence(42);
+    GameState->Entropy = RandomLanes(42);
+    GameState->SimStateHash = SIM_STATE_HASH_SEED;
 
     // init particles
     for (u32 ParticleIndex = 0; ParticleIndex < ArrayCount(GameState->Particles); ++ParticleIndex)
@@ -1475,20 +1778,7 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
         particle *Particle = GameState->Particles + ParticleIndex;
 
         Particle->RenderInfo = GameState->ParticleRenderInfos + ParticleIndex;
-        Particle->RenderInfo->Offset = ParticleIndex * sizeof(particle_render_info) + QuadVerticesSize;
-        Particle->RenderInfo->Model = mat4(1.f);
-        Particle->RenderInfo->Color = vec4(0.f);
-    }
-
-    // more particles
-    for (u32 ParticleIndex = 0; ParticleIndex < ArrayCount(GameState->PlayerDiveParticles); ++ParticleIndex)
-    {
-        particle *Particle = GameState->PlayerDiveParticles + ParticleIndex;
-
-        Particle->RenderInfo = GameState->PlayerDiveParticleRenderInfos + ParticleIndex;
-        Particle->RenderInfo->Offset = ParticleIndex * sizeof(particle_render_info) + QuadVerticesSize;
-        Particle->RenderInfo->Model = mat4(1.f);
-        Particle->RenderInfo->Color = vec4(0.f);
+        *Particle->RenderInfo = {};
     }
 
     Renderer->glEnable(GL_BLEND);
@@ -1499,12 +1789,31 @@ GameInit(game_state *GameState, game_memory *Memory, game_params *Params)
 
     //Renderer->glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    GameState->Snapshots = PushStruct<snapshot_ring>(&GameState->TransientArena, MEMORY_TAG_SNAPSHOTS);
+    InitializeSnapshotRing(
+        GameState->Snapshots,
+        Memory->PermanentStorage,
+        Megabytes(256),
+        600,    // 60 seconds
+        6,      // 10 times per second
+        30,
+        &GameState->TransientArena
+    );
+
     GameState->IsInitialized = true;
 }
 
+// note: game_state followed by everything allocated from the world arena
+inline memory_index
+GetPermanentStateSize(game_state *GameState, game_memory *Memory)
+{
+    memory_index Result = (u8 *)GameState->WorldArena.Base + GameState->WorldArena.Used - (u8 *)Memory->PermanentStorage;
+    return Result;
+}
+
 extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
 {
-    Assert(sizeof(game_state) <= Memory->PermanentStorageSize);
+    Assert(sizeof(game_state) <= Memory->PermanentStorageCommittedSize);
 
     game_state *GameState = (game_state*)Memory->PermanentStorage;
 
@@ -1519,6 +1828,28 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
         GameInit(GameState, Memory, Params);
     }
 
+    snapshot_ring *Snapshots = GameState->Snapshots;
+
+    // note: has to happen before anything of this frame is allocated, restore rewinds the frame arena as well
+    if (Params->Input.Rewind.isPressed && !Params->Input.Rewind.isProcessed)
+    {
+        Params->Input.Rewind.isProcessed = true;
+
+        // one second back
+        RestoreSnapshot(Snapshots, 60 / Snapshots->TicksPerSnapshot, Platform);
+    }
+
+    ClearMemoryArena(&GameState->FrameArena);
+    BeginRingArenaFrame(GameState->StagingArena);
+    BeginEventBusFrame(&GameState->Events, &GameState->FrameArena);
+
+    // note: taken between frames, when the event bus is empty and nothing points into the frame arena
+    Snapshots->Stats.FrameCaptureMs = 0.f;
+    if (Snapshots->TicksSinceSnapshot >= Snapshots->TicksPerSnapshot)
+    {
+        CaptureSnapshot(Snapshots, GetPermanentStateSize(GameState, Memory), Platform);
+    }
+
     Renderer->glViewport(0, 0, ScreenWidth, ScreenHeight);
 
     GameState->Time += Params->msPerFrame;
@@ -1526,143 +1857,98 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
 
     GameState->BackgroundColor = NormalizeRGB(29, 33, 45);
 
+    // note: resolved after a possible restore, the player may sit in another slot in the snapshot
+    entity *Player = Get(&GameState->DrawableEntities, GameState->Player);
+    body_component *PlayerBody = Get(&GameState->Bodies, GameState->Player);
+    animator_component *PlayerAnimator = Get(&GameState->Animators, GameState->Player);
+    behavior_component *PlayerBehavior = Get(&GameState->Behaviors, GameState->Player);
+
     ProcessInput(GameState, &Params->Input, Params->msPerFrame);
 
-    while (GameState->Lag >= GameState->UpdateRate)
+    if (Params->Input.DumpMemoryStats.isPressed && !Params->Input.DumpMemoryStats.isProcessed)
     {
-        f32 dt = 0.1f;
-
-        // friction imitation
-        GameState->Player->Acceleration.x += -4.f * GameState->Player->Velocity.x;
-        GameState->Player->Acceleration.y += -0.001f * GameState->Player->Velocity.y;
+        Params->Input.DumpMemoryStats.isProcessed = true;
 
-        GameState->Player->Velocity += GameState->Player->Acceleration * dt;
+        DumpMemoryStats(GameState, Platform);
+    }
 
-        vec2 Move = 0.5f * GameState->Player->Acceleration * Square(dt) + GameState->Player->Velocity * dt;
+    // note: bodies are only added and removed outside the fixed steps
+    u32 PlayerBodyIndex = GatherPhysicsBodies(GameState);
 
-        vec2 CollisionTime = vec2(1.f);
+    while (GameState->Lag >= GameState->UpdateRate)
+    {
+        sim_f32 dt = SimScalar(0.1f);
+        sim_f32 Zero = SimScalar(0.f);
 
-        for (u32 BoxIndex = 0; BoxIndex < GameState->TotalBoxCount; ++BoxIndex)
-        {
-            aabb *Box = GameState->Boxes + BoxIndex;
+        physics_system *Physics = GameState->Physics;
 
-            for (u32 PlayerBoxIndex = 0; PlayerBoxIndex < GameState->Player->BoxCount; ++PlayerBoxIndex)
-            {
-                aabb_info *PlayerBox = GameState->Player->Boxes + PlayerBoxIndex;
+        // note: moves every body along with its entity and boxes
+        StepPhysics(Physics, dt, &Platform->WorkQueue);
 
-                if (Box != PlayerBox->Box)
-                {
-                    vec2 t = SweptAABB(PlayerBox->Box->Position, Move, *Box, PlayerBox->Box->Size);
+        for (u32 ContactIndex = 0; ContactIndex < Physics->ContactCount; ++ContactIndex)
+        {
+            body_contact *Contact = Physics->Contacts + ContactIndex;
 
-                    if (t.x >= 0.f && t.x < CollisionTime.x)
-                    {
-                        CollisionTime.x = t.x;
-                    }
-                    if (t.y >= 0.f && t.y < CollisionTime.y)
-                    {
-                        CollisionTime.y = t.y;
-                    }
-                }
-            }
+            EmitEvent(&GameState->Events, event_body_contact{
+                GameState->Bodies.Entities[Contact->BodyIndex], Contact->Position, Contact->CollisionTime});
         }
 
-        vec2 UpdatedMove = Move * CollisionTime;
-        GameState->Player->Position.x += UpdatedMove.x;
-        GameState->Player->Position.y += UpdatedMove.y;
-
-        GameState->Player->Acceleration.x = 0.f;
-        // gravity (todo: 9.8)
-        GameState->Player->Acceleration.y = -1.f;
+        body_step Step = Physics->Steps[PlayerBodyIndex];
+        sim_vec2 UpdatedMove = Step.Move;
 
-        // collisions!
-        if (CollisionTime.x < 1.f)
+        if (Step.CollisionTime.y < SimScalar(1.f) && UpdatedMove.y < Zero)
         {
-            GameState->Player->Velocity.x = 0.f;
-        }
-
-        if (CollisionTime.y < 1.f)
-        {
-            GameState->Player->Velocity.y = 0.f;
+            entity_state PlayerState = GetCurrentEntityState(PlayerBehavior);
 
-            if (UpdatedMove.y < 0.f)
+            if (PlayerState == ENTITY_STATE_DIVE)
             {
-                entity_state PlayerState = GetCurrentEntityState(GameState->Player);
-
-                if (PlayerState == ENTITY_STATE_DIVE)
-                {
-                    EmitEvent(GameState, EVENT_TYPE_PLAYER_DIVE_HIT);
-                }
-
-                Pop(&GameState->Player->StatesStack);
-                Push(&GameState->Player->StatesStack, ENTITY_STATE_SQUASH);
+                EmitEvent(&GameState->Events, event_player_dive_hit{Player->Position});
             }
+
+            Pop(&PlayerBehavior->StatesStack);
+            Push(&PlayerBehavior->StatesStack, ENTITY_STATE_SQUASH);
         }
 
-        entity_state PlayerState = GetCurrentEntityState(GameState->Player);
+        entity_state PlayerState = GetCurrentEntityState(PlayerBehavior);
 
-        if (GameState->Player->Velocity.y > 0.f)
+        if (PlayerBody->Velocity.y > Zero)
         {
             if (PlayerState != ENTITY_STATE_JUMP)
             {
                 if (PlayerState == ENTITY_STATE_FALL)
                 {
-                    Pop(&GameState->Player->StatesStack);
+                    Pop(&PlayerBehavior->StatesStack);
                 }
 
-                Push(&GameState->Player->StatesStack, ENTITY_STATE_JUMP);
+                Push(&PlayerBehavior->StatesStack, ENTITY_STATE_JUMP);
             }
         }
-        else if (GameState->Player->Velocity.y < 0.f)
+        else if (PlayerBody->Velocity.y < Zero)
         {
             if (PlayerState != ENTITY_STATE_FALL && PlayerState != ENTITY_STATE_DIVE)
             {
                 if (PlayerState == ENTITY_STATE_JUMP || PlayerState == ENTITY_STATE_SQUASH)
                 {
-                    Pop(&GameState->Player->StatesStack);
+                    Pop(&PlayerBehavior->StatesStack);
                 }
-                Push(&GameState->Player->StatesStack, ENTITY_STATE_FALL);
+                Push(&PlayerBehavior->StatesStack, ENTITY_STATE_FALL);
             }
         }
 
-        // todo: store 1/size as well
-        GameState->Player->RenderInfo->InstanceModel = scale(
-            GameState->Player->RenderInfo->InstanceModel, 
-            vec3(1.f / GameState->Player->Size, 1.f)
-        );
-        GameState->Player->RenderInfo->InstanceModel = translate(
-            GameState->Player->RenderInfo->InstanceModel, 
-            vec3(UpdatedMove, 0.f)
-        );
-        GameState->Player->RenderInfo->InstanceModel = scale(
-            GameState->Player->RenderInfo->InstanceModel, 
-            vec3(GameState->Player->Size, 1.f)
-        );
-
-        for (u32 PlayerBoxModelIndex = 0; PlayerBoxModelIndex < GameState->Player->BoxCount; ++PlayerBoxModelIndex)
-        {
-            aabb_info *PlayerBox = GameState->Player->Boxes + PlayerBoxModelIndex;
-
-            PlayerBox->Box->Position += UpdatedMove;
-
-            *PlayerBox->Model = scale(*PlayerBox->Model, vec3(1.f / PlayerBox->Box->Size, 1.f));
-            *PlayerBox->Model = translate(*PlayerBox->Model, vec3(UpdatedMove, 0.f));
-            *PlayerBox->Model = scale(*PlayerBox->Model, vec3(PlayerBox->Box->Size, 1.f));
-        }
-
         // camera
         // todo: y-idle as well
-        vec2 IdleArea = {1.f, 1.f};
+        sim_vec2 IdleArea = SimVec2(vec2(1.f, 1.f));
 
-        if (UpdatedMove.x > 0.f)
+        if (UpdatedMove.x > Zero)
         {
-            if (GameState->Player->Position.x + GameState->Player->Size.x > GameState->Camera.x + IdleArea.x)
+            if (Player->Position.x + Player->Size.x > GameState->Camera.x + IdleArea.x)
             {
                 GameState->Camera.x += UpdatedMove.x;
             }
         }
-        else if (UpdatedMove.x < 0.f)
+        else if (UpdatedMove.x < Zero)
         {
-            if (GameState->Player->Position.x < GameState->Camera.x - IdleArea.x)
+            if (Player->Position.x < GameState->Camera.x - IdleArea.x)
             {
                 GameState->Camera.x += UpdatedMove.x;
             }
@@ -1670,6 +1956,11 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
 
         GameState->Camera.y += UpdatedMove.y;
 
+        GameState->SimStateHash = HashSimState(GameState->SimStateHash, &Player->Position, sizeof(Player->Position));
+        GameState->SimStateHash = HashSimState(GameState->SimStateHash, PlayerBody, sizeof(*PlayerBody));
+        GameState->SimStateHash = HashSimState(GameState->SimStateHash, &GameState->Camera, sizeof(GameState->Camera));
+        GameState->SimStateHash = HashSimState(GameState->SimStateHash, Physics->Contacts, Physics->ContactCount * sizeof(body_contact));
+
         GameState->Projection = ortho(
             -GameState->ScreenWidthInWorldUnits / 2.f * GameState->Zoom, 
             GameState->ScreenWidthInWorldUnits / 2.f * GameState->Zoom,
@@ -1678,12 +1969,14 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
         );
 
         mat4 View = mat4(1.f);
-        View = translate(View, vec3(-GameState->Camera.x, -GameState->Camera.y, 0.f));
+        View = translate(View, vec3(-ToF32(GameState->Camera.x), -ToF32(GameState->Camera.y), 0.f));
         View = translate(View, vec3(-GameState->ScreenWidthInWorldUnits / 2.f, -GameState->ScreenHeightInWorldUnits / 2.f, 0.f));
 
         GameState->VP = GameState->Projection * View;
 
         u32 ParticlesSpawn = 2;
+        particle_burst Burst = GenerateParticleBurst(&GameState->FrameArena, &GameState->Entropy, ParticlesSpawn, 2.f, 2.2f);
+
         for (u32 ParticleSpawnIndex = 0; ParticleSpawnIndex < ParticlesSpawn; ++ParticleSpawnIndex)
         {
             particle *Particle = GameState->Particles + GameState->NextParticle++;
@@ -1693,71 +1986,29 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
                 GameState->NextParticle = 0;
             }
 
-            Particle->Position = vec2(
-                RandomBetween(&GameState->Entropy, -0.1f, 0.1f) + 0.f, 
-                RandomBetween(&GameState->Entropy, 0.f, 0.1f)
-            );
-            Particle->Velocity = vec2(
-                RandomBetween(&GameState->Entropy, -0.5f, 0.5f), 
-                RandomBetween(&GameState->Entropy, 2.f, 2.2f)
-            );
-            Particle->Acceleration = vec2(0.f, -1.5f);
-            Particle->Color = vec4(
-                RandomBetween(&GameState->Entropy, 0.75f, 1.0f),
-                RandomBetween(&GameState->Entropy, 0.75f, 1.0f),
-                RandomBetween(&GameState->Entropy, 0.75f, 1.0f),
-                1.0f
-            );
+            Particle->Position = SimVec2(Burst.OffsetX[ParticleSpawnIndex], Burst.OffsetY[ParticleSpawnIndex]);
+            Particle->Velocity = SimVec2(Burst.VelocityX[ParticleSpawnIndex], Burst.VelocityY[ParticleSpawnIndex]);
+            Particle->Acceleration = SimVec2(vec2(0.f, -1.5f));
+            Particle->Color = vec4(Burst.Red[ParticleSpawnIndex], Burst.Green[ParticleSpawnIndex], Burst.Blue[ParticleSpawnIndex], 1.0f);
             Particle->dColor = vec4(0.f, 0.f, 0.f, -0.2f);
-            Particle->Size = vec2(0.1f);
-            Particle->dSize = vec2(-0.02f);
+            Particle->Size = SimVec2(vec2(0.1f));
+            Particle->dSize = SimVec2(vec2(-0.02f));
         }
 
         GameState->Lag -= GameState->UpdateRate;
+
+        ++Snapshots->Tick;
+        ++Snapshots->TicksSinceSnapshot;
     }
 
-    // process events (todo: all of them?)
-    while (GameState->EventQueue.Head != GameState->EventQueue.Tail)
+    // process events, one batch per type
     {
-        event Event = Dequeue(&GameState->EventQueue);
+        u32 DiveHitCount;
+        event_player_dive_hit *DiveHits = GetEventBatch<event_player_dive_hit>(&GameState->Events, &DiveHitCount);
 
-        switch (Event.Type)
+        if (DiveHitCount)
         {
-            case EVENT_TYPE_PLAYER_DIVE_HIT:
-            {
-                u32 ParticlesSpawn = 20;
-                for (u32 ParticleSpawnIndex = 0; ParticleSpawnIndex < ParticlesSpawn; ++ParticleSpawnIndex)
-                {
-                    particle *Particle = GameState->PlayerDiveParticles + GameState->NextPlayerDiveParticle++;
-
-                    if (GameState->NextPlayerDiveParticle >= ArrayCount(GameState->PlayerDiveParticles))
-                    {
-                        GameState->NextPlayerDiveParticle = 0;
-                    }
-
-                    Particle->Position = vec2(
-                        RandomBetween(&GameState->Entropy, -0.1f, 0.1f) + 0.f, 
-                        RandomBetween(&GameState->Entropy, 0.f, 0.1f)
-                    ) + GameState->Player->Position;
-                    Particle->Velocity = vec2(
-                        RandomBetween(&GameState->Entropy, -0.5f, 0.5f), 
-                        RandomBetween(&GameState->Entropy, 4.f, 4.2f)
-                    );
-                    Particle->Acceleration = vec2(0.f, -6.5f);
-                    Particle->Color = vec4(
-                        RandomBetween(&GameState->Entropy, 0.75f, 1.0f),
-                        RandomBetween(&GameState->Entropy, 0.75f, 1.0f),
-                        RandomBetween(&GameState->Entropy, 0.75f, 1.0f),
-                        1.0f
-                    );
-                    Particle->dColor = vec4(0.f, 0.f, 0.f, -0.6f);
-                    Particle->Size = vec2(0.1f);
-                    Particle->dSize = vec2(-0.02f);
-                }
-            }
-            break;
-
-            InvalidDefaultCase;
+            SpawnPlayerDiveParticles(GameState, DiveHits, DiveHitCount);
         }
     }
 
@@ -1787,48 +2038,49 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->DrawableEntitiesVertexBuffer.VBO);
 
     // mapping entity state to animation
-    entity_state PlayerState = GetCurrentEntityState(GameState->Player);
-    animation *PlayerAnimation = GameState->Player->CurrentAnimation;
+    entity_state PlayerState = GetCurrentEntityState(PlayerBehavior);
+    animation *PlayerAnimation = PlayerAnimator->CurrentAnimation;
 
     switch (PlayerState)
     {
         case ENTITY_STATE_IDLE:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_IDLE");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_IDLE"));
             break;
         case ENTITY_STATE_RUN:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_RUN");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_RUN"));
             break;
         case ENTITY_STATE_JUMP:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_JUMP");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_JUMP"));
             break;
         case ENTITY_STATE_DIVE:
             // todo: different animation for dive?
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_FALL");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_FALL"));
             break;
         case ENTITY_STATE_FALL:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_FALL");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_FALL"));
             break;
         case ENTITY_STATE_SQUASH:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_SQUASH");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_SQUASH"));
             break;
         case ENTITY_STATE_ATTACK:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_ATTACK");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_ATTACK"));
             break;
         case ENTITY_STATE_DUCK:
-            ChangeAnimationIfDifferent(GameState, GameState->Player, "PLAYER_DUCK");
+            ChangeAnimationIfDifferent(GameState, PlayerAnimator, SID("PLAYER_DUCK"));
             break;
 
         InvalidDefaultCase;
     }
 
     // animations
-    for (u32 EntityIndex = 0; EntityIndex < GameState->TotalDrawableObjectCount; ++EntityIndex)
+    for (u32 AnimatorIndex = 0; AnimatorIndex < GameState->Animators.Count; ++AnimatorIndex)
     {
-        entity *Entity = GameState->DrawableEntities + EntityIndex;
+        animator_component *Animator = GameState->Animators.Values + AnimatorIndex;
+        slot_handle EntityHandle = GameState->Animators.Entities[AnimatorIndex];
 
-        if (Entity->CurrentAnimation)
+        if (Animator->CurrentAnimation)
         {
-            animation *Animation = Entity->CurrentAnimation;
+            animation *Animation = Animator->CurrentAnimation;
             animation_frame *CurrentFrame = GetCurrentAnimationFrame(Animation);
 
             if (Animation->CurrentTime >= CurrentFrame->Duration)
@@ -1838,16 +2090,21 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
                 if (Animation->CurrentFrameIndex >= Animation->AnimationFrameCount)
                 {
                     // todo:
-                    entity_state EntityState = GetCurrentEntityState(Entity);
+                    behavior_component *Behavior = Get(&GameState->Behaviors, EntityHandle);
 
-                    switch (EntityState)
+                    if (Behavior)
                     {
-                    case ENTITY_STATE_ATTACK:
-                        Pop(&Entity->StatesStack);
-                        break;
-                    case ENTITY_STATE_SQUASH:
-                        Pop(&Entity->StatesStack);
-                        break;
+                        entity_state EntityState = GetCurrentEntityState(Behavior);
+
+                        switch (EntityState)
+                        {
+                        case ENTITY_STATE_ATTACK:
+                            Pop(&Behavior->StatesStack);
+                            break;
+                        case ENTITY_STATE_SQUASH:
+                            Pop(&Behavior->StatesStack);
+                            break;
+                        }
                     }
 
                     if (Animation->StopOnTheLastFrame)
@@ -1856,14 +2113,14 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
                     }
                     else
                     {
-                        if (Entity->CurrentAnimation->NextToPlay)
+                        if (Animator->CurrentAnimation->NextToPlay)
                         {
-                            Animation = Entity->CurrentAnimation->NextToPlay;
-                            ChangeAnimation(GameState, Entity, Animation);
+                            Animation = Animator->CurrentAnimation->NextToPlay;
+                            ChangeAnimation(GameState, Animator, Animation);
                         }
                         else
                         {
-                            Entity->CurrentAnimation = nullptr;
+                            Animator->CurrentAnimation = nullptr;
                         }
                     }
                 }
@@ -1876,23 +2133,23 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
                 Animation->CurrentTime = 0.f;
            }
 
-            Entity->RenderInfo->InstanceUVOffset01.x = CurrentFrame->CurrentXOffset01;
-            Entity->RenderInfo->InstanceUVOffset01.y = CurrentFrame->CurrentYOffset01;
+            entity *Entity = Get(&GameState->DrawableEntities, EntityHandle);
+            entity_render_info *RenderInfo = Get(&GameState->EntityRenderInfos, Entity->RenderInfo);
+            RenderInfo->InstanceUVOffset01 = PackUV(vec2(CurrentFrame->CurrentXOffset01, CurrentFrame->CurrentYOffset01));
 
             Animation->CurrentTime += Params->msPerFrame;
         }
     }
 
-    for (u32 EntityIndex = 0; EntityIndex < GameState->TotalDrawableObjectCount; ++EntityIndex)
-    {
-        entity *Entity = GameState->DrawableEntities + EntityIndex;
+    slot_map<entity_render_info> *EntityRenderInfos = &GameState->EntityRenderInfos;
+    u32 EntityRenderInfosSize = EntityRenderInfos->Count * sizeof(entity_render_info);
 
-        Renderer->glBufferSubData(GL_ARRAY_BUFFER, Entity->RenderInfo->Offset, sizeof(entity_render_info), Entity->RenderInfo);
-    }
+    BuildEntityInstanceTransforms(GameState, 1.f);
 
-    Renderer->glBufferSubData(GL_ARRAY_BUFFER, GameState->Player->RenderInfo->Offset, sizeof(entity_render_info), GameState->Player->RenderInfo);
+    // note: render infos are packed, so the whole instance range goes up in one call
+    Renderer->glBufferSubData(GL_ARRAY_BUFFER, GameState->QuadVerticesSize, EntityRenderInfosSize, EntityRenderInfos->Values);
 
-    Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GameState->TotalDrawableObjectCount);
+    Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, EntityRenderInfos->Count);
 
     // 2nd render pass: now draw slightly scaled versions of the objects, this time disabling stencil writing.
     Renderer->glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
@@ -1901,59 +2158,37 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     Renderer->glUseProgram(GameState->DrawableEntitiesBorderShaderProgram.ProgramHandle);
 
     {
-        shader_uniform *ColorUniform = GetUniform(&GameState->DrawableEntitiesBorderShaderProgram, "u_Color");
+        shader_uniform *ColorUniform = GetUniform(&GameState->DrawableEntitiesBorderShaderProgram, SID("u_Color"));
         
         vec4 Color = vec4(0.f, 0.f, 1.f, 1.f);
         SetShaderUniform(Renderer, ColorUniform->Location, Color);
     }
 
-    f32 scaleFactor = 1.1f;
-
-    for (u32 DrawableEntityIndex = 0; DrawableEntityIndex < GameState->TotalDrawableObjectCount; ++DrawableEntityIndex)
-    {
-        entity *Entity = GameState->DrawableEntities + DrawableEntityIndex;
-
-        Entity->RenderInfo->InstanceModel = translate(Entity->RenderInfo->InstanceModel, vec3(Entity->Size / 2.f, 1.f));
-        Entity->RenderInfo->InstanceModel = scale(Entity->RenderInfo->InstanceModel, vec3(scaleFactor, scaleFactor, 1.f));
-        Entity->RenderInfo->InstanceModel = translate(Entity->RenderInfo->InstanceModel, vec3(-Entity->Size / 2.f, 1.f));
-
-        Renderer->glBufferSubData(
-            GL_ARRAY_BUFFER, Entity->RenderInfo->Offset + StructOffset(entity_render_info, InstanceModel), 
-            sizeof(mat4), &Entity->RenderInfo->InstanceModel
-        );
-    }
-
-    Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GameState->TotalDrawableObjectCount);
-
-    for (u32 DrawableEntityIndex = 0; DrawableEntityIndex < GameState->TotalDrawableObjectCount; ++DrawableEntityIndex)
-    {
-        entity *Entity = GameState->DrawableEntities + DrawableEntityIndex;
+    // note: transforms are rebuilt from the entities every frame, so there's nothing to scale back afterwards
+    BuildEntityInstanceTransforms(GameState, 1.1f);
 
-        Entity->RenderInfo->InstanceModel = translate(Entity->RenderInfo->InstanceModel, vec3(Entity->Size / 2.f, 1.f));
-        Entity->RenderInfo->InstanceModel = scale(Entity->RenderInfo->InstanceModel, vec3(1.f / scaleFactor, 1.f / scaleFactor, 1.f));
-        Entity->RenderInfo->InstanceModel = translate(Entity->RenderInfo->InstanceModel, vec3(-Entity->Size / 2.f, 1.f));
+    Renderer->glBufferSubData(GL_ARRAY_BUFFER, GameState->QuadVerticesSize, EntityRenderInfosSize, EntityRenderInfos->Values);
 
-        Renderer->glBufferSubData(
-            GL_ARRAY_BUFFER, Entity->RenderInfo->Offset + StructOffset(entity_render_info, InstanceModel),
-            sizeof(mat4), &Entity->RenderInfo->InstanceModel
-        );
-    }
+    Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, EntityRenderInfos->Count);
 
     Renderer->glStencilFunc(GL_ALWAYS, 1, 0xFF);
     Renderer->glStencilMask(0xFF);
 
-    // Draw collidable regions (todo: update them as well, not only player's boxes)
+    // Draw collidable regions
     Renderer->glUseProgram(GameState->BoxesShaderProgram.ProgramHandle);
     Renderer->glBindVertexArray(GameState->BoxesVertexBuffer.VAO);
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->BoxesVertexBuffer.VBO);
 
-    for (u32 PlayerBoxModelIndex = 0; PlayerBoxModelIndex < GameState->Player->BoxCount; ++PlayerBoxModelIndex)
+    // note: the tile boxes never move, the entities' boxes come right after them and are rebuilt and uploaded in one go
     {
-        aabb_info *PlayerBox = GameState->Player->Boxes + PlayerBoxModelIndex;
+        u32 EntityBoxCount = GameState->TotalBoxCount - GameState->TileBoxCount;
+        instance_transform *EntityBoxInstances = GameState->BoxInstanceTransforms + GameState->TileBoxCount;
+
+        BuildBoxInstanceTransforms(GameState, GameState->Boxes + GameState->TileBoxCount, EntityBoxCount, EntityBoxInstances);
 
         Renderer->glBufferSubData(
-            GL_ARRAY_BUFFER, GameState->Player->RenderInfo->BoxModelOffset + PlayerBoxModelIndex * sizeof(mat4), 
-            sizeof(mat4), PlayerBox->Model
+            GL_ARRAY_BUFFER, GameState->QuadVerticesSize + GameState->TileBoxCount * sizeof(instance_transform),
+            EntityBoxCount * sizeof(instance_transform), EntityBoxInstances
         );
     }
 
@@ -1961,7 +2196,7 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
 
     // draw some borders
     {
-        vec2 Position = vec2(GameState->Camera.x, GameState->Camera.y);
+        vec2 Position = ToVec2(GameState->Camera);
         vec2 Size = vec2(GameState->ScreenWidthInWorldUnits, GameState->ScreenHeightInWorldUnits);
         rotation_info Rotation = {};
         Rotation.AngleInRadians = 0.f;
@@ -1986,6 +2221,8 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     }
 
     f32 dt = Params->msPerFrame * 0.001f;
+    sim_f32 ParticleDelta = SimScalar(dt);
+    sim_f32 ParticleHalf = SimScalar(0.5f);
 
     Renderer->glUseProgram(GameState->ParticlesShaderProgram.ProgramHandle);
     Renderer->glBindVertexArray(GameState->ParticlesVertexBuffer.VAO);
@@ -2000,40 +2237,18 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
             continue;
         }
 
-        Particle->Position += 0.5f * Particle->Acceleration * Square(dt) + Particle->Velocity * dt;
-        Particle->Velocity += dt * Particle->Acceleration;
+        sim_vec2 Move = ParticleHalf * Particle->Acceleration * SimSquare(ParticleDelta) + Particle->Velocity * ParticleDelta;
+        Particle->Velocity += ParticleDelta * Particle->Acceleration;
         Particle->Color += dt * Particle->dColor;
-        Particle->Size += dt * Particle->dSize;
-
-        f32 CoefficientOfRestitution = 0.3f;
+        Particle->Size += ParticleDelta * Particle->dSize;
 
-        if (Particle->Position.y < 0.f)
-        {
-            Particle->Position.y = -Particle->Position.y;
-            Particle->Velocity.y = -Particle->Velocity.y * CoefficientOfRestitution;
-        }
+        MoveParticle(&GameState->TileGrid, Particle, Move);
 
-        {
-            vec2 Position = vec2(GameState->ScreenWidthInWorldUnits / 2.f, GameState->ScreenHeightInWorldUnits / 2.f) + Particle->Position;
-            f32 Rotation = (f32)radians(GameState->Time * 250.f);
-            vec4 Color = Particle->Color;
-            vec2 Size = Particle->Size;
-
-            Particle->RenderInfo->Model = mat4(1.f);
-            // translation
-            Particle->RenderInfo->Model = translate(Particle->RenderInfo->Model, vec3(Position, 0.f));
-            // scaling
-            Particle->RenderInfo->Model = scale(Particle->RenderInfo->Model, vec3(Size, 0.f));
-            // rotation
-            //Particle->RenderInfo->Model = translate(Particle->RenderInfo->Model, vec3(Size / 2.f, 0.f));
-            //Particle->RenderInfo->Model = rotate(Particle->RenderInfo->Model, Rotation, vec3(0.f, 0.f, 1.f));
-            //Particle->RenderInfo->Model = translate(Particle->RenderInfo->Model, vec3(-Size / 2.f, 0.f));3
-
-
-            Particle->RenderInfo->Color = Color;
-        }
+        Particle->RenderInfo->Color = PackRGBA8(Particle->Color);
     }
 
+    BuildParticleInstanceTransforms(GameState, GameState->Particles, ArrayCount(GameState->Particles));
+
     Renderer->glBufferSubData(GL_ARRAY_BUFFER, GameState->QuadVerticesSize, 
         ArrayCount(GameState->Particles) * sizeof(particle_render_info), GameState->ParticleRenderInfos);
     Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, ArrayCount(GameState->Particles));
@@ -2042,51 +2257,55 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     Renderer->glBindVertexArray(GameState->PlayerDiveParticlesVertexBuffer.VAO);
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->PlayerDiveParticlesVertexBuffer.VBO);
 
-    for (u32 ParticleIndex = 0; ParticleIndex < ArrayCount(GameState->PlayerDiveParticles); ++ParticleIndex)
     {
-        particle *Particle = GameState->PlayerDiveParticles + ParticleIndex;
+        memory_pool<particle> *Pool = &GameState->PlayerDiveParticles;
+        vec2 ScreenCenter = GetScreenCenterInWorldUnits(GameState);
 
-        if (Particle->Color.a <= 0.f) {
-            continue;
-        }
+        instance_inputs Inputs = PushInstanceInputs(GameState, MAX_PLAYER_DIVE_PARTICLE_COUNT);
+        f32 *X = Inputs.X;
+        f32 *Y = Inputs.Y;
+        f32 *Width = Inputs.Width;
+        f32 *Height = Inputs.Height;
 
-        Particle->Position += 0.5f * Particle->Acceleration * Square(dt) + Particle->Velocity * dt;
-        Particle->Velocity += dt * Particle->Acceleration;
-        Particle->Color += dt * Particle->dColor;
-        Particle->Size += dt * Particle->dSize;
+        u32 InstanceCount = 0;
+
+        // note: freeing the slot the iterator just returned is fine, its bit is already consumed
+        memory_pool_iterator<particle> Iterator = IterateMemoryPool(Pool);
+        while (particle *Particle = NextPoolValue(Pool, &Iterator))
+        {
+            sim_vec2 Move = ParticleHalf * Particle->Acceleration * SimSquare(ParticleDelta) + Particle->Velocity * ParticleDelta;
+            Particle->Velocity += ParticleDelta * Particle->Acceleration;
+            Particle->Color += dt * Particle->dColor;
+            Particle->Size += ParticleDelta * Particle->dSize;
+
+            if (Particle->Color.a <= 0.f)
+            {
+                PoolFree(Pool, Particle);
+                continue;
+            }
 
-        f32 CoefficientOfRestitution = 0.3f;
+            MoveParticle(&GameState->TileGrid, Particle, Move);
 
-        //if (Particle->Position.y < -GameState->Player->Position.y)
-        //{
-        //    Particle->Position.y = -Particle->Position.y;
-        //    Particle->Velocity.y = -Particle->Velocity.y * CoefficientOfRestitution;
-        //}
+            X[InstanceCount] = ScreenCenter.x + ToF32(Particle->Position.x);
+            Y[InstanceCount] = ScreenCenter.y + ToF32(Particle->Position.y);
+            Width[InstanceCount] = ToF32(Particle->Size.x);
+            Height[InstanceCount] = ToF32(Particle->Size.y);
 
+            GameState->PlayerDiveParticleRenderInfos[InstanceCount].Color = PackRGBA8(Particle->Color);
+            ++InstanceCount;
+        }
+
+        if (InstanceCount > 0)
         {
-            vec2 Position = vec2(GameState->ScreenWidthInWorldUnits / 2.f, GameState->ScreenHeightInWorldUnits / 2.f) + Particle->Position;
-            f32 Rotation = (f32)radians(GameState->Time);
-            vec4 Color = Particle->Color;
-            vec2 Size = Particle->Size;
-
-            Particle->RenderInfo->Model = mat4(1.f);
-            // translation
-            Particle->RenderInfo->Model = translate(Particle->RenderInfo->Model, vec3(Position, 0.f));
-            // scaling
-            Particle->RenderInfo->Model = scale(Particle->RenderInfo->Model, vec3(Size, 0.f));
-            // rotation
-            //Particle->RenderInfo->Model = translate(Particle->RenderInfo->Model, vec3(Size / 2.f, 0.f));
-            //Particle->RenderInfo->Model = rotate(Particle->RenderInfo->Model, Rotation, vec3(0.f, 0.f, 1.f));
-            //Particle->RenderInfo->Model = translate(Particle->RenderInfo->Model, vec3(-Size / 2.f, 0.f));
-
-            Particle->RenderInfo->Color = Color;
+            BuildInstanceTransforms(InstanceCount, X, Y, Width, Height, 
+                &GameState->PlayerDiveParticleRenderInfos[0].Transform, sizeof(particle_render_info));
+
+            Renderer->glBufferSubData(GL_ARRAY_BUFFER, GameState->QuadVerticesSize, 
+                InstanceCount * sizeof(particle_render_info), GameState->PlayerDiveParticleRenderInfos);
+            Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, InstanceCount);
         }
     }
 
-    Renderer->glBufferSubData(GL_ARRAY_BUFFER, GameState->QuadVerticesSize, 
-        ArrayCount(GameState->PlayerDiveParticles) * sizeof(particle_render_info), GameState->PlayerDiveParticleRenderInfos);
-    Renderer->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, ArrayCount(GameState->PlayerDiveParticles));
-
     // draw some test sprites
     {
         vec2 Size = vec2(1.f);
@@ -2121,28 +2340,31 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
         Rotation.Axis = vec3(0.f, 1.f, 0.f);
         f32 TextScale = 0.5f;
 
-        wchar FrameFps[32];
-        FormatString(FrameFps, ArrayCount(FrameFps), L"fps: %.1f", 1000.f / Params->msPerFrame);
+        u32 MaxLineLength = 64;
+        memory_arena *FrameArena = &GameState->FrameArena;
+
+        wchar *FrameFps = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(FrameFps, MaxLineLength, L"fps: %.1f", 1000.f / Params->msPerFrame);
 
-        wchar FrameTime[32];
-        FormatString(FrameTime, ArrayCount(FrameTime), L"ms: %.4f", Params->msPerFrame);
+        wchar *FrameTime = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(FrameTime, MaxLineLength, L"ms: %.4f", Params->msPerFrame);
 
-        char PlayerStateString[32];
-        GetEntityStateString(GetCurrentEntityState(GameState->Player), PlayerStateString, ArrayCount(PlayerStateString));
+        char *PlayerStateString = PushString(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        GetEntityStateString(GetCurrentEntityState(PlayerBehavior), PlayerStateString, MaxLineLength);
 
-        wchar PlayerState[32];
-        FormatString(PlayerState, ArrayCount(PlayerState), L"player state: %S, count: %u", PlayerStateString, GameState->Player->StatesStack.Head);
+        wchar *PlayerState = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(PlayerState, MaxLineLength, L"player state: %S, count: %u", PlayerStateString, PlayerBehavior->StatesStack.Head);
 
-        wchar PlayerPosition[64];
-        FormatString(PlayerPosition, ArrayCount(PlayerPosition), L"player position: x: %.2f, y: %.2f", GameState->Player->Position.x, GameState->Player->Position.y);
+        wchar *PlayerPosition = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(PlayerPosition, MaxLineLength, L"player position: x: %.2f, y: %.2f", ToF32(Player->Position.x), ToF32(Player->Position.y));
 
-        wchar MousePosition[64];
+        wchar *MousePosition = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
         f32 CanonicalMouseX = (Params->Input.MouseX * GameState->PixelsToWorldUnits - 
-            GameState->ScreenWidthInWorldUnits / 2.f) * GameState->Zoom + GameState->Camera.x;
+            GameState->ScreenWidthInWorldUnits / 2.f) * GameState->Zoom + ToF32(GameState->Camera.x);
         f32 CanonicalMouseY = (Params->Input.MouseY * GameState->PixelsToWorldUnits - 
-            GameState->ScreenHeightInWorldUnits / 2.f) * GameState->Zoom + GameState->Camera.y;
+            GameState->ScreenHeightInWorldUnits / 2.f) * GameState->Zoom + ToF32(GameState->Camera.y);
 
-        FormatString(MousePosition, ArrayCount(MousePosition), L"mouse position: x: %.2f, y: %.2f", CanonicalMouseX, CanonicalMouseY);
+        FormatString(MousePosition, MaxLineLength, L"mouse position: x: %.2f, y: %.2f", CanonicalMouseX, CanonicalMouseY);
 
         f32 NextLineAdvance = GameState->CurrentFont->VerticalAdvance * GameState->PixelsToWorldUnits * TextScale;
         DrawTextLine(Renderer, GameState, FrameFps, Position, TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
@@ -2150,5 +2372,109 @@ extern "C" EXPORT GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
         DrawTextLine(Renderer, GameState, PlayerState, Position - vec2(0.f, 2.f * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
         DrawTextLine(Renderer, GameState, PlayerPosition, Position - vec2(0.f, 3.f * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
         DrawTextLine(Renderer, GameState, MousePosition, Position - vec2(0.f, 4.f * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        // note: everything below is drawn one line after another
+        f32 LineIndex = 5.f;
+
+        // snapshots (F2 rewinds)
+        wchar *SnapshotLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(SnapshotLine, MaxLineLength, L"snapshots: %u, skipped: %u, restore: %.3f ms",
+            Snapshots->SnapshotCount, Snapshots->Stats.SkippedCount, Snapshots->Stats.LastRestoreMs);
+        DrawTextLine(Renderer, GameState, SnapshotLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        wchar *CaptureLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(CaptureLine, MaxLineLength, L"    frame: %.3f ms, last: %.1f KB (%u pages)",
+            Snapshots->Stats.FrameCaptureMs, Snapshots->Stats.LastCaptureSize / 1024.f, Snapshots->Stats.LastDirtyPageCount);
+        DrawTextLine(Renderer, GameState, CaptureLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        // page size and translation misses (large pages are opt-in on the platform side)
+        wchar *PagesLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(PagesLine, MaxLineLength, L"pages: %llu KB%S",
+            Memory->PageSize / 1024, Memory->UsesLargePages ? " (large)" : "");
+        DrawTextLine(Renderer, GameState, PagesLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        wchar *TranslationLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        if (Params->Counters.IsAvailable)
+        {
+            FormatString(TranslationLine, MaxLineLength, L"    dtlb misses: %llu per frame", Params->Counters.DTLBMisses);
+        }
+        else
+        {
+            FormatString(TranslationLine, MaxLineLength, L"    dtlb misses: n/a");
+        }
+        DrawTextLine(Renderer, GameState, TranslationLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        wchar *BroadphaseLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(BroadphaseLine, MaxLineLength, L"broadphase: %u tiles, %u pairs",
+            GameState->Physics->TileVisitCount, GameState->Physics->CandidatePairCount);
+        DrawTextLine(Renderer, GameState, BroadphaseLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        wchar *BoxGridLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(BoxGridLine, MaxLineLength, L"    %u boxes in %dx%d cells",
+            GameState->BoxGrid.BoxCount, GameState->BoxGrid.CellCountX, GameState->BoxGrid.CellCountY);
+        DrawTextLine(Renderer, GameState, BoxGridLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        wchar *TileBoxesLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(TileBoxesLine, MaxLineLength, L"    tile boxes: %u, merged: %u, drawn: %u",
+            GameState->TileGrid.BoxCount, GameState->TileGrid.MergedBoxCount, GameState->TileBoxCount);
+        DrawTextLine(Renderer, GameState, TileBoxesLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        // note: contacts of every fixed step this frame
+        u32 ContactCount;
+        GetEventBatch<event_body_contact>(&GameState->Events, &ContactCount);
+
+        wchar *PhysicsLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(PhysicsLine, MaxLineLength, L"physics: %u bodies, %u chunks, %u workers, %u contacts",
+            GameState->Physics->BodyCount, GameState->Physics->ChunkCount, Platform->WorkQueue.WorkerCount, ContactCount);
+        DrawTextLine(Renderer, GameState, PhysicsLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, vec4(0.f, 1.f, 1.f, 1.f), GameState->CurrentFont);
+
+        // memory usage (F1 dumps it to a file)
+        f32 BytesToKilobytes = 1.f / 1024.f;
+        vec4 MemoryTextColor = vec4(1.f, 1.f, 0.f, 1.f);
+
+        memory_arena *Arenas[] = { &GameState->WorldArena, &GameState->TransientArena, FrameArena };
+        const char *ArenaNames[] = { "world", "transient", "frame" };
+
+        for (u32 ArenaIndex = 0; ArenaIndex < ArrayCount(Arenas); ++ArenaIndex)
+        {
+            memory_arena *Arena = Arenas[ArenaIndex];
+
+            // note: two lines per arena, a 4 GB reserve alone is 9 characters in KB
+            wchar *ArenaLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+            FormatString(ArenaLine, MaxLineLength, L"%S arena: %.1f / %.1f KB", 
+                ArenaNames[ArenaIndex], Arena->Stats.Used * BytesToKilobytes, Arena->Size * BytesToKilobytes);
+            DrawTextLine(Renderer, GameState, ArenaLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, MemoryTextColor, GameState->CurrentFont);
+
+            wchar *ArenaPeakLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+            FormatString(ArenaPeakLine, MaxLineLength, L"%S peak: %.1f KB, allocs: %u", 
+                ArenaNames[ArenaIndex], Arena->Stats.HighWaterMark * BytesToKilobytes, Arena->Stats.AllocationCount);
+            DrawTextLine(Renderer, GameState, ArenaPeakLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, MemoryTextColor, GameState->CurrentFont);
+
+            for (u32 TagIndex = 0; TagIndex < MEMORY_TAG_COUNT; ++TagIndex)
+            {
+                memory_stats *TagStats = Arena->TagStats + TagIndex;
+
+                if (TagStats->HighWaterMark > 0)
+                {
+                    wchar *TagLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+                    FormatString(TagLine, MaxLineLength, L"  %S: %.1f KB (peak %.1f), allocs: %u", 
+                        GetMemoryTagName((memory_tag)TagIndex), TagStats->Used * BytesToKilobytes, 
+                        TagStats->HighWaterMark * BytesToKilobytes, TagStats->AllocationCount);
+                    DrawTextLine(Renderer, GameState, TagLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, MemoryTextColor, GameState->CurrentFont);
+                }
+            }
+        }
+
+        ring_arena *StagingArena = GameState->StagingArena;
+
+        wchar *StagingLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(StagingLine, MaxLineLength, L"staging ring: %.1f / %.1f KB, peak: %.1f KB", 
+            StagingArena->Used * BytesToKilobytes, StagingArena->Size * BytesToKilobytes, StagingArena->Stats.HighWaterMark * BytesToKilobytes);
+        DrawTextLine(Renderer, GameState, StagingLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, MemoryTextColor, GameState->CurrentFont);
+
+        wchar *StagingCountsLine = PushArray<wchar>(FrameArena, MaxLineLength, MEMORY_TAG_DEBUG);
+        FormatString(StagingCountsLine, MaxLineLength, L"staging allocs: %u, overflows: %u", 
+            StagingArena->Stats.AllocationCount, StagingArena->OverflowCount);
+        DrawTextLine(Renderer, GameState, StagingCountsLine, Position - vec2(0.f, LineIndex++ * NextLineAdvance), TextScale, &Rotation, MemoryTextColor, GameState->CurrentFont);
     }
 }
\ No newline at end of file
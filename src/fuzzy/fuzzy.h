@@ -2,56 +2,39 @@
 
 #include "fuzzy_types.h"
 #include "fuzzy_memory.h"
+#include "fuzzy_strings.h"
+#include "fuzzy_snapshot.h"
+#include "fuzzy_events.h"
+#include "fuzzy_physics.h"
 #include "fuzzy_tiled.h"
 #include "fuzzy_renderer.h"
 #include "fuzzy_animations.h"
 #include "fuzzy_containers.h"
 #include "assets.h"
 
-enum event_type
-{
-    EVENT_TYPE_NONE,
-    EVENT_TYPE_PLAYER_DIVE_HIT,
-
-    EVENT_TYPE_COUNT
-};
-
-struct event_data
-{
-
-};
-
-struct event
-{
-    event_type Type;
-    event_data *Data;
-};
+#define MAX_PLAYER_DIVE_PARTICLE_COUNT 256
 
 struct aabb_info
 {
-    aabb *Box;
-    mat4 *Model;
+    sim_aabb *Box;
+    instance_transform *Instance;
 };
 
 struct entity_render_info
 {
-    u64 Offset;
-
-    mat4 InstanceModel;
-    vec2 InstanceUVOffset01;
+    instance_transform Transform;
+    packed_uv InstanceUVOffset01;
     u32 Flipped;
 
     // todo:
-    u32 BoxModelOffset;
+    u32 BoxInstanceOffset;
 };
 
 struct particle_render_info
 {
-    u64 Offset;
-
-    mat4 Model;
-    //vec2 uvOffset01;
-    vec4 Color;
+    instance_transform Transform;
+    // note: rgba8, see PackRGBA8
+    u32 Color;
 };
 
 enum entity_state
@@ -66,48 +49,78 @@ enum entity_state
     ENTITY_STATE_ATTACK
 };
 
+// note: only what every drawable entity has, optional data lives in the component sets of game_state
 struct entity
 {
     u32 ID;
 
-    vec2 Position;
-    vec2 Velocity;
-    vec2 Acceleration;
-
-    vec2 Size;
+    sim_vec2 Position;
+    sim_vec2 Size;
     entity_type Type;
-    // todo: pushdown automata?
-    stack<entity_state> StatesStack; 
 
-    entity_render_info *RenderInfo;
+    // note: into GameState->EntityRenderInfos
+    slot_handle RenderInfo;
+};
 
+struct collider_component
+{
     u32 BoxCount;
     aabb_info *Boxes;
+};
 
+struct animator_component
+{
     animation *CurrentAnimation;
 };
 
+struct behavior_component
+{
+    // todo: pushdown automata?
+    stack<entity_state> StatesStack;
+};
+
 struct particle
 {
-    vec2 Position;
-    vec2 Velocity;
-    vec2 Acceleration;
+    sim_vec2 Position;
+    sim_vec2 Velocity;
+    sim_vec2 Acceleration;
     vec4 Color;
     vec4 dColor;
-    vec2 Size;
-    vec2 dSize;
+    sim_vec2 Size;
+    sim_vec2 dSize;
 
     particle_render_info *RenderInfo;
 };
 
+// note: random attributes of a whole spawn burst, one array per attribute
+struct particle_burst
+{
+    sim_f32 *OffsetX;
+    sim_f32 *OffsetY;
+    sim_f32 *VelocityX;
+    sim_f32 *VelocityY;
+    f32 *Red;
+    f32 *Green;
+    f32 *Blue;
+};
+
 struct game_state
 {
     b32 IsInitialized;
 
     memory_arena WorldArena;
+    memory_arena TransientArena;
+    // reset at the beginning of every frame
+    memory_arena FrameArena;
+
+    // note: lives in transient storage, so restoring a snapshot doesn't rewind the ring itself
+    snapshot_ring *Snapshots;
+
+    // note: for data that has to outlive a frame but not the session (uploads, async reads), lives in transient storage as well
+    ring_arena *StagingArena;
 
     // bottom-left corner <-- is it?
-    vec2 Camera;
+    sim_vec2 Camera;
     f32 Zoom;
 
     tilemap Map;
@@ -116,12 +129,18 @@ struct game_state
     f32 Lag;
     f32 UpdateRate;
 
+    // note: running hash of the player's simulation state and every body's contacts, replays of the same input have to end up with the same value
+    u64 SimStateHash;
+
     u32 TotalBoxCount;
     u32 TotalTileCount;
+
+    // note: tile boxes as read from the tileset, they come first in Boxes and are only drawn
+    u32 TileBoxCount;
     u32 TotalObjectCount;
 
     u32 TotalDrawableObjectCount;
-    entity *DrawableEntities;
+    slot_map<entity> DrawableEntities;
 
     vertex_buffer TilesVertexBuffer;
     vertex_buffer BoxesVertexBuffer;
@@ -140,6 +159,8 @@ struct game_state
     shader_program SpriteShaderProgram;
     shader_program TextShaderProgram;
 
+    text_shader_uniforms TextUniforms;
+
     mat4 Projection;
     mat4 VP;
 
@@ -148,25 +169,40 @@ struct game_state
 
     u32 UBO;
 
-    entity *Player;
-    aabb *Boxes;
+    slot_handle Player;
+    sim_aabb *Boxes;
+    instance_transform *BoxInstanceTransforms;
+
+    // note: static collision comes from the tile layers, the grid only holds the boxes of entities without a body
+    tile_grid TileGrid;
+    box_grid BoxGrid;
+
+    // note: steps everything in Bodies; lives in transient storage, the grid queries' visit marks must not be rewound by a restore
+    physics_system *Physics;
 
     hash_table<animation> Animations;
 
-    // todo: merge with TotalDrawableObjectCount?
-    u32 EntityRenderInfoCount;
-    // todo: maybe store in in entity directly?
-    entity_render_info *EntityRenderInfos;
+    // note: names behind uniform and animation ids
+    hash_table<interned_string> Strings;
+
+    // note: packed, uploaded to the instance buffer as is
+    slot_map<entity_render_info> EntityRenderInfos;
+
+    // note: keyed by DrawableEntities handles
+    sparse_set<body_component> Bodies;
+    sparse_set<collider_component> Colliders;
+    sparse_set<animator_component> Animators;
+    sparse_set<behavior_component> Behaviors;
     particle_render_info *ParticleRenderInfos;
     particle_render_info *PlayerDiveParticleRenderInfos;
 
     u32 NextParticle;
-    particle Particles[1024];
+    alignas(CACHE_LINE_SIZE) particle Particles[1024];
 
-    u32 NextPlayerDiveParticle;
-    particle PlayerDiveParticles[256];
+    // note: spawned on dive hits and freed once they fade out, at most MAX_PLAYER_DIVE_PARTICLE_COUNT are alive
+    memory_pool<particle> PlayerDiveParticles;
 
-    random_sequence Entropy;
+    random_lanes Entropy;
 
     u32 QuadVerticesSize;
 
@@ -181,7 +217,7 @@ struct game_state
     f32 PixelsToWorldUnits;
     f32 WorldUnitsToPixels;
 
-    queue<event> EventQueue;
+    event_bus Events;
 
     vec3 BackgroundColor;
 };
@@ -1,43 +1,29 @@
 #include "fuzzy_animations.h"
 
 inline b32
-AnimationKeyComparator(animation *Animation, char *Key)
+AnimationKeyComparator(animation *Animation, string_id Key)
 {
-    b32 Result = StringEquals(Animation->Name, Key);
-    return Result;
-}
-
-inline b32
-AnimationKeyExists(animation *Animation)
-{
-    b32 Result = false;
-
-    if (Animation->Name)
-    {
-        Result = true;
-    }
-
+    b32 Result = Animation->Id == Key;
     return Result;
 }
 
 inline void
-AnimationKeySetter(animation *Animation, char *Key)
+AnimationKeySetter(animation *Animation, string_id Key)
 {
-    Animation->Name = Key;
+    Animation->Id = Key;
 }
 
 inline animation *
-GetAnimation(game_state *GameState, char *Name)
+GetAnimation(game_state *GameState, string_id Id)
 {
-    animation *Result = Get<animation, char *>(&GameState->Animations, Name, AnimationKeyComparator);
+    animation *Result = Get<animation, string_id>(&GameState->Animations, Id, AnimationKeyComparator);
     return Result;
 }
 
 inline animation *
-CreateAnimation(game_state *GameState, char *Name, memory_arena *Arena)
+CreateAnimation(game_state *GameState, string_id Id)
 {
-    animation *Result = Create<animation, char *>(
-        &GameState->Animations, Name, AnimationKeyExists, AnimationKeySetter, Arena);
+    animation *Result = Create<animation, string_id>(&GameState->Animations, Id, AnimationKeySetter);
     return Result;
 }
 
@@ -49,7 +35,7 @@ GetCurrentAnimationFrame(animation *Animation)
 }
 
 internal void
-ChangeAnimation(game_state *GameState, entity *Entity, animation *Animation, b32 Loop = true)
+ChangeAnimation(game_state *GameState, animator_component *Animator, animation *Animation, b32 Loop = true)
 {
     Animation->CurrentFrameIndex = 0;
     animation_frame *CurrentFrame = GetCurrentAnimationFrame(Animation);
@@ -64,23 +50,23 @@ ChangeAnimation(game_state *GameState, entity *Entity, animation *Animation, b32
         Animation->NextToPlay = Animation;
     }
 
-    Entity->CurrentAnimation = Animation;
+    Animator->CurrentAnimation = Animation;
 }
 
 inline void
-ChangeAnimation(game_state *GameState, entity *Entity, char *Name, b32 Loop = true)
+ChangeAnimation(game_state *GameState, animator_component *Animator, string_id Id, b32 Loop = true)
 {
-    animation *Animation = GetAnimation(GameState, Name);
-    ChangeAnimation(GameState, Entity, Animation, Loop);
+    animation *Animation = GetAnimation(GameState, Id);
+    ChangeAnimation(GameState, Animator, Animation, Loop);
 }
 
 inline void
-ChangeAnimationIfDifferent(game_state *GameState, entity *Entity, char *Name, b32 Loop = true)
+ChangeAnimationIfDifferent(game_state *GameState, animator_component *Animator, string_id Id, b32 Loop = true)
 {
-    animation *Animation = GetAnimation(GameState, Name);
+    animation *Animation = GetAnimation(GameState, Id);
 
-    if (Animation != Entity->CurrentAnimation)
+    if (Animation != Animator->CurrentAnimation)
     {
-        ChangeAnimation(GameState, Entity, Animation, Loop);
+        ChangeAnimation(GameState, Animator, Animation, Loop);
     }
 }
@@ -23,9 +23,8 @@ struct animation
     f32 CurrentTime;
     b32 StopOnTheLastFrame;
 
+    string_id Id;
     char *Name;
     
     animation *NextToPlay;
-    // todo: hash_table naming
-    animation *Next;
 };
\ No newline at end of file
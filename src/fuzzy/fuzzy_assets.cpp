@@ -8,7 +8,7 @@ LoadGameAssets(platform_api *Platform, game_state *GameState, memory_arena *Aren
     Assert(AssetHeader->MagicValue == 0x451);
 
     GameState->FontAssetCount = AssetHeader->FontCount;
-    GameState->FontAssets = PushArray<font_asset>(Arena, GameState->FontAssetCount);
+    GameState->FontAssets = PushArray<font_asset>(Arena, GameState->FontAssetCount, MEMORY_TAG_FONTS);
 
     u64 FontAssetHeaderOffset = AssetHeader->FontsOffset;
     for (u32 FontAssetIndex = 0; FontAssetIndex < GameState->FontAssetCount; ++FontAssetIndex)
@@ -18,25 +18,25 @@ LoadGameAssets(platform_api *Platform, game_state *GameState, memory_arena *Aren
         font_asset_header *FontAssetHeader = (font_asset_header *)((u8 *)AssetFile.Contents + FontAssetHeaderOffset);
 
         u32 PixelCount = FontAssetHeader->TextureAtlasWidth * FontAssetHeader->TextureAtlasHeight * FontAssetHeader->TextureAtlasChannels;
-        u8 *TextureAtlas = PushArray<u8>(Arena, PixelCount);
+        u8 *TextureAtlas = PushArray<u8>(Arena, PixelCount, MEMORY_TAG_FONTS);
         CopyMemoryBlock(
             (u8 *)AssetFile.Contents + FontAssetHeader->TextureAtlasOffset, 
             TextureAtlas, PixelCount * sizeof(u8)
         );
 
-        codepoints_range *CodepointsRanges = PushArray<codepoints_range>(Arena, FontAssetHeader->CodepointsRangeCount);
+        codepoints_range *CodepointsRanges = PushArray<codepoints_range>(Arena, FontAssetHeader->CodepointsRangeCount, MEMORY_TAG_FONTS);
         CopyMemoryBlock(
             (u8 *)AssetFile.Contents + FontAssetHeader->CodepointsRangesOffset, 
             CodepointsRanges, FontAssetHeader->CodepointsRangeCount * sizeof(codepoints_range)
         );
 
-        f32 *HorizontalAdvanceTable = PushArray<f32>(Arena, FontAssetHeader->HorizontalAdvanceTableCount);
+        f32 *HorizontalAdvanceTable = PushArray<f32>(Arena, FontAssetHeader->HorizontalAdvanceTableCount, MEMORY_TAG_FONTS);
         CopyMemoryBlock(
             (u8 *)AssetFile.Contents + FontAssetHeader->HorizontalAdvanceTableOffset, 
             HorizontalAdvanceTable, FontAssetHeader->HorizontalAdvanceTableCount * sizeof(f32)
         );
 
-        glyph *Glyphs = PushArray<glyph>(Arena, FontAssetHeader->GlyphCount);
+        glyph *Glyphs = PushArray<glyph>(Arena, FontAssetHeader->GlyphCount, MEMORY_TAG_FONTS);
         CopyMemoryBlock(
             (u8 *)AssetFile.Contents + FontAssetHeader->GlyphsOffset, 
             Glyphs, FontAssetHeader->GlyphCount * sizeof(glyph)
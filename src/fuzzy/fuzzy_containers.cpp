@@ -1,67 +1,305 @@
 #include "fuzzy_containers.h"
 #include "fuzzy_memory.h"
 
+#define HASH_TABLE_MIN_CAPACITY 8
+
+// note: keeps the load factor at or below one half
+inline u32
+GetHashTableCapacity(u32 ExpectedCount)
+{
+    u32 Result = HASH_TABLE_MIN_CAPACITY;
+
+    while (Result < ExpectedCount * 2)
+    {
+        Result <<= 1;
+    }
+
+    return Result;
+}
+
+// note: 0 is reserved for empty slots
+template<typename TKey>
+inline u32
+GetStoredHash(TKey Key)
+{
+    u32 Result = Hash(Key);
+
+    if (Result == 0)
+    {
+        Result = 1;
+    }
+
+    return Result;
+}
+
+template<typename TValue>
+internal void
+InitializeHashTable(hash_table<TValue> *HashTable, u32 ExpectedCount, memory_arena *Arena, memory_tag Tag = MEMORY_TAG_UNTAGGED)
+{
+    HashTable->Capacity = GetHashTableCapacity(ExpectedCount);
+    HashTable->Mask = HashTable->Capacity - 1;
+    HashTable->Count = 0;
+
+    HashTable->Hashes = PushArray<u32>(Arena, HashTable->Capacity, Tag, CACHE_LINE_SIZE);
+    HashTable->Values = PushArray<TValue>(Arena, HashTable->Capacity, Tag, CACHE_LINE_SIZE);
+
+    for (u32 SlotIndex = 0; SlotIndex < HashTable->Capacity; ++SlotIndex)
+    {
+        HashTable->Hashes[SlotIndex] = 0;
+        HashTable->Values[SlotIndex] = {};
+    }
+}
+
+template<typename TValue>
+inline b32
+IsSlotOccupied(hash_table<TValue> *HashTable, u32 SlotIndex)
+{
+    b32 Result = HashTable->Hashes[SlotIndex] != 0;
+    return Result;
+}
+
+// note: the comparator only runs on slots whose stored hash matches
 template<typename TValue, typename TKey>
 internal TValue *
-Get(hash_table<TValue> *HashTable, TKey Key, b32(*KeyComparator)(TValue *, TKey)) {
+Get(hash_table<TValue> *HashTable, TKey Key, b32(*KeyComparator)(TValue *, TKey)) 
+{
     TValue *Result = nullptr;
 
-    u32 HashValueIndex = Hash(Key) % HashTable->Count;
-    Assert(HashValueIndex < HashTable->Count);
-
-    TValue *Value = HashTable->Values + HashValueIndex;
+    u32 KeyHash = GetStoredHash(Key);
+    u32 SlotIndex = KeyHash & HashTable->Mask;
 
-    do 
+    while (HashTable->Hashes[SlotIndex])
     {
-        if (KeyComparator(Value, Key)) 
+        if (HashTable->Hashes[SlotIndex] == KeyHash && KeyComparator(HashTable->Values + SlotIndex, Key))
         {
-            Result = Value;
+            Result = HashTable->Values + SlotIndex;
             break;
         }
 
-        Value = Value->Next;
-    } 
-    while (Value);
+        SlotIndex = (SlotIndex + 1) & HashTable->Mask;
+    }
 
     return Result;
 }
 
-
+// note: doesn't check for duplicates, keys are expected to be unique
 template<typename TValue, typename TKey>
 internal TValue * 
-Create(
+Create(hash_table<TValue> *HashTable, TKey Key, void(*KeySetter)(TValue *, TKey))
+{
+    Assert((HashTable->Count + 1) * 2 <= HashTable->Capacity);
+
+    u32 KeyHash = GetStoredHash(Key);
+    u32 SlotIndex = KeyHash & HashTable->Mask;
+
+    while (HashTable->Hashes[SlotIndex])
+    {
+        SlotIndex = (SlotIndex + 1) & HashTable->Mask;
+    }
+
+    HashTable->Hashes[SlotIndex] = KeyHash;
+    ++HashTable->Count;
+
+    TValue *Result = HashTable->Values + SlotIndex;
+    KeySetter(Result, Key);
+
+    return Result;
+}
+
+// note: sizes the table for exactly KeyCount keys and inserts all of them, values are left zeroed
+template<typename TValue, typename TKey>
+internal void
+BuildHashTable(
     hash_table<TValue> *HashTable, 
-    TKey Key, 
-    b32(*KeyExists)(TValue *), 
+    TKey *Keys, 
+    u32 KeyCount, 
     void(*KeySetter)(TValue *, TKey), 
-    memory_arena *Arena
+    memory_arena *Arena, 
+    memory_tag Tag = MEMORY_TAG_UNTAGGED
 )
 {
-    TValue *Result = nullptr;
+    InitializeHashTable(HashTable, KeyCount, Arena, Tag);
 
-    u32 HashValueIndex = Hash(Key) % HashTable->Count;
-    Assert(HashValueIndex < HashTable->Count);
+    for (u32 KeyIndex = 0; KeyIndex < KeyCount; ++KeyIndex)
+    {
+        Create(HashTable, Keys[KeyIndex], KeySetter);
+    }
+}
 
-    TValue *Value = HashTable->Values + HashValueIndex;
+template<typename TValue>
+internal hash_table_stats
+GetHashTableStats(hash_table<TValue> *HashTable)
+{
+    hash_table_stats Result = {};
+    Result.Count = HashTable->Count;
+    Result.Capacity = HashTable->Capacity;
+    Result.LoadFactor = HashTable->Capacity ? (f32)HashTable->Count / (f32)HashTable->Capacity : 0.f;
 
-    do 
+    u32 TotalProbeLength = 0;
+
+    for (u32 SlotIndex = 0; SlotIndex < HashTable->Capacity; ++SlotIndex)
     {
-        if (!KeyExists(Value))
+        u32 StoredHash = HashTable->Hashes[SlotIndex];
+
+        if (StoredHash)
         {
-            Result = Value;
-            KeySetter(Result, Key);
-            break;
+            // note: number of slots a successful lookup of this key has to look at
+            u32 ProbeLength = ((SlotIndex - (StoredHash & HashTable->Mask)) & HashTable->Mask) + 1;
+
+            TotalProbeLength += ProbeLength;
+            if (ProbeLength > Result.MaxProbeLength)
+            {
+                Result.MaxProbeLength = ProbeLength;
+            }
         }
+    }
+
+    Result.AverageProbeLength = HashTable->Count ? (f32)TotalProbeLength / (f32)HashTable->Count : 0.f;
+
+    return Result;
+}
+
+#define SLOT_MAP_NO_FREE_SLOT 0xFFFFFFFF
+
+inline slot_handle
+MakeSlotHandle(u32 SlotIndex, u32 Generation)
+{
+    slot_handle Result = (Generation << SLOT_HANDLE_INDEX_BITS) | SlotIndex;
+    return Result;
+}
+
+inline u32
+GetSlotIndex(slot_handle Handle)
+{
+    u32 Result = Handle & SLOT_HANDLE_INDEX_MASK;
+    return Result;
+}
+
+inline u32
+GetSlotGeneration(slot_handle Handle)
+{
+    u32 Result = Handle >> SLOT_HANDLE_INDEX_BITS;
+    return Result;
+}
+
+template<typename T>
+internal void
+InitializeSlotMap(slot_map<T> *SlotMap, u32 MaxCount, memory_arena *Arena, memory_tag Tag = MEMORY_TAG_UNTAGGED)
+{
+    Assert(MaxCount <= SLOT_HANDLE_INDEX_MASK);
+
+    SlotMap->MaxCount = MaxCount;
+    SlotMap->Count = 0;
+    SlotMap->FirstFree = MaxCount ? 0 : SLOT_MAP_NO_FREE_SLOT;
+
+    SlotMap->Slots = PushArray<slot_map_slot>(Arena, MaxCount, Tag);
+    SlotMap->SlotIndices = PushArray<u32>(Arena, MaxCount, Tag);
+    SlotMap->Values = PushArray<T>(Arena, MaxCount, Tag, CACHE_LINE_SIZE);
+
+    for (u32 SlotIndex = 0; SlotIndex < MaxCount; ++SlotIndex)
+    {
+        slot_map_slot *Slot = SlotMap->Slots + SlotIndex;
+
+        Slot->DenseIndex = SlotIndex + 1 < MaxCount ? SlotIndex + 1 : SLOT_MAP_NO_FREE_SLOT;
+        // note: generation 0 is reserved, so the zero handle never resolves
+        Slot->Generation = 1;
+    }
+}
+
+template<typename T>
+inline b32
+IsValid(slot_map<T> *SlotMap, slot_handle Handle)
+{
+    u32 SlotIndex = GetSlotIndex(Handle);
+
+    b32 Result =
+        SlotIndex < SlotMap->MaxCount &&
+        SlotMap->Slots[SlotIndex].Generation == GetSlotGeneration(Handle) &&
+        SlotMap->Slots[SlotIndex].DenseIndex < SlotMap->Count &&
+        SlotMap->SlotIndices[SlotMap->Slots[SlotIndex].DenseIndex] == SlotIndex;
+
+    return Result;
+}
+
+// note: returns nullptr for handles whose value was removed
+template<typename T>
+inline T *
+Get(slot_map<T> *SlotMap, slot_handle Handle)
+{
+    T *Result = nullptr;
+
+    if (IsValid(SlotMap, Handle))
+    {
+        Result = SlotMap->Values + SlotMap->Slots[GetSlotIndex(Handle)].DenseIndex;
+    }
+
+    return Result;
+}
+
+template<typename T>
+inline slot_handle
+GetHandle(slot_map<T> *SlotMap, u32 DenseIndex)
+{
+    Assert(DenseIndex < SlotMap->Count);
+
+    u32 SlotIndex = SlotMap->SlotIndices[DenseIndex];
+    slot_handle Result = MakeSlotHandle(SlotIndex, SlotMap->Slots[SlotIndex].Generation);
+
+    return Result;
+}
+
+template<typename T>
+internal slot_handle
+Insert(slot_map<T> *SlotMap, T Value)
+{
+    Assert(SlotMap->FirstFree != SLOT_MAP_NO_FREE_SLOT);
+
+    u32 SlotIndex = SlotMap->FirstFree;
+    slot_map_slot *Slot = SlotMap->Slots + SlotIndex;
+
+    SlotMap->FirstFree = Slot->DenseIndex;
+
+    u32 DenseIndex = SlotMap->Count++;
 
-        if (KeyExists(Value) && !Value->Next)
+    Slot->DenseIndex = DenseIndex;
+    SlotMap->SlotIndices[DenseIndex] = SlotIndex;
+    SlotMap->Values[DenseIndex] = Value;
+
+    slot_handle Result = MakeSlotHandle(SlotIndex, Slot->Generation);
+    return Result;
+}
+
+// note: the last value is moved into the hole, so dense indices (not handles) of other values can change
+template<typename T>
+internal b32
+Remove(slot_map<T> *SlotMap, slot_handle Handle)
+{
+    b32 Result = false;
+
+    if (IsValid(SlotMap, Handle))
+    {
+        u32 SlotIndex = GetSlotIndex(Handle);
+        slot_map_slot *Slot = SlotMap->Slots + SlotIndex;
+
+        u32 DenseIndex = Slot->DenseIndex;
+        u32 LastDenseIndex = --SlotMap->Count;
+
+        if (DenseIndex != LastDenseIndex)
         {
-            Value->Next = PushStruct<TValue>(Arena);
-            KeySetter(Value->Next, 0);
+            u32 MovedSlotIndex = SlotMap->SlotIndices[LastDenseIndex];
+
+            SlotMap->Values[DenseIndex] = SlotMap->Values[LastDenseIndex];
+            SlotMap->SlotIndices[DenseIndex] = MovedSlotIndex;
+            SlotMap->Slots[MovedSlotIndex].DenseIndex = DenseIndex;
         }
 
-        Value = Value->Next;
-    } 
-    while (Value);
+        // note: generation wraps around skipping 0, stale handles become valid again only after that many reuses
+        Slot->Generation = Slot->Generation < SLOT_HANDLE_MAX_GENERATION ? Slot->Generation + 1 : 1;
+        Slot->DenseIndex = SlotMap->FirstFree;
+        SlotMap->FirstFree = SlotIndex;
+
+        Result = true;
+    }
 
     return Result;
 }
@@ -111,10 +349,7 @@ Enqueue(queue<T> *Queue, T NewValue)
         NextHead = 0;
     }
 
-    if (NextHead == Queue->Tail)
-    {
-        Assert("Queue is full");
-    }
+    Assert(NextHead != Queue->Tail);
 
     T *Value = Queue->Values + Queue->Head;
     *Value = NewValue;
@@ -126,10 +361,7 @@ template<typename T>
 inline T
 Dequeue(queue<T> *Queue)
 {
-    if (Queue->Head == Queue->Tail)
-    {
-        Assert("Queue is empty");
-    }
+    Assert(Queue->Head != Queue->Tail);
 
     u32 NextTail = Queue->Tail + 1;
 
@@ -143,3 +375,192 @@ Dequeue(queue<T> *Queue)
 
     return *Value;
 }
+
+template<typename T>
+internal void
+InitializeMpscQueue(mpsc_queue<T> *Queue, u32 MaxCount, memory_arena *Arena, memory_tag Tag = MEMORY_TAG_UNTAGGED)
+{
+    // note: positions are masked into the ring, so the capacity has to be a power of two
+    Assert(MaxCount && (MaxCount & (MaxCount - 1)) == 0);
+
+    Queue->MaxCount = MaxCount;
+    Queue->Mask = MaxCount - 1;
+    Queue->Cells = PushArray<mpsc_queue_cell<T>>(Arena, MaxCount, Tag, CACHE_LINE_SIZE);
+
+    for (u32 CellIndex = 0; CellIndex < MaxCount; ++CellIndex)
+    {
+        Queue->Cells[CellIndex].Sequence.store(CellIndex, std::memory_order_relaxed);
+    }
+
+    Queue->Head.store(0, std::memory_order_relaxed);
+    Queue->Tail = 0;
+}
+
+// note: safe to call from any thread, returns false when the queue is full
+template<typename T>
+internal b32
+TryEnqueue(mpsc_queue<T> *Queue, T NewValue)
+{
+    u32 Position = Queue->Head.load(std::memory_order_relaxed);
+    mpsc_queue_cell<T> *Cell;
+
+    for (;;)
+    {
+        Cell = Queue->Cells + (Position & Queue->Mask);
+
+        u32 Sequence = Cell->Sequence.load(std::memory_order_acquire);
+        i32 Difference = (i32)(Sequence - Position);
+
+        if (Difference == 0)
+        {
+            // note: on failure Position is reloaded with the current head
+            if (Queue->Head.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (Difference < 0)
+        {
+            // the consumer hasn't freed this cell yet
+            return false;
+        }
+        else
+        {
+            Position = Queue->Head.load(std::memory_order_relaxed);
+        }
+    }
+
+    Cell->Value = NewValue;
+    Cell->Sequence.store(Position + 1, std::memory_order_release);
+
+    return true;
+}
+
+// note: consumer thread only, returns false when there is nothing to dequeue
+template<typename T>
+internal b32
+TryDequeue(mpsc_queue<T> *Queue, T *Value)
+{
+    mpsc_queue_cell<T> *Cell = Queue->Cells + (Queue->Tail & Queue->Mask);
+
+    u32 Sequence = Cell->Sequence.load(std::memory_order_acquire);
+
+    if ((i32)(Sequence - (Queue->Tail + 1)) < 0)
+    {
+        return false;
+    }
+
+    *Value = Cell->Value;
+    Cell->Sequence.store(Queue->Tail + Queue->MaxCount, std::memory_order_release);
+
+    ++Queue->Tail;
+
+    return true;
+}
+
+// note: consumer thread only, stops at the first cell a producer claimed but hasn't finished writing
+template<typename T>
+internal u32
+DequeueBatch(mpsc_queue<T> *Queue, T *Values, u32 MaxCount)
+{
+    u32 Result = 0;
+
+    while (Result < MaxCount && TryDequeue(Queue, Values + Result))
+    {
+        ++Result;
+    }
+
+    return Result;
+}
+
+template<typename T>
+internal void
+InitializeSparseSet(sparse_set<T> *Set, u32 MaxEntityCount, u32 MaxCount, memory_arena *Arena, memory_tag Tag = MEMORY_TAG_UNTAGGED)
+{
+    Set->MaxEntityCount = MaxEntityCount;
+    Set->MaxCount = MaxCount;
+    Set->Count = 0;
+
+    // note: sparse is left uninitialized, a stale index is rejected by the check against Entities
+    Set->Sparse = PushArray<u32>(Arena, MaxEntityCount, Tag);
+    Set->Entities = PushArray<slot_handle>(Arena, MaxCount, Tag);
+    Set->Values = PushArray<T>(Arena, MaxCount, Tag, CACHE_LINE_SIZE);
+}
+
+template<typename T>
+inline b32
+Has(sparse_set<T> *Set, slot_handle Entity)
+{
+    u32 SlotIndex = GetSlotIndex(Entity);
+
+    b32 Result =
+        SlotIndex < Set->MaxEntityCount &&
+        Set->Sparse[SlotIndex] < Set->Count &&
+        Set->Entities[Set->Sparse[SlotIndex]] == Entity;
+
+    return Result;
+}
+
+template<typename T>
+inline T *
+Get(sparse_set<T> *Set, slot_handle Entity)
+{
+    T *Result = nullptr;
+
+    if (Has(Set, Entity))
+    {
+        Result = Set->Values + Set->Sparse[GetSlotIndex(Entity)];
+    }
+
+    return Result;
+}
+
+// note: returns the existing component if the entity already has one
+template<typename T>
+internal T *
+Add(sparse_set<T> *Set, slot_handle Entity)
+{
+    T *Result = Get(Set, Entity);
+
+    if (!Result)
+    {
+        Assert(Set->Count < Set->MaxCount);
+        Assert(GetSlotIndex(Entity) < Set->MaxEntityCount);
+
+        u32 DenseIndex = Set->Count++;
+
+        Set->Sparse[GetSlotIndex(Entity)] = DenseIndex;
+        Set->Entities[DenseIndex] = Entity;
+
+        Result = Set->Values + DenseIndex;
+        *Result = {};
+    }
+
+    return Result;
+}
+
+template<typename T>
+internal b32
+Remove(sparse_set<T> *Set, slot_handle Entity)
+{
+    b32 Result = false;
+
+    if (Has(Set, Entity))
+    {
+        u32 DenseIndex = Set->Sparse[GetSlotIndex(Entity)];
+        u32 LastDenseIndex = --Set->Count;
+
+        if (DenseIndex != LastDenseIndex)
+        {
+            slot_handle MovedEntity = Set->Entities[LastDenseIndex];
+
+            Set->Values[DenseIndex] = Set->Values[LastDenseIndex];
+            Set->Entities[DenseIndex] = MovedEntity;
+            Set->Sparse[GetSlotIndex(MovedEntity)] = DenseIndex;
+        }
+
+        Result = true;
+    }
+
+    return Result;
+}
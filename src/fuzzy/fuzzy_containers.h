@@ -1,12 +1,27 @@
 #pragma once
 
+// open addressing with linear probing, a stored hash of 0 marks an empty slot
 template<typename T>
 struct hash_table
 {
+    u32 Capacity;
+    u32 Mask;
     u32 Count;
+
+    u32 *Hashes;
     T *Values;
 };
 
+struct hash_table_stats
+{
+    u32 Count;
+    u32 Capacity;
+    f32 LoadFactor;
+
+    f32 AverageProbeLength;
+    u32 MaxProbeLength;
+};
+
 template<typename T>
 struct stack
 {
@@ -26,3 +41,67 @@ struct queue
 
     T *Values;
 };
+
+template<typename T>
+struct mpsc_queue_cell
+{
+    // note: equals the enqueue position when the cell is free for it, position + 1 once the value is written
+    std::atomic<u32> Sequence;
+    T Value;
+};
+
+// bounded lock-free ring, any thread can enqueue, only one thread may dequeue
+template<typename T>
+struct mpsc_queue
+{
+    u32 MaxCount;
+    u32 Mask;
+
+    mpsc_queue_cell<T> *Cells;
+
+    // note: producers and the consumer each get their own cache line
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> Head;
+    alignas(CACHE_LINE_SIZE) u32 Tail;
+};
+
+// note: low bits are the slot index, high bits the generation of the slot, 0 is never a valid handle
+typedef u32 slot_handle;
+
+#define SLOT_HANDLE_INDEX_BITS 20
+#define SLOT_HANDLE_INDEX_MASK ((1u << SLOT_HANDLE_INDEX_BITS) - 1)
+#define SLOT_HANDLE_MAX_GENERATION ((1u << (32 - SLOT_HANDLE_INDEX_BITS)) - 1)
+
+struct slot_map_slot
+{
+    // note: index of the value while the slot is in use, next free slot otherwise
+    u32 DenseIndex;
+    u32 Generation;
+};
+
+// values are kept packed (swap-removed), so they can be iterated or uploaded without holes
+template<typename T>
+struct slot_map
+{
+    u32 MaxCount;
+    u32 Count;
+    u32 FirstFree;
+
+    slot_map_slot *Slots;
+    // note: slot index for every value, needed to patch the slot of the value moved by a removal
+    u32 *SlotIndices;
+    T *Values;
+};
+
+// components for a subset of slot map handles, packed so systems iterate only the owners
+template<typename T>
+struct sparse_set
+{
+    u32 MaxEntityCount;
+    u32 MaxCount;
+    u32 Count;
+
+    // note: slot index -> dense index, only trusted when the dense entry points back at the same handle
+    u32 *Sparse;
+    slot_handle *Entities;
+    T *Values;
+};
@@ -0,0 +1,74 @@
+#include "fuzzy_events.h"
+
+internal void
+BeginEventBusFrame(event_bus *Bus, memory_arena *FrameArena)
+{
+    *Bus = {};
+    Bus->Arena = FrameArena;
+}
+
+// note: doubles the batch, the old payloads stay in the frame arena until it's cleared
+internal void
+GrowEventBatch(event_bus *Bus, event_batch *Batch)
+{
+    u32 NewMaxCount = Batch->MaxCount ? Batch->MaxCount * 2 : EVENT_BATCH_INITIAL_COUNT;
+    u8 *NewPayloads = (u8 *)PushSize(Bus->Arena, NewMaxCount * Batch->PayloadSize, MEMORY_TAG_EVENTS, CACHE_LINE_SIZE);
+
+    if (Batch->Count)
+    {
+        CopyMemoryBlock(Batch->Payloads, NewPayloads, Batch->Count * Batch->PayloadSize);
+    }
+
+    Batch->Payloads = NewPayloads;
+    Batch->MaxCount = NewMaxCount;
+
+    ++Bus->GrowCount;
+}
+
+internal void *
+PushEventPayload(event_bus *Bus, event_type Type, u32 PayloadSize)
+{
+    Assert(Type > EVENT_TYPE_NONE && Type < EVENT_TYPE_COUNT);
+
+    event_batch *Batch = Bus->Batches + Type;
+
+    if (!Batch->PayloadSize)
+    {
+        Batch->PayloadSize = PayloadSize;
+    }
+
+    Assert(Batch->PayloadSize == PayloadSize);
+
+    if (Batch->Count == Batch->MaxCount)
+    {
+        GrowEventBatch(Bus, Batch);
+    }
+
+    void *Result = Batch->Payloads + Batch->Count * Batch->PayloadSize;
+
+    ++Batch->Count;
+    ++Bus->EventCount;
+
+    return Result;
+}
+
+template<typename T>
+inline void
+EmitEvent(event_bus *Bus, T Payload)
+{
+    T *Result = (T *)PushEventPayload(Bus, T::Type, sizeof(T));
+    *Result = Payload;
+}
+
+// note: all events of one type emitted this frame, in emission order
+template<typename T>
+inline T *
+GetEventBatch(event_bus *Bus, u32 *Count)
+{
+    event_batch *Batch = Bus->Batches + T::Type;
+
+    *Count = Batch->Count;
+
+    T *Result = (T *)Batch->Payloads;
+    return Result;
+}
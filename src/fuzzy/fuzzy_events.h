@@ -0,0 +1,51 @@
+#pragma once
+
+#define EVENT_BATCH_INITIAL_COUNT 16
+
+enum event_type
+{
+    EVENT_TYPE_NONE,
+    EVENT_TYPE_PLAYER_DIVE_HIT,
+    EVENT_TYPE_BODY_CONTACT,
+
+    EVENT_TYPE_COUNT
+};
+
+// note: every payload struct names its event type, EmitEvent and GetEventBatch pick the batch from it
+struct event_player_dive_hit
+{
+    static constexpr event_type Type = EVENT_TYPE_PLAYER_DIVE_HIT;
+
+    sim_vec2 Position;
+};
+
+// note: a body's move got clipped by the static world, emitted in body order after every physics step
+struct event_body_contact
+{
+    static constexpr event_type Type = EVENT_TYPE_BODY_CONTACT;
+
+    slot_handle Entity;
+    sim_vec2 Position;
+    sim_vec2 CollisionTime;
+};
+
+// payloads of one event type stored back to back
+struct event_batch
+{
+    u32 Count;
+    u32 MaxCount;
+    u32 PayloadSize;
+
+    u8 *Payloads;
+};
+
+// note: batches are allocated from the frame arena, so the bus has to be reset at the start of every frame
+struct event_bus
+{
+    memory_arena *Arena;
+
+    event_batch Batches[EVENT_TYPE_COUNT];
+
+    u32 EventCount;
+    u32 GrowCount;
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "fuzzy_types.h"
+
+// note: the simulation runs on the sim_ types below, 1 makes them q16.16 fixed-point so the same input gives bit-identical
+// state on every compiler and optimization level, 0 keeps plain f32 (faster, but fma contraction and x87/sse differences leak in)
+#if !defined(FUZZY_FIXED_POINT)
+#define FUZZY_FIXED_POINT 0
+#endif
+
+#define FIXED_FRACTION_BITS 16
+#define FIXED_ONE (1 << FIXED_FRACTION_BITS)
+
+#pragma region Fixed-point
+struct fixed
+{
+    i32 Value;
+};
+
+struct fixed2
+{
+    fixed x;
+    fixed y;
+};
+
+inline fixed
+SaturateFixed(i64 Value)
+{
+    fixed Result;
+    Result.Value = Value > INT32_MAX ? INT32_MAX : (Value < INT32_MIN ? INT32_MIN : (i32)Value);
+
+    return Result;
+}
+
+// note: the product with a power of two is exact, so the rounding is the same everywhere
+inline fixed
+FixedFromF32(f32 Value)
+{
+    fixed Result;
+    Result.Value = (i32)(Value * (f32)FIXED_ONE + (Value < 0.f ? -0.5f : 0.5f));
+
+    return Result;
+}
+
+inline f32
+FixedToF32(fixed Value)
+{
+    f32 Result = (f32)Value.Value * (1.f / (f32)FIXED_ONE);
+    return Result;
+}
+
+inline fixed operator+(fixed A, fixed B) { return SaturateFixed((i64)A.Value + B.Value); }
+inline fixed operator-(fixed A, fixed B) { return SaturateFixed((i64)A.Value - B.Value); }
+inline fixed operator-(fixed A) { return SaturateFixed(-(i64)A.Value); }
+inline fixed operator*(fixed A, fixed B) { return SaturateFixed(((i64)A.Value * B.Value) >> FIXED_FRACTION_BITS); }
+
+// note: rounds toward zero, division by zero saturates in the direction of the dividend
+inline fixed
+operator/(fixed A, fixed B)
+{
+    fixed Result;
+
+    if (B.Value == 0)
+    {
+        Result.Value = A.Value < 0 ? INT32_MIN : INT32_MAX;
+    }
+    else
+    {
+        Result = SaturateFixed(((i64)A.Value * FIXED_ONE) / B.Value);
+    }
+
+    return Result;
+}
+
+inline fixed &operator+=(fixed &A, fixed B) { A = A + B; return A; }
+inline fixed &operator-=(fixed &A, fixed B) { A = A - B; return A; }
+inline fixed &operator*=(fixed &A, fixed B) { A = A * B; return A; }
+
+inline b32 operator==(fixed A, fixed B) { return A.Value == B.Value; }
+inline b32 operator!=(fixed A, fixed B) { return A.Value != B.Value; }
+inline b32 operator<(fixed A, fixed B) { return A.Value < B.Value; }
+inline b32 operator>(fixed A, fixed B) { return A.Value > B.Value; }
+inline b32 operator<=(fixed A, fixed B) { return A.Value <= B.Value; }
+inline b32 operator>=(fixed A, fixed B) { return A.Value >= B.Value; }
+
+inline fixed2 operator+(fixed2 A, fixed2 B) { return {A.x + B.x, A.y + B.y}; }
+inline fixed2 operator-(fixed2 A, fixed2 B) { return {A.x - B.x, A.y - B.y}; }
+inline fixed2 operator-(fixed2 A) { return {-A.x, -A.y}; }
+inline fixed2 operator*(fixed2 A, fixed2 B) { return {A.x * B.x, A.y * B.y}; }
+inline fixed2 operator*(fixed A, fixed2 B) { return {A * B.x, A * B.y}; }
+inline fixed2 operator*(fixed2 A, fixed B) { return {A.x * B, A.y * B}; }
+inline fixed2 operator/(fixed2 A, fixed B) { return {A.x / B, A.y / B}; }
+
+inline fixed2 &operator+=(fixed2 &A, fixed2 B) { A = A + B; return A; }
+inline fixed2 &operator-=(fixed2 &A, fixed2 B) { A = A - B; return A; }
+inline fixed2 &operator*=(fixed2 &A, fixed2 B) { A = A * B; return A; }
+#pragma endregion
+
+#pragma region Simulation types
+#if FUZZY_FIXED_POINT
+using sim_f32 = fixed;
+using sim_vec2 = fixed2;
+
+inline sim_f32 SimScalar(f32 Value) { return FixedFromF32(Value); }
+inline f32 ToF32(sim_f32 Value) { return FixedToF32(Value); }
+
+// note: the arithmetic shift rounds toward negative infinity
+inline i32 SimFloorToI32(sim_f32 Value) { return Value.Value >> FIXED_FRACTION_BITS; }
+#else
+using sim_f32 = f32;
+using sim_vec2 = vec2;
+
+inline sim_f32 SimScalar(f32 Value) { return Value; }
+inline f32 ToF32(sim_f32 Value) { return Value; }
+
+inline i32 SimFloorToI32(sim_f32 Value) { return (i32)floorf(Value); }
+#endif
+
+inline sim_vec2
+SimVec2(sim_f32 X, sim_f32 Y)
+{
+    sim_vec2 Result;
+    Result.x = X;
+    Result.y = Y;
+
+    return Result;
+}
+
+inline sim_vec2
+SimVec2(vec2 Value)
+{
+    sim_vec2 Result = SimVec2(SimScalar(Value.x), SimScalar(Value.y));
+    return Result;
+}
+
+// note: conversion back to f32 only happens when the simulation state is handed to the renderer
+inline vec2
+ToVec2(sim_vec2 Value)
+{
+    vec2 Result = vec2(ToF32(Value.x), ToF32(Value.y));
+    return Result;
+}
+
+inline sim_f32
+SimMin(sim_f32 A, sim_f32 B)
+{
+    sim_f32 Result = A < B ? A : B;
+    return Result;
+}
+
+inline sim_f32
+SimMax(sim_f32 A, sim_f32 B)
+{
+    sim_f32 Result = A > B ? A : B;
+    return Result;
+}
+
+inline sim_f32
+SimAbs(sim_f32 Value)
+{
+    sim_f32 Result = Value < SimScalar(0.f) ? -Value : Value;
+    return Result;
+}
+
+inline sim_f32
+SimSquare(sim_f32 Value)
+{
+    sim_f32 Result = Value * Value;
+    return Result;
+}
+
+inline sim_f32
+SimLerp(sim_f32 A, sim_f32 t, sim_f32 B)
+{
+    sim_f32 Result = A + t * (B - A);
+    return Result;
+}
+#pragma endregion
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "fuzzy_types.h"
+#include "fuzzy_simd.h"
 
 // from https://stackoverflow.com/questions/664014
 inline u32
@@ -16,13 +17,13 @@ Hash(u32 Value)
 }
 
 // from https://stackoverflow.com/questions/7666509/
-inline u32
-Hash(char *Value)
+constexpr u32
+Hash(const char *Value)
 {
     u32 Hash = 5381;
-    i32 C;
+    i32 C = 0;
 
-    while (C = *Value++)
+    while ((C = *Value++))
     {
         Hash = ((Hash << 5) + Hash) + C;
     }
@@ -57,3 +58,186 @@ AbsoluteValue(f32 Value)
 
     return Result;
 }
+
+inline u16
+PackUnorm16(f32 Value)
+{
+    f32 Clamped = Value < 0.f ? 0.f : (Value > 1.f ? 1.f : Value);
+    u16 Result = (u16)(Clamped * 65535.f + 0.5f);
+
+    return Result;
+}
+
+// note: r is the lowest byte, so the bytes are in rgba order in memory
+inline u32
+PackRGBA8(vec4 Color)
+{
+    u32 Result = 0;
+
+    for (u32 ComponentIndex = 0; ComponentIndex < 4; ++ComponentIndex)
+    {
+        f32 Component = Color[ComponentIndex];
+        f32 Clamped = Component < 0.f ? 0.f : (Component > 1.f ? 1.f : Component);
+
+        Result |= (u32)(Clamped * 255.f + 0.5f) << (ComponentIndex * 8);
+    }
+
+    return Result;
+}
+
+// note: uv offsets go to the gpu as normalized u16, the vertex attribute turns them back into [0, 1]
+struct packed_uv
+{
+    u16 U;
+    u16 V;
+};
+
+inline packed_uv
+PackUV(vec2 UV)
+{
+    packed_uv Result = {};
+    Result.U = PackUnorm16(UV.x);
+    Result.V = PackUnorm16(UV.y);
+
+    return Result;
+}
+
+#pragma region Instance transforms
+// note: every instanced pipeline draws axis aligned quads, the vertex shaders compute Position + Vertex * Size
+struct instance_transform
+{
+    vec2 Position;
+    vec2 Size;
+};
+
+// note: Stride is the distance in bytes between two transforms so they can be written straight into render info structs
+inline instance_transform *
+GetInstanceTransform(instance_transform *Transforms, memory_index Stride, u32 Index)
+{
+    instance_transform *Result = (instance_transform *)((u8 *)Transforms + Index * Stride);
+    return Result;
+}
+
+internal void
+BuildInstanceTransformsScalar(u32 Count, f32 *X, f32 *Y, f32 *Width, f32 *Height, instance_transform *Transforms, memory_index Stride)
+{
+    for (u32 Index = 0; Index < Count; ++Index)
+    {
+        instance_transform *Transform = GetInstanceTransform(Transforms, Stride, Index);
+
+        Transform->Position.x = X[Index];
+        Transform->Position.y = Y[Index];
+        Transform->Size.x = Width[Index];
+        Transform->Size.y = Height[Index];
+    }
+}
+
+#if FUZZY_SSE2
+internal void
+BuildInstanceTransformsSSE2(u32 Count, f32 *X, f32 *Y, f32 *Width, f32 *Height, instance_transform *Transforms, memory_index Stride)
+{
+    u32 Index = 0;
+    for (; Index + 4 <= Count; Index += 4)
+    {
+        __m128 Row0 = _mm_loadu_ps(X + Index);
+        __m128 Row1 = _mm_loadu_ps(Y + Index);
+        __m128 Row2 = _mm_loadu_ps(Width + Index);
+        __m128 Row3 = _mm_loadu_ps(Height + Index);
+
+        // note: turns the four soa rows into four (x, y, width, height) instances
+        _MM_TRANSPOSE4_PS(Row0, Row1, Row2, Row3);
+
+        _mm_storeu_ps((f32 *)GetInstanceTransform(Transforms, Stride, Index + 0), Row0);
+        _mm_storeu_ps((f32 *)GetInstanceTransform(Transforms, Stride, Index + 1), Row1);
+        _mm_storeu_ps((f32 *)GetInstanceTransform(Transforms, Stride, Index + 2), Row2);
+        _mm_storeu_ps((f32 *)GetInstanceTransform(Transforms, Stride, Index + 3), Row3);
+    }
+
+    BuildInstanceTransformsScalar(
+        Count - Index, X + Index, Y + Index, Width + Index, Height + Index,
+        GetInstanceTransform(Transforms, Stride, Index), Stride
+    );
+}
+#endif
+
+#if FUZZY_AVX2
+internal FUZZY_AVX2_TARGET void
+BuildInstanceTransformsAVX2(u32 Count, f32 *X, f32 *Y, f32 *Width, f32 *Height, instance_transform *Transforms, memory_index Stride)
+{
+    u32 Index = 0;
+    for (; Index + 8 <= Count; Index += 8)
+    {
+        __m256 X8 = _mm256_loadu_ps(X + Index);
+        __m256 Y8 = _mm256_loadu_ps(Y + Index);
+        __m256 Width8 = _mm256_loadu_ps(Width + Index);
+        __m256 Height8 = _mm256_loadu_ps(Height + Index);
+
+        // note: 4x4 transposes within each 128 bit half, the low half holds instances 0-3 and the high half 4-7
+        __m256 XY01 = _mm256_unpacklo_ps(X8, Y8);
+        __m256 XY23 = _mm256_unpackhi_ps(X8, Y8);
+        __m256 Size01 = _mm256_unpacklo_ps(Width8, Height8);
+        __m256 Size23 = _mm256_unpackhi_ps(Width8, Height8);
+
+        __m256 Instances04 = _mm256_shuffle_ps(XY01, Size01, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 Instances15 = _mm256_shuffle_ps(XY01, Size01, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 Instances26 = _mm256_shuffle_ps(XY23, Size23, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 Instances37 = _mm256_shuffle_ps(XY23, Size23, _MM_SHUFFLE(3, 2, 3, 2));
+
+        if (Stride == sizeof(instance_transform))
+        {
+            f32 *Destination = (f32 *)(Transforms + Index);
+
+            _mm256_storeu_ps(Destination + 0, _mm256_permute2f128_ps(Instances04, Instances15, 0x20));
+            _mm256_storeu_ps(Destination + 8, _mm256_permute2f128_ps(Instances26, Instances37, 0x20));
+            _mm256_storeu_ps(Destination + 16, _mm256_permute2f128_ps(Instances04, Instances15, 0x31));
+            _mm256_storeu_ps(Destination + 24, _mm256_permute2f128_ps(Instances26, Instances37, 0x31));
+        }
+        else
+        {
+            __m128 Instances[8] =
+            {
+                _mm256_castps256_ps128(Instances04),
+                _mm256_castps256_ps128(Instances15),
+                _mm256_castps256_ps128(Instances26),
+                _mm256_castps256_ps128(Instances37),
+                _mm256_extractf128_ps(Instances04, 1),
+                _mm256_extractf128_ps(Instances15, 1),
+                _mm256_extractf128_ps(Instances26, 1),
+                _mm256_extractf128_ps(Instances37, 1)
+            };
+
+            for (u32 Lane = 0; Lane < 8; ++Lane)
+            {
+                _mm_storeu_ps((f32 *)GetInstanceTransform(Transforms, Stride, Index + Lane), Instances[Lane]);
+            }
+        }
+    }
+
+    BuildInstanceTransformsScalar(
+        Count - Index, X + Index, Y + Index, Width + Index, Height + Index,
+        GetInstanceTransform(Transforms, Stride, Index), Stride
+    );
+}
+#endif
+
+inline void
+BuildInstanceTransforms(
+    u32 Count, f32 *X, f32 *Y, f32 *Width, f32 *Height, 
+    instance_transform *Transforms, memory_index Stride = sizeof(instance_transform)
+)
+{
+#if FUZZY_AVX2
+    if (SimdHasAVX2)
+    {
+        BuildInstanceTransformsAVX2(Count, X, Y, Width, Height, Transforms, Stride);
+        return;
+    }
+#endif
+
+#if FUZZY_SSE2
+    BuildInstanceTransformsSSE2(Count, X, Y, Width, Height, Transforms, Stride);
+#else
+    BuildInstanceTransformsScalar(Count, X, Y, Width, Height, Transforms, Stride);
+#endif
+}
+#pragma endregion
@@ -1,5 +1,9 @@
 #pragma once
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 constexpr u64 
 Kilobytes(u64 bytes)
 {
@@ -28,35 +32,298 @@ Terabytes(u64 bytes)
     return Result;
 }
 
+// note: commit granularity for growable arenas, pages are committed in chunks of this size as the arena grows
+#define MEMORY_COMMIT_GRANULARITY Kilobytes(64)
+
+#define CACHE_LINE_SIZE 64
+
+#define PLATFORM_COMMIT_MEMORY(name) b32 name(void *Base, memory_index Size)
+typedef PLATFORM_COMMIT_MEMORY(platform_commit_memory);
+
+enum memory_tag
+{
+    MEMORY_TAG_UNTAGGED,
+    MEMORY_TAG_TILEMAP,
+    MEMORY_TAG_SHADERS,
+    MEMORY_TAG_ANIMATIONS,
+    MEMORY_TAG_INSTANCES,
+    MEMORY_TAG_FONTS,
+    MEMORY_TAG_ENTITIES,
+    MEMORY_TAG_RENDERER,
+    MEMORY_TAG_COLLISION,
+    MEMORY_TAG_EVENTS,
+    MEMORY_TAG_DEBUG,
+    MEMORY_TAG_SUB_ARENAS,
+    MEMORY_TAG_SCRATCH,
+    MEMORY_TAG_SNAPSHOTS,
+    MEMORY_TAG_STAGING,
+    MEMORY_TAG_STRINGS,
+
+    MEMORY_TAG_COUNT
+};
+
+struct memory_stats
+{
+    memory_index Used;
+    memory_index HighWaterMark;
+    u32 AllocationCount;
+};
+
 struct memory_arena
 {
+    // note: for growable arenas Size is the reserved address range, only CommittedSize bytes of it are backed by memory
     memory_index Size;
+    memory_index CommittedSize;
 
     memory_index Used;
     void *Base;
+
+    platform_commit_memory *CommitMemory;
+
+    memory_stats Stats;
+    memory_stats TagStats[MEMORY_TAG_COUNT];
 };
 
 struct temporary_memory
 {
     memory_arena *Arena;
     memory_index Used;
+
+    memory_stats Stats;
+    memory_stats TagStats[MEMORY_TAG_COUNT];
 };
 
+inline const char *
+GetMemoryTagName(memory_tag Tag)
+{
+    const char *Result = "unknown";
+
+    switch (Tag)
+    {
+    case MEMORY_TAG_UNTAGGED:
+        Result = "untagged";
+        break;
+    case MEMORY_TAG_TILEMAP:
+        Result = "tilemap";
+        break;
+    case MEMORY_TAG_SHADERS:
+        Result = "shaders";
+        break;
+    case MEMORY_TAG_ANIMATIONS:
+        Result = "animations";
+        break;
+    case MEMORY_TAG_INSTANCES:
+        Result = "instances";
+        break;
+    case MEMORY_TAG_FONTS:
+        Result = "fonts";
+        break;
+    case MEMORY_TAG_ENTITIES:
+        Result = "entities";
+        break;
+    case MEMORY_TAG_RENDERER:
+        Result = "renderer";
+        break;
+    case MEMORY_TAG_COLLISION:
+        Result = "collision";
+        break;
+    case MEMORY_TAG_EVENTS:
+        Result = "events";
+        break;
+    case MEMORY_TAG_DEBUG:
+        Result = "debug";
+        break;
+    case MEMORY_TAG_SUB_ARENAS:
+        Result = "sub-arenas";
+        break;
+    case MEMORY_TAG_SCRATCH:
+        Result = "scratch";
+        break;
+    case MEMORY_TAG_SNAPSHOTS:
+        Result = "snapshots";
+        break;
+    case MEMORY_TAG_STAGING:
+        Result = "staging";
+        break;
+    case MEMORY_TAG_STRINGS:
+        Result = "strings";
+        break;
+    default:
+        break;
+    }
+
+    return Result;
+}
+
 inline void 
 InitializeMemoryArena(memory_arena *Arena, memory_index Size, void *Base)
 {
+    *Arena = {};
     Arena->Size = Size;
+    Arena->CommittedSize = Size;
     Arena->Base = Base;
     Arena->Used = 0;
 }
 
+inline void
+InitializeGrowableMemoryArena(
+    memory_arena *Arena, 
+    memory_index ReservedSize, 
+    void *Base, 
+    memory_index CommittedSize, 
+    platform_commit_memory *CommitMemory
+)
+{
+    Assert(CommittedSize <= ReservedSize);
+
+    InitializeMemoryArena(Arena, ReservedSize, Base);
+    Arena->CommittedSize = CommittedSize;
+    Arena->CommitMemory = CommitMemory;
+}
+
+inline memory_index
+AlignUp(memory_index Value, memory_index Alignment)
+{
+    memory_index Result = (Value + Alignment - 1) & ~(Alignment - 1);
+    return Result;
+}
+
+inline memory_index
+AlignDown(memory_index Value, memory_index Alignment)
+{
+    memory_index Result = Value & ~(Alignment - 1);
+    return Result;
+}
+
+// note: commits pages covering [Used, Used + Size), ranges skipped over by sub-arenas are committed by the sub-arenas themselves
+inline void
+EnsureCommitted(memory_arena *Arena, memory_index Size)
+{
+    memory_index NewUsed = Arena->Used + Size;
+
+    if (NewUsed > Arena->CommittedSize)
+    {
+        Assert(Arena->CommitMemory);
+
+        memory_index CommitStart = AlignDown(Arena->Used, MEMORY_COMMIT_GRANULARITY);
+        if (CommitStart < Arena->CommittedSize)
+        {
+            CommitStart = Arena->CommittedSize;
+        }
+
+        memory_index CommitEnd = AlignUp(NewUsed, MEMORY_COMMIT_GRANULARITY);
+        if (CommitEnd > Arena->Size)
+        {
+            CommitEnd = Arena->Size;
+        }
+
+        b32 Committed = Arena->CommitMemory((u8*)Arena->Base + CommitStart, CommitEnd - CommitStart);
+        Assert(Committed);
+
+        Arena->CommittedSize = CommitEnd;
+    }
+}
+
+// note: high-water marks survive resets, live usage and allocation counts don't
+inline void
+RestoreMemoryStats(memory_stats *Stats, memory_stats *Saved)
+{
+    Stats->Used = Saved->Used;
+    Stats->AllocationCount = Saved->AllocationCount;
+}
+
+inline void
+ClearMemoryArena(memory_arena *Arena)
+{
+    memory_stats Empty = {};
+
+    Arena->Used = 0;
+    RestoreMemoryStats(&Arena->Stats, &Empty);
+
+    for (u32 TagIndex = 0; TagIndex < MEMORY_TAG_COUNT; ++TagIndex)
+    {
+        RestoreMemoryStats(Arena->TagStats + TagIndex, &Empty);
+    }
+}
+
+inline void
+RecordAllocation(memory_stats *Stats, memory_index Size)
+{
+    Stats->Used += Size;
+    ++Stats->AllocationCount;
+
+    if (Stats->Used > Stats->HighWaterMark)
+    {
+        Stats->HighWaterMark = Stats->Used;
+    }
+}
+
+inline memory_index
+GetAlignmentOffset(memory_arena *Arena, memory_index Alignment)
+{
+    Assert((Alignment & (Alignment - 1)) == 0);
+
+    memory_index ResultPointer = (memory_index)Arena->Base + Arena->Used;
+    memory_index Result = AlignUp(ResultPointer, Alignment) - ResultPointer;
+
+    return Result;
+}
+
+inline void *
+PushSize(memory_arena *Arena, memory_index Size, memory_tag Tag = MEMORY_TAG_UNTAGGED, memory_index Alignment = 1)
+{
+    memory_index AlignmentOffset = GetAlignmentOffset(Arena, Alignment);
+    memory_index EffectiveSize = Size + AlignmentOffset;
+
+    Assert((Arena->Used + EffectiveSize) <= Arena->Size);
+    EnsureCommitted(Arena, EffectiveSize);
+
+    void *Result = (u8*)Arena->Base + Arena->Used + AlignmentOffset;
+    Arena->Used += EffectiveSize;
+
+    // note: padding is accounted to the allocation so that stats always add up to Used
+    RecordAllocation(&Arena->Stats, EffectiveSize);
+    RecordAllocation(Arena->TagStats + Tag, EffectiveSize);
+
+    return Result;
+}
+
+template<typename T>
+inline T * 
+PushStruct(memory_arena *Arena, memory_tag Tag = MEMORY_TAG_UNTAGGED, memory_index Alignment = alignof(T))
+{
+    T *Result = (T*)PushSize(Arena, sizeof(T), Tag, Alignment);
+    return Result;
+}
+
+template<typename T>
+inline T *
+PushArray(memory_arena *Arena, u32 Count, memory_tag Tag = MEMORY_TAG_UNTAGGED, memory_index Alignment = alignof(T))
+{
+    T *Result = (T*)PushSize(Arena, Count * sizeof(T), Tag, Alignment);
+    return Result;
+}
+
 inline temporary_memory
-BeginTemporaryMemory(memory_arena *Arena)
+BeginTemporaryMemory(memory_arena *Arena, memory_index Alignment = 1)
 {
     temporary_memory Result = {};
     Result.Arena = Arena;
     Result.Used = Arena->Used;
 
+    Result.Stats = Arena->Stats;
+    for (u32 TagIndex = 0; TagIndex < MEMORY_TAG_COUNT; ++TagIndex)
+    {
+        Result.TagStats[TagIndex] = Arena->TagStats[TagIndex];
+    }
+
+    // note: padding goes after the snapshot, so EndTemporaryMemory gives it back as well
+    memory_index AlignmentOffset = GetAlignmentOffset(Arena, Alignment);
+    if (AlignmentOffset > 0)
+    {
+        PushSize(Arena, AlignmentOffset, MEMORY_TAG_SCRATCH);
+    }
+
     return Result;
 }
 
@@ -65,38 +332,453 @@ EndTemporaryMemory(temporary_memory TempMemory)
 {
     memory_arena *Arena = TempMemory.Arena;
     Arena->Used = TempMemory.Used;
+
+    RestoreMemoryStats(&Arena->Stats, &TempMemory.Stats);
+    for (u32 TagIndex = 0; TagIndex < MEMORY_TAG_COUNT; ++TagIndex)
+    {
+        RestoreMemoryStats(Arena->TagStats + TagIndex, TempMemory.TagStats + TagIndex);
+    }
 }
 
-inline void *
-PushSize(memory_arena *Arena, memory_index Size)
+inline char *
+PushString(memory_arena* Arena, u32 StringLength, memory_tag Tag = MEMORY_TAG_UNTAGGED)
 {
-    Assert((Arena->Used + Size) <= Arena->Size);
+    char* Result = PushArray<char>(Arena, StringLength, Tag);
+    return Result;
+}
+
+inline void
+InitializeSubArena(memory_arena *SubArena, memory_arena *Arena, memory_index Size, memory_index Alignment = CACHE_LINE_SIZE)
+{
+    memory_index AlignmentOffset = GetAlignmentOffset(Arena, Alignment);
+    memory_index EffectiveSize = Size + AlignmentOffset;
+
+    Assert((Arena->Used + EffectiveSize) <= Arena->Size);
+
+    void *Base = (u8*)Arena->Base + Arena->Used + AlignmentOffset;
+    Arena->Used += EffectiveSize;
+
+    RecordAllocation(&Arena->Stats, EffectiveSize);
+    RecordAllocation(Arena->TagStats + MEMORY_TAG_SUB_ARENAS, EffectiveSize);
+
+    if (Arena->CommitMemory)
+    {
+        // note: sub-arena of a growable arena commits its own pages on demand
+        InitializeGrowableMemoryArena(SubArena, Size, Base, 0, Arena->CommitMemory);
+    }
+    else
+    {
+        InitializeMemoryArena(SubArena, Size, Base);
+    }
+}
+
+inline char *
+PushStringCopy(memory_arena *Arena, const char *Source, memory_tag Tag = MEMORY_TAG_UNTAGGED)
+{
+    u32 Length = 0;
+    while (Source[Length])
+    {
+        ++Length;
+    }
+
+    char *Result = PushString(Arena, Length + 1, Tag);
+    for (u32 Index = 0; Index <= Length; ++Index)
+    {
+        Result[Index] = Source[Index];
+    }
+
+    return Result;
+}
+
+inline u32
+FindLeastSignificantSetBit(u64 Value)
+{
+    Assert(Value != 0);
 
-    void *Result = (u8*)Arena->Base + Arena->Used;
-    Arena->Used += Size;
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanForward64(&Index, Value);
+    u32 Result = (u32)Index;
+#else
+    u32 Result = (u32)__builtin_ctzll(Value);
+#endif
 
     return Result;
 }
 
+#pragma region Pool
+
 template<typename T>
-inline T * 
-PushStruct(memory_arena *Arena)
+struct memory_pool_block;
+
+template<typename T>
+struct memory_pool_slot
 {
-    T *Result = (T*)PushSize(Arena, sizeof(T));
+    // note: Value has to stay first, slot pointers and value pointers are interchangeable
+    union
+    {
+        T Value;
+        memory_pool_slot<T> *NextFree;
+    };
+
+    memory_pool_block<T> *Block;
+};
+
+template<typename T>
+struct memory_pool_block
+{
+    memory_pool_slot<T> *Slots;
+    // note: one bit per slot, only allocated if the pool tracks occupancy
+    u64 *Occupancy;
+
+    memory_pool_block<T> *Next;
+};
+
+// note: fixed-size slots carved out of arena blocks, freed slots go to an intrusive free list and are reused before the pool grows
+template<typename T>
+struct memory_pool
+{
+    memory_arena *Arena;
+    memory_tag Tag;
+
+    u32 SlotsPerBlock;
+    b32 TrackOccupancy;
+
+    memory_pool_block<T> *FirstBlock;
+    memory_pool_slot<T> *FirstFree;
+
+    u32 BlockCount;
+    u32 LiveCount;
+};
+
+template<typename T>
+struct memory_pool_iterator
+{
+    memory_pool_block<T> *Block;
+    u32 WordIndex;
+    u64 RemainingBits;
+};
+
+template<typename T>
+inline void
+InitializeMemoryPool(
+    memory_pool<T> *Pool, 
+    memory_arena *Arena, 
+    u32 SlotsPerBlock, 
+    b32 TrackOccupancy = false, 
+    memory_tag Tag = MEMORY_TAG_UNTAGGED
+)
+{
+    Assert(SlotsPerBlock > 0);
+
+    *Pool = {};
+    Pool->Arena = Arena;
+    Pool->Tag = Tag;
+    Pool->SlotsPerBlock = SlotsPerBlock;
+    Pool->TrackOccupancy = TrackOccupancy;
+}
+
+template<typename T>
+inline u32
+GetOccupancyWordCount(memory_pool<T> *Pool)
+{
+    u32 Result = (Pool->SlotsPerBlock + 63) / 64;
     return Result;
 }
 
+template<typename T>
+internal void
+GrowMemoryPool(memory_pool<T> *Pool)
+{
+    memory_pool_block<T> *Block = PushStruct<memory_pool_block<T>>(Pool->Arena, Pool->Tag);
+    Block->Slots = PushArray<memory_pool_slot<T>>(Pool->Arena, Pool->SlotsPerBlock, Pool->Tag, CACHE_LINE_SIZE);
+    Block->Occupancy = nullptr;
+
+    if (Pool->TrackOccupancy)
+    {
+        u32 WordCount = GetOccupancyWordCount(Pool);
+        Block->Occupancy = PushArray<u64>(Pool->Arena, WordCount, Pool->Tag);
+
+        for (u32 WordIndex = 0; WordIndex < WordCount; ++WordIndex)
+        {
+            Block->Occupancy[WordIndex] = 0;
+        }
+    }
+
+    // note: thread slots in reverse so that allocations walk the block front to back
+    for (i32 SlotIndex = Pool->SlotsPerBlock - 1; SlotIndex >= 0; --SlotIndex)
+    {
+        memory_pool_slot<T> *Slot = Block->Slots + SlotIndex;
+        Slot->Block = Block;
+        Slot->NextFree = Pool->FirstFree;
+        Pool->FirstFree = Slot;
+    }
+
+    Block->Next = Pool->FirstBlock;
+    Pool->FirstBlock = Block;
+    ++Pool->BlockCount;
+}
+
+template<typename T>
+inline void
+SetSlotOccupancy(memory_pool_slot<T> *Slot, b32 Occupied)
+{
+    memory_pool_block<T> *Block = Slot->Block;
+    u32 SlotIndex = (u32)(Slot - Block->Slots);
+    u64 Mask = (u64)1 << (SlotIndex % 64);
+
+    if (Occupied)
+    {
+        Block->Occupancy[SlotIndex / 64] |= Mask;
+    }
+    else
+    {
+        Block->Occupancy[SlotIndex / 64] &= ~Mask;
+    }
+}
+
+// note: returned memory is not cleared
 template<typename T>
 inline T *
-PushArray(memory_arena *Arena, u32 Count)
+PoolAlloc(memory_pool<T> *Pool)
 {
-    T *Result = (T*)PushSize(Arena, Count * sizeof(T));
+    if (!Pool->FirstFree)
+    {
+        GrowMemoryPool(Pool);
+    }
+
+    memory_pool_slot<T> *Slot = Pool->FirstFree;
+    Pool->FirstFree = Slot->NextFree;
+    ++Pool->LiveCount;
+
+    if (Pool->TrackOccupancy)
+    {
+        SetSlotOccupancy(Slot, true);
+    }
+
+    T *Result = &Slot->Value;
     return Result;
 }
 
-inline char *
-PushString(memory_arena* Arena, u32 StringLength)
+template<typename T>
+inline void
+PoolFree(memory_pool<T> *Pool, T *Value)
+{
+    Assert(Value);
+    Assert(Pool->LiveCount > 0);
+
+    memory_pool_slot<T> *Slot = (memory_pool_slot<T> *)Value;
+
+    if (Pool->TrackOccupancy)
+    {
+        SetSlotOccupancy(Slot, false);
+    }
+
+    Slot->NextFree = Pool->FirstFree;
+    Pool->FirstFree = Slot;
+    --Pool->LiveCount;
+}
+
+template<typename T>
+inline memory_pool_iterator<T>
+IterateMemoryPool(memory_pool<T> *Pool)
+{
+    Assert(Pool->TrackOccupancy);
+
+    memory_pool_iterator<T> Result = {};
+    Result.Block = Pool->FirstBlock;
+    Result.WordIndex = 0;
+    Result.RemainingBits = Result.Block ? Result.Block->Occupancy[0] : 0;
+
+    return Result;
+}
+
+// note: skips free slots a whole word at a time, returns nullptr once every block has been visited
+template<typename T>
+inline T *
+NextPoolValue(memory_pool<T> *Pool, memory_pool_iterator<T> *Iterator)
+{
+    T *Result = nullptr;
+    u32 WordCount = GetOccupancyWordCount(Pool);
+
+    while (Iterator->Block && !Iterator->RemainingBits)
+    {
+        ++Iterator->WordIndex;
+
+        if (Iterator->WordIndex == WordCount)
+        {
+            Iterator->Block = Iterator->Block->Next;
+            Iterator->WordIndex = 0;
+        }
+
+        if (Iterator->Block)
+        {
+            Iterator->RemainingBits = Iterator->Block->Occupancy[Iterator->WordIndex];
+        }
+    }
+
+    if (Iterator->Block)
+    {
+        u32 BitIndex = FindLeastSignificantSetBit(Iterator->RemainingBits);
+        Iterator->RemainingBits &= Iterator->RemainingBits - 1;
+
+        Result = &Iterator->Block->Slots[Iterator->WordIndex * 64 + BitIndex].Value;
+    }
+
+    return Result;
+}
+
+#pragma endregion
+
+#pragma region Ring
+
+#define RING_ARENA_MAX_FRAME_LIFETIME 16
+// note: one extra slot for the frame that is currently being filled
+#define RING_ARENA_FRAME_SLOTS (RING_ARENA_MAX_FRAME_LIFETIME + 1)
+
+struct ring_arena_frame
+{
+    u64 FrameIndex;
+    // note: bytes taken by the frame including padding and space skipped when wrapping
+    memory_index Consumed;
+    memory_index End;
+};
+
+// note: allocations made during a frame are released all at once FrameLifetime frames later
+struct ring_arena
+{
+    memory_index Size;
+    u8 *Base;
+
+    memory_index Head;
+    memory_index Tail;
+    memory_index Used;
+
+    u32 FrameLifetime;
+    u64 CurrentFrame;
+
+    u32 FirstFrame;
+    u32 FrameCount;
+    ring_arena_frame Frames[RING_ARENA_FRAME_SLOTS];
+
+    memory_stats Stats;
+    u32 OverflowCount;
+};
+
+inline void
+InitializeRingArena(ring_arena *Ring, memory_arena *Arena, memory_index Size, u32 FrameLifetime, memory_tag Tag = MEMORY_TAG_UNTAGGED)
+{
+    Assert(FrameLifetime > 0 && FrameLifetime <= RING_ARENA_MAX_FRAME_LIFETIME);
+
+    *Ring = {};
+    Ring->Size = Size;
+    Ring->Base = (u8 *)PushSize(Arena, Size, Tag, CACHE_LINE_SIZE);
+    Ring->FrameLifetime = FrameLifetime;
+}
+
+inline ring_arena_frame *
+GetRingArenaFrame(ring_arena *Ring, u32 Index)
+{
+    Assert(Index < Ring->FrameCount);
+
+    ring_arena_frame *Result = Ring->Frames + (Ring->FirstFrame + Index) % RING_ARENA_FRAME_SLOTS;
+    return Result;
+}
+
+// note: call once per frame before any ring allocations, retires frames that are FrameLifetime frames old
+inline void
+BeginRingArenaFrame(ring_arena *Ring)
+{
+    ++Ring->CurrentFrame;
+
+    while (Ring->FrameCount > 0 && GetRingArenaFrame(Ring, 0)->FrameIndex + Ring->FrameLifetime <= Ring->CurrentFrame)
+    {
+        ring_arena_frame *Frame = GetRingArenaFrame(Ring, 0);
+
+        Ring->Used -= Frame->Consumed;
+        Ring->Tail = Frame->End;
+
+        Ring->FirstFrame = (Ring->FirstFrame + 1) % RING_ARENA_FRAME_SLOTS;
+        --Ring->FrameCount;
+    }
+
+    if (Ring->Used == 0)
+    {
+        Ring->Head = 0;
+        Ring->Tail = 0;
+    }
+
+    Assert(Ring->FrameCount < RING_ARENA_FRAME_SLOTS);
+
+    ring_arena_frame *Frame = Ring->Frames + (Ring->FirstFrame + Ring->FrameCount) % RING_ARENA_FRAME_SLOTS;
+    Frame->FrameIndex = Ring->CurrentFrame;
+    Frame->Consumed = 0;
+    Frame->End = Ring->Head;
+    ++Ring->FrameCount;
+
+    Ring->Stats.Used = Ring->Used;
+    Ring->Stats.AllocationCount = 0;
+}
+
+// note: returns nullptr and counts an overflow when there is no room left, the caller decides whether to drop or retry
+inline void *
+PushRingSize(ring_arena *Ring, memory_index Size, memory_index Alignment = 1)
+{
+    Assert(Ring->FrameCount > 0);
+    Assert((Alignment & (Alignment - 1)) == 0);
+
+    void *Result = nullptr;
+
+    memory_index Start = AlignUp((memory_index)Ring->Base + Ring->Head, Alignment) - (memory_index)Ring->Base;
+    memory_index Skipped = Start - Ring->Head;
+
+    // note: live data is [Tail, Head) when Head is ahead of Tail, otherwise it wraps around the end
+    b32 IsWrapped = Ring->Head < Ring->Tail || (Ring->Head == Ring->Tail && Ring->Used > 0);
+
+    if (IsWrapped)
+    {
+        if (Start + Size > Ring->Tail)
+        {
+            Start = Ring->Size;
+        }
+    }
+    else if (Start + Size > Ring->Size)
+    {
+        // note: doesn't fit before the end, skip the rest and try from the beginning
+        memory_index WrappedStart = AlignUp((memory_index)Ring->Base, Alignment) - (memory_index)Ring->Base;
+
+        Skipped = Ring->Size - Ring->Head + WrappedStart;
+        Start = (WrappedStart + Size <= Ring->Tail) ? WrappedStart : Ring->Size;
+    }
+
+    if (Start < Ring->Size)
+    {
+        Result = Ring->Base + Start;
+
+        memory_index Consumed = Skipped + Size;
+        Ring->Head = Start + Size;
+        Ring->Used += Consumed;
+
+        ring_arena_frame *Frame = GetRingArenaFrame(Ring, Ring->FrameCount - 1);
+        Frame->Consumed += Consumed;
+        Frame->End = Ring->Head;
+
+        RecordAllocation(&Ring->Stats, Consumed);
+    }
+    else
+    {
+        ++Ring->OverflowCount;
+    }
+
+    return Result;
+}
+
+template<typename T>
+inline T *
+PushRingArray(ring_arena *Ring, u32 Count, memory_index Alignment = alignof(T))
 {
-    char* Result = PushArray<char>(Arena, StringLength);
+    T *Result = (T *)PushRingSize(Ring, Count * sizeof(T), Alignment);
     return Result;
 }
+
+#pragma endregion
@@ -0,0 +1,1180 @@
+#include "fuzzy_physics.h"
+
+inline b32
+IntersectAABB(const sim_aabb& Box1, const sim_aabb& Box2)
+{
+    // Separating Axis Theorem
+    b32 XCollision = Box1.Position.x + Box1.Size.x > Box2.Position.x && Box1.Position.x < Box2.Position.x + Box2.Size.x;
+    b32 YCollision = Box1.Position.y + Box1.Size.y > Box2.Position.y && Box1.Position.y < Box2.Position.y + Box2.Size.y;
+
+    return XCollision && YCollision;
+}
+
+// basic Minkowski-based collision detection
+// note: Min is the box's min corner already padded by the moving box's size, Max its unpadded max corner
+inline sim_vec2
+SweptMinMax(const sim_vec2 Point, const sim_vec2 Delta, sim_f32 MinX, sim_f32 MinY, sim_f32 MaxX, sim_f32 MaxY)
+{
+    sim_f32 Zero = SimScalar(0.f);
+    sim_vec2 Time = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+    if (Delta.x != Zero && MinY < Point.y && Point.y < MaxY)
+    {
+        sim_f32 LeftTime = (MinX - Point.x) / Delta.x;
+        if (LeftTime < Time.x)
+        {
+            Time.x = LeftTime;
+        }
+
+        sim_f32 RightTime = (MaxX - Point.x) / Delta.x;
+        if (RightTime < Time.x)
+        {
+            Time.x = RightTime;
+        }
+    }
+
+    if (Delta.y != Zero && MinX < Point.x && Point.x < MaxX)
+    {
+        sim_f32 TopTime = (MinY - Point.y) / Delta.y;
+        if (TopTime < Time.y)
+        {
+            Time.y = TopTime;
+        }
+
+        sim_f32 BottomTime = (MaxY - Point.y) / Delta.y;
+        if (BottomTime < Time.y)
+        {
+            Time.y = BottomTime;
+        }
+    }
+
+    return Time;
+}
+
+internal sim_vec2
+SweptAABB(const sim_vec2 Point, const sim_vec2 Delta, const sim_aabb& Box, const sim_vec2 Padding)
+{
+    sim_vec2 Result = SweptMinMax(Point, Delta,
+        Box.Position.x - Padding.x, Box.Position.y - Padding.y,
+        Box.Position.x + Box.Size.x, Box.Position.y + Box.Size.y);
+
+    return Result;
+}
+
+// note: the scalar caller's rule, only hits in front of the box and earlier than the current one count
+inline void
+AccumulateCollisionTime(sim_vec2 Time, sim_vec2 *CollisionTime)
+{
+    sim_f32 Zero = SimScalar(0.f);
+
+    if (Time.x >= Zero && Time.x < CollisionTime->x)
+    {
+        CollisionTime->x = Time.x;
+    }
+    if (Time.y >= Zero && Time.y < CollisionTime->y)
+    {
+        CollisionTime->y = Time.y;
+    }
+}
+
+internal void
+InitializeBoxSoa(box_soa *Boxes, u32 MaxCount, memory_arena *Arena)
+{
+    Boxes->Count = 0;
+
+    // note: rounded up to a whole avx register, so the kernels can read a full register past the last box
+    u32 PaddedCount = (MaxCount + 7) & ~7u;
+
+    Boxes->MinX = PushArray<sim_f32>(Arena, PaddedCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    Boxes->MinY = PushArray<sim_f32>(Arena, PaddedCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    Boxes->MaxX = PushArray<sim_f32>(Arena, PaddedCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    Boxes->MaxY = PushArray<sim_f32>(Arena, PaddedCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+}
+
+inline void
+SetBoxSoa(box_soa *Boxes, u32 Index, sim_aabb *Box)
+{
+    Boxes->MinX[Index] = Box->Position.x;
+    Boxes->MinY[Index] = Box->Position.y;
+    Boxes->MaxX[Index] = Box->Position.x + Box->Size.x;
+    Boxes->MaxY[Index] = Box->Position.y + Box->Size.y;
+}
+
+internal void
+SweepBoxSoaScalar(sim_vec2 Point, sim_vec2 Delta, sim_vec2 Padding, box_soa *Boxes, u32 First, sim_vec2 *CollisionTime)
+{
+    for (u32 Index = First; Index < Boxes->Count; ++Index)
+    {
+        sim_vec2 Time = SweptMinMax(Point, Delta,
+            Boxes->MinX[Index] - Padding.x, Boxes->MinY[Index] - Padding.y, Boxes->MaxX[Index], Boxes->MaxY[Index]);
+
+        AccumulateCollisionTime(Time, CollisionTime);
+    }
+}
+
+// note: the simd kernels are f32 only, q16.16 division has no vector form that rounds like the scalar one
+#if !FUZZY_FIXED_POINT && FUZZY_SSE2
+inline __m128
+Select4(__m128 Mask, __m128 A, __m128 B)
+{
+    __m128 Result = _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B));
+    return Result;
+}
+
+// note: every lane keeps its own running minimum with the scalar rule, the lanes are folded the same way at the end
+internal void
+SweepBoxSoaSSE2(sim_vec2 Point, sim_vec2 Delta, sim_vec2 Padding, box_soa *Boxes, sim_vec2 *CollisionTime)
+{
+    __m128 Zero = _mm_setzero_ps();
+    __m128 One = _mm_set1_ps(1.f);
+
+    __m128 PointX = _mm_set1_ps(Point.x);
+    __m128 PointY = _mm_set1_ps(Point.y);
+    __m128 DeltaX = _mm_set1_ps(Delta.x);
+    __m128 DeltaY = _mm_set1_ps(Delta.y);
+    __m128 PaddingX = _mm_set1_ps(Padding.x);
+    __m128 PaddingY = _mm_set1_ps(Padding.y);
+
+    __m128 MovesX = _mm_cmpneq_ps(DeltaX, Zero);
+    __m128 MovesY = _mm_cmpneq_ps(DeltaY, Zero);
+
+    __m128 CollisionTimeX = _mm_set1_ps(CollisionTime->x);
+    __m128 CollisionTimeY = _mm_set1_ps(CollisionTime->y);
+
+    u32 Index = 0;
+    for (; Index + 4 <= Boxes->Count; Index += 4)
+    {
+        __m128 MinX = _mm_sub_ps(_mm_load_ps(Boxes->MinX + Index), PaddingX);
+        __m128 MinY = _mm_sub_ps(_mm_load_ps(Boxes->MinY + Index), PaddingY);
+        __m128 MaxX = _mm_load_ps(Boxes->MaxX + Index);
+        __m128 MaxY = _mm_load_ps(Boxes->MaxY + Index);
+
+        // note: _mm_min_ps(A, B) is A < B ? A : B, the same comparison as the scalar ifs
+        __m128 HitsX = _mm_and_ps(MovesX, _mm_and_ps(_mm_cmplt_ps(MinY, PointY), _mm_cmplt_ps(PointY, MaxY)));
+        __m128 TimeX = _mm_min_ps(_mm_div_ps(_mm_sub_ps(MinX, PointX), DeltaX), One);
+        TimeX = _mm_min_ps(_mm_div_ps(_mm_sub_ps(MaxX, PointX), DeltaX), TimeX);
+        TimeX = Select4(HitsX, TimeX, One);
+
+        __m128 HitsY = _mm_and_ps(MovesY, _mm_and_ps(_mm_cmplt_ps(MinX, PointX), _mm_cmplt_ps(PointX, MaxX)));
+        __m128 TimeY = _mm_min_ps(_mm_div_ps(_mm_sub_ps(MinY, PointY), DeltaY), One);
+        TimeY = _mm_min_ps(_mm_div_ps(_mm_sub_ps(MaxY, PointY), DeltaY), TimeY);
+        TimeY = Select4(HitsY, TimeY, One);
+
+        __m128 TakeX = _mm_and_ps(_mm_cmpge_ps(TimeX, Zero), _mm_cmplt_ps(TimeX, CollisionTimeX));
+        __m128 TakeY = _mm_and_ps(_mm_cmpge_ps(TimeY, Zero), _mm_cmplt_ps(TimeY, CollisionTimeY));
+
+        CollisionTimeX = Select4(TakeX, TimeX, CollisionTimeX);
+        CollisionTimeY = Select4(TakeY, TimeY, CollisionTimeY);
+    }
+
+    f32 LaneTimesX[4];
+    f32 LaneTimesY[4];
+    _mm_storeu_ps(LaneTimesX, CollisionTimeX);
+    _mm_storeu_ps(LaneTimesY, CollisionTimeY);
+
+    for (u32 Lane = 0; Lane < 4; ++Lane)
+    {
+        AccumulateCollisionTime(vec2(LaneTimesX[Lane], LaneTimesY[Lane]), CollisionTime);
+    }
+
+    SweepBoxSoaScalar(Point, Delta, Padding, Boxes, Index, CollisionTime);
+}
+#endif
+
+#if !FUZZY_FIXED_POINT && FUZZY_AVX2
+inline FUZZY_AVX2_TARGET __m256
+Select8(__m256 Mask, __m256 A, __m256 B)
+{
+    __m256 Result = _mm256_blendv_ps(B, A, Mask);
+    return Result;
+}
+
+internal FUZZY_AVX2_TARGET void
+SweepBoxSoaAVX2(sim_vec2 Point, sim_vec2 Delta, sim_vec2 Padding, box_soa *Boxes, sim_vec2 *CollisionTime)
+{
+    __m256 Zero = _mm256_setzero_ps();
+    __m256 One = _mm256_set1_ps(1.f);
+
+    __m256 PointX = _mm256_set1_ps(Point.x);
+    __m256 PointY = _mm256_set1_ps(Point.y);
+    __m256 DeltaX = _mm256_set1_ps(Delta.x);
+    __m256 DeltaY = _mm256_set1_ps(Delta.y);
+    __m256 PaddingX = _mm256_set1_ps(Padding.x);
+    __m256 PaddingY = _mm256_set1_ps(Padding.y);
+
+    __m256 MovesX = _mm256_cmp_ps(DeltaX, Zero, _CMP_NEQ_UQ);
+    __m256 MovesY = _mm256_cmp_ps(DeltaY, Zero, _CMP_NEQ_UQ);
+
+    __m256 CollisionTimeX = _mm256_set1_ps(CollisionTime->x);
+    __m256 CollisionTimeY = _mm256_set1_ps(CollisionTime->y);
+
+    u32 Index = 0;
+    for (; Index + 8 <= Boxes->Count; Index += 8)
+    {
+        __m256 MinX = _mm256_sub_ps(_mm256_load_ps(Boxes->MinX + Index), PaddingX);
+        __m256 MinY = _mm256_sub_ps(_mm256_load_ps(Boxes->MinY + Index), PaddingY);
+        __m256 MaxX = _mm256_load_ps(Boxes->MaxX + Index);
+        __m256 MaxY = _mm256_load_ps(Boxes->MaxY + Index);
+
+        __m256 HitsX = _mm256_and_ps(MovesX,
+            _mm256_and_ps(_mm256_cmp_ps(MinY, PointY, _CMP_LT_OQ), _mm256_cmp_ps(PointY, MaxY, _CMP_LT_OQ)));
+        __m256 TimeX = _mm256_min_ps(_mm256_div_ps(_mm256_sub_ps(MinX, PointX), DeltaX), One);
+        TimeX = _mm256_min_ps(_mm256_div_ps(_mm256_sub_ps(MaxX, PointX), DeltaX), TimeX);
+        TimeX = Select8(HitsX, TimeX, One);
+
+        __m256 HitsY = _mm256_and_ps(MovesY,
+            _mm256_and_ps(_mm256_cmp_ps(MinX, PointX, _CMP_LT_OQ), _mm256_cmp_ps(PointX, MaxX, _CMP_LT_OQ)));
+        __m256 TimeY = _mm256_min_ps(_mm256_div_ps(_mm256_sub_ps(MinY, PointY), DeltaY), One);
+        TimeY = _mm256_min_ps(_mm256_div_ps(_mm256_sub_ps(MaxY, PointY), DeltaY), TimeY);
+        TimeY = Select8(HitsY, TimeY, One);
+
+        __m256 TakeX = _mm256_and_ps(_mm256_cmp_ps(TimeX, Zero, _CMP_GE_OQ), _mm256_cmp_ps(TimeX, CollisionTimeX, _CMP_LT_OQ));
+        __m256 TakeY = _mm256_and_ps(_mm256_cmp_ps(TimeY, Zero, _CMP_GE_OQ), _mm256_cmp_ps(TimeY, CollisionTimeY, _CMP_LT_OQ));
+
+        CollisionTimeX = Select8(TakeX, TimeX, CollisionTimeX);
+        CollisionTimeY = Select8(TakeY, TimeY, CollisionTimeY);
+    }
+
+    f32 LaneTimesX[8];
+    f32 LaneTimesY[8];
+    _mm256_storeu_ps(LaneTimesX, CollisionTimeX);
+    _mm256_storeu_ps(LaneTimesY, CollisionTimeY);
+
+    for (u32 Lane = 0; Lane < 8; ++Lane)
+    {
+        AccumulateCollisionTime(vec2(LaneTimesX[Lane], LaneTimesY[Lane]), CollisionTime);
+    }
+
+    SweepBoxSoaScalar(Point, Delta, Padding, Boxes, Index, CollisionTime);
+}
+#endif
+
+// note: collision times of a box at Point moving by Delta against all of Boxes, equal to calling SweptAABB box by box
+// (signed zeros aside, the lanes fold their minimums in a different order)
+inline void
+SweepBoxSoa(sim_vec2 Point, sim_vec2 Delta, sim_vec2 Padding, box_soa *Boxes, sim_vec2 *CollisionTime)
+{
+#if !FUZZY_FIXED_POINT && FUZZY_AVX2
+    if (SimdHasAVX2)
+    {
+        SweepBoxSoaAVX2(Point, Delta, Padding, Boxes, CollisionTime);
+        return;
+    }
+#endif
+
+#if !FUZZY_FIXED_POINT && FUZZY_SSE2
+    SweepBoxSoaSSE2(Point, Delta, Padding, Boxes, CollisionTime);
+#else
+    SweepBoxSoaScalar(Point, Delta, Padding, Boxes, 0, CollisionTime);
+#endif
+}
+
+inline void
+GetGridCellRange(box_grid *Grid, sim_vec2 Min, sim_vec2 Max, i32 *MinX, i32 *MinY, i32 *MaxX, i32 *MaxY)
+{
+    *MinX = SimFloorToI32((Min.x - Grid->Origin.x) / Grid->CellSize);
+    *MinY = SimFloorToI32((Min.y - Grid->Origin.y) / Grid->CellSize);
+    *MaxX = SimFloorToI32((Max.x - Grid->Origin.x) / Grid->CellSize);
+    *MaxY = SimFloorToI32((Max.y - Grid->Origin.y) / Grid->CellSize);
+
+    *MinX = *MinX < 0 ? 0 : *MinX;
+    *MinY = *MinY < 0 ? 0 : *MinY;
+    *MaxX = *MaxX >= Grid->CellCountX ? Grid->CellCountX - 1 : *MaxX;
+    *MaxY = *MaxY >= Grid->CellCountY ? Grid->CellCountY - 1 : *MaxY;
+}
+
+// note: built once, boxes that move later stay in the cells they started in
+internal void
+InitializeBoxGrid(box_grid *Grid, sim_aabb *Boxes, u32 BoxCount, sim_f32 CellSize, memory_arena *Arena)
+{
+    *Grid = {};
+
+    Grid->Boxes = Boxes;
+    Grid->BoxCount = BoxCount;
+    Grid->CellSize = CellSize;
+
+    sim_vec2 Min = BoxCount > 0 ? Boxes[0].Position : SimVec2(SimScalar(0.f), SimScalar(0.f));
+    sim_vec2 Max = BoxCount > 0 ? Boxes[0].Position + Boxes[0].Size : Min;
+
+    for (u32 BoxIndex = 1; BoxIndex < BoxCount; ++BoxIndex)
+    {
+        sim_aabb *Box = Boxes + BoxIndex;
+
+        Min = SimVec2(SimMin(Min.x, Box->Position.x), SimMin(Min.y, Box->Position.y));
+        Max = SimVec2(SimMax(Max.x, Box->Position.x + Box->Size.x), SimMax(Max.y, Box->Position.y + Box->Size.y));
+    }
+
+    Grid->Origin = Min;
+    Grid->CellCountX = SimFloorToI32((Max.x - Min.x) / CellSize) + 1;
+    Grid->CellCountY = SimFloorToI32((Max.y - Min.y) / CellSize) + 1;
+
+    u32 CellCount = (u32)(Grid->CellCountX * Grid->CellCountY);
+    Grid->CellOffsets = PushArray<u32>(Arena, CellCount + 1, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    for (u32 CellIndex = 0; CellIndex <= CellCount; ++CellIndex)
+    {
+        Grid->CellOffsets[CellIndex] = 0;
+    }
+
+    // note: counting pass, cell i counts into offset i + 1 so the prefix sum leaves the start of every cell
+    u32 EntryCount = 0;
+    for (u32 BoxIndex = 0; BoxIndex < BoxCount; ++BoxIndex)
+    {
+        sim_aabb *Box = Boxes + BoxIndex;
+
+        i32 MinX, MinY, MaxX, MaxY;
+        GetGridCellRange(Grid, Box->Position, Box->Position + Box->Size, &MinX, &MinY, &MaxX, &MaxY);
+
+        for (i32 Y = MinY; Y <= MaxY; ++Y)
+        {
+            for (i32 X = MinX; X <= MaxX; ++X)
+            {
+                ++Grid->CellOffsets[Y * Grid->CellCountX + X + 1];
+                ++EntryCount;
+            }
+        }
+    }
+
+    for (u32 CellIndex = 0; CellIndex < CellCount; ++CellIndex)
+    {
+        Grid->CellOffsets[CellIndex + 1] += Grid->CellOffsets[CellIndex];
+    }
+
+    Grid->BoxIndices = PushArray<u32>(Arena, EntryCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    // note: fill pass, the cursors start at every cell's offset
+    u32 *Cursors = PushArray<u32>(Arena, CellCount, MEMORY_TAG_COLLISION);
+    for (u32 CellIndex = 0; CellIndex < CellCount; ++CellIndex)
+    {
+        Cursors[CellIndex] = Grid->CellOffsets[CellIndex];
+    }
+
+    for (u32 BoxIndex = 0; BoxIndex < BoxCount; ++BoxIndex)
+    {
+        sim_aabb *Box = Boxes + BoxIndex;
+
+        i32 MinX, MinY, MaxX, MaxY;
+        GetGridCellRange(Grid, Box->Position, Box->Position + Box->Size, &MinX, &MinY, &MaxX, &MaxY);
+
+        for (i32 Y = MinY; Y <= MaxY; ++Y)
+        {
+            for (i32 X = MinX; X <= MaxX; ++X)
+            {
+                Grid->BoxIndices[Cursors[Y * Grid->CellCountX + X]++] = BoxIndex;
+            }
+        }
+    }
+
+    InitializeBoxSoa(&Grid->StaticBoxes, BoxCount, Arena);
+
+    for (u32 BoxIndex = 0; BoxIndex < BoxCount; ++BoxIndex)
+    {
+        SetBoxSoa(&Grid->StaticBoxes, BoxIndex, Boxes + BoxIndex);
+    }
+    Grid->StaticBoxes.Count = BoxCount;
+}
+
+internal void
+InitializeBoxGridQuery(box_grid_query *Query, box_grid *Grid, memory_arena *Arena)
+{
+    *Query = {};
+
+    InitializeBoxSoa(&Query->Candidates, Grid->BoxCount, Arena);
+
+    Query->VisitMarks = PushArray<u32>(Arena, Grid->BoxCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    for (u32 BoxIndex = 0; BoxIndex < Grid->BoxCount; ++BoxIndex)
+    {
+        Query->VisitMarks[BoxIndex] = 0;
+    }
+}
+
+// note: boxes of the cells covered by Box swept by Move, Box is treated the way SweptAABB pads it,
+// so anything SweptAABB could report a hit in [0, 1) for is in the result; the boxes in [SkipBoxes, SkipBoxes + SkipCount)
+// are left out, the rest is copied into Query->Candidates for the sweep kernels
+internal u32
+GatherSweptCandidates(box_grid *Grid, box_grid_query *Query, sim_aabb *Box, sim_vec2 Move, sim_aabb *SkipBoxes, u32 SkipCount)
+{
+    u32 Result = 0;
+
+    sim_vec2 End = Box->Position + Move;
+    sim_vec2 Min = SimVec2(SimMin(Box->Position.x, End.x), SimMin(Box->Position.y, End.y));
+    sim_vec2 Max = SimVec2(SimMax(Box->Position.x, End.x), SimMax(Box->Position.y, End.y)) + Box->Size;
+
+    i32 MinX, MinY, MaxX, MaxY;
+    GetGridCellRange(Grid, Min, Max, &MinX, &MinY, &MaxX, &MaxY);
+
+    u32 QueryIndex = ++Query->QueryIndex;
+
+    for (i32 Y = MinY; Y <= MaxY; ++Y)
+    {
+        for (i32 X = MinX; X <= MaxX; ++X)
+        {
+            u32 CellIndex = Y * Grid->CellCountX + X;
+
+            for (u32 EntryIndex = Grid->CellOffsets[CellIndex]; EntryIndex < Grid->CellOffsets[CellIndex + 1]; ++EntryIndex)
+            {
+                u32 BoxIndex = Grid->BoxIndices[EntryIndex];
+
+                if (Query->VisitMarks[BoxIndex] != QueryIndex)
+                {
+                    Query->VisitMarks[BoxIndex] = QueryIndex;
+
+                    sim_aabb *Candidate = Grid->Boxes + BoxIndex;
+                    if (Candidate < SkipBoxes || Candidate >= SkipBoxes + SkipCount)
+                    {
+                        box_soa *Candidates = &Query->Candidates;
+
+                        Candidates->MinX[Result] = Grid->StaticBoxes.MinX[BoxIndex];
+                        Candidates->MinY[Result] = Grid->StaticBoxes.MinY[BoxIndex];
+                        Candidates->MaxX[Result] = Grid->StaticBoxes.MaxX[BoxIndex];
+                        Candidates->MaxY[Result] = Grid->StaticBoxes.MaxY[BoxIndex];
+
+                        ++Result;
+                    }
+                }
+            }
+        }
+    }
+
+    Query->Candidates.Count = Result;
+
+    return Result;
+}
+
+inline i32
+FloorDivide(i32 Value, i32 Divisor)
+{
+    i32 Result = Value / Divisor;
+
+    if (Value % Divisor != 0 && (Value < 0) != (Divisor < 0))
+    {
+        --Result;
+    }
+
+    return Result;
+}
+
+inline i32
+ChunkSizeShift(i32 Size)
+{
+    i32 Result = -1;
+
+    if (Size > 0 && (Size & (Size - 1)) == 0)
+    {
+        Result = 0;
+
+        while ((1 << Result) != Size)
+        {
+            ++Result;
+        }
+    }
+
+    return Result;
+}
+
+// note: the chunk a tile coordinate falls in, a shift instead of the division for power of two chunk sizes
+inline i32
+TileToChunk(i32 Tile, i32 Size, i32 Shift)
+{
+    i32 Result = Shift >= 0 ? Tile >> Shift : FloorDivide(Tile, Size);
+    return Result;
+}
+
+// note: MinX..MaxX and MinY..MaxY are the ranges of the layer's map_chunk X and Y, the chunks' left column and top row
+internal void
+InitializeTileGridLayer(
+    tile_grid_layer *Layer,
+    i32 ChunkWidth,
+    i32 ChunkHeight,
+    i32 MinX,
+    i32 MaxX,
+    i32 MinY,
+    i32 MaxY,
+    memory_arena *Arena
+)
+{
+    *Layer = {};
+
+    Layer->ChunkWidth = ChunkWidth;
+    Layer->ChunkHeight = ChunkHeight;
+    Layer->ChunkWidthShift = ChunkSizeShift(ChunkWidth);
+    Layer->ChunkHeightShift = ChunkSizeShift(ChunkHeight);
+
+    Layer->MinChunkX = FloorDivide(MinX, ChunkWidth);
+    Layer->MinChunkRow = FloorDivide(-MaxY, ChunkHeight);
+    Layer->ChunkCountX = FloorDivide(MaxX, ChunkWidth) - Layer->MinChunkX + 1;
+    Layer->ChunkCountY = FloorDivide(-MinY, ChunkHeight) - Layer->MinChunkRow + 1;
+
+    u32 ChunkCount = (u32)(Layer->ChunkCountX * Layer->ChunkCountY);
+    Layer->Chunks = PushArray<tile_grid_chunk>(Arena, ChunkCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+    {
+        Layer->Chunks[ChunkIndex] = {};
+    }
+}
+
+// note: rows are boxes with the same bottom edge and height, ordered left to right
+inline b32
+BoxRowLess(sim_aabb *A, sim_aabb *B)
+{
+    b32 Result;
+
+    if (A->Position.y != B->Position.y)
+    {
+        Result = A->Position.y < B->Position.y;
+    }
+    else if (A->Size.y != B->Size.y)
+    {
+        Result = A->Size.y < B->Size.y;
+    }
+    else
+    {
+        Result = A->Position.x < B->Position.x;
+    }
+
+    return Result;
+}
+
+inline b32
+BoxColumnLess(sim_aabb *A, sim_aabb *B)
+{
+    b32 Result;
+
+    if (A->Position.x != B->Position.x)
+    {
+        Result = A->Position.x < B->Position.x;
+    }
+    else if (A->Size.x != B->Size.x)
+    {
+        Result = A->Size.x < B->Size.x;
+    }
+    else
+    {
+        Result = A->Position.y < B->Position.y;
+    }
+
+    return Result;
+}
+
+// note: bottom-up merge sort, stable so the merged boxes don't depend on anything but the input order
+internal void
+SortBoxes(sim_aabb *Boxes, u32 Count, b32(*Less)(sim_aabb *, sim_aabb *), memory_arena *Arena)
+{
+    temporary_memory TempMemory = BeginTemporaryMemory(Arena);
+
+    sim_aabb *Source = Boxes;
+    sim_aabb *Destination = PushArray<sim_aabb>(Arena, Count, MEMORY_TAG_SCRATCH);
+
+    for (u32 RunLength = 1; RunLength < Count; RunLength *= 2)
+    {
+        for (u32 RunStart = 0; RunStart < Count; RunStart += 2 * RunLength)
+        {
+            u32 Middle = RunStart + RunLength < Count ? RunStart + RunLength : Count;
+            u32 End = Middle + RunLength < Count ? Middle + RunLength : Count;
+
+            u32 Left = RunStart;
+            u32 Right = Middle;
+
+            for (u32 Index = RunStart; Index < End; ++Index)
+            {
+                if (Left < Middle && (Right >= End || !Less(Source + Right, Source + Left)))
+                {
+                    Destination[Index] = Source[Left++];
+                }
+                else
+                {
+                    Destination[Index] = Source[Right++];
+                }
+            }
+        }
+
+        sim_aabb *Swap = Source;
+        Source = Destination;
+        Destination = Swap;
+    }
+
+    if (Source != Boxes)
+    {
+        memcpy(Boxes, Source, Count * sizeof(sim_aabb));
+    }
+
+    EndTemporaryMemory(TempMemory);
+}
+
+// note: joins neighbours along rows first and then stacks equal rows into columns, touching or overlapping boxes
+// with the same extent on the other axis become one; edges are compared exactly, so the boxes should be in
+// coordinates where shared edges come out bit-identical (tile units rather than world units)
+internal u32
+MergeBoxRuns(sim_aabb *Boxes, u32 Count, b32 Rows)
+{
+    u32 Result = 0;
+
+    for (u32 Index = 0; Index < Count; ++Index)
+    {
+        sim_aabb *Box = Boxes + Index;
+        sim_aabb *Last = Result > 0 ? Boxes + Result - 1 : 0;
+
+        b32 Joins = false;
+        if (Last)
+        {
+            if (Rows)
+            {
+                Joins = Last->Position.y == Box->Position.y && Last->Size.y == Box->Size.y &&
+                    Box->Position.x <= Last->Position.x + Last->Size.x;
+            }
+            else
+            {
+                Joins = Last->Position.x == Box->Position.x && Last->Size.x == Box->Size.x &&
+                    Box->Position.y <= Last->Position.y + Last->Size.y;
+            }
+        }
+
+        if (Joins)
+        {
+            if (Rows)
+            {
+                Last->Size.x = SimMax(Last->Position.x + Last->Size.x, Box->Position.x + Box->Size.x) - Last->Position.x;
+            }
+            else
+            {
+                Last->Size.y = SimMax(Last->Position.y + Last->Size.y, Box->Position.y + Box->Size.y) - Last->Position.y;
+            }
+        }
+        else
+        {
+            Boxes[Result++] = *Box;
+        }
+    }
+
+    return Result;
+}
+
+// note: merges the boxes in place and returns how many are left
+internal u32
+MergeBoxes(sim_aabb *Boxes, u32 Count, memory_arena *Arena)
+{
+    SortBoxes(Boxes, Count, BoxRowLess, Arena);
+    u32 Result = MergeBoxRuns(Boxes, Count, true);
+
+    SortBoxes(Boxes, Result, BoxColumnLess, Arena);
+    Result = MergeBoxRuns(Boxes, Result, false);
+
+    return Result;
+}
+
+// note: the last tile an edge at Value reaches, an edge right on a tile border ends in the tile before it
+inline i32
+LastTileBefore(sim_f32 Value)
+{
+    i32 Result = SimFloorToI32(Value);
+
+    if (SimScalar((f32)Result) == Value)
+    {
+        --Result;
+    }
+
+    return Result;
+}
+
+inline i32
+ClampTile(i32 Tile, i32 Count)
+{
+    i32 Result = Tile < 0 ? 0 : (Tile >= Count ? Count - 1 : Tile);
+    return Result;
+}
+
+// note: merges the chunk's tile boxes into maximal rectangles and bakes them into world units, the same way SweptAABB's reference boxes
+// are built; a row of floor tiles becomes a single box, so there are no internal edges left to snag on. the merge only needs scratch
+// memory, the gids aren't kept
+internal void
+SetTileGridChunk(tile_grid *Grid, tile_grid_layer *Layer, i32 X, i32 Y, u32 *GIDs, memory_arena *Arena, memory_arena *ScratchArena)
+{
+    i32 ChunkX = FloorDivide(X, Layer->ChunkWidth);
+    i32 ChunkRow = FloorDivide(-Y, Layer->ChunkHeight);
+
+    Assert(ChunkX * Layer->ChunkWidth == X && ChunkRow * Layer->ChunkHeight == -Y);
+
+    i32 GridX = ChunkX - Layer->MinChunkX;
+    i32 GridY = ChunkRow - Layer->MinChunkRow;
+
+    Assert(GridX >= 0 && GridX < Layer->ChunkCountX && GridY >= 0 && GridY < Layer->ChunkCountY);
+
+    u32 TileCount = (u32)(Layer->ChunkWidth * Layer->ChunkHeight);
+    u32 BoxCount = 0;
+
+    for (u32 TileIndex = 0; TileIndex < TileCount; ++TileIndex)
+    {
+        u32 GID = GIDs[TileIndex];
+
+        if (GID >= Grid->FirstGID && GID - Grid->FirstGID < Grid->TileIDCount)
+        {
+            u32 TileID = GID - Grid->FirstGID;
+            BoxCount += Grid->TileBoxOffsets[TileID + 1] - Grid->TileBoxOffsets[TileID];
+        }
+    }
+
+    tile_grid_chunk *Chunk = Layer->Chunks + GridY * Layer->ChunkCountX + GridX;
+    *Chunk = {};
+
+    if (BoxCount == 0)
+    {
+        return;
+    }
+
+    // note: RowBoxes holds 16 bit box indices
+    Assert(BoxCount <= 0xFFFF);
+
+    temporary_memory TempMemory = BeginTemporaryMemory(ScratchArena);
+
+    // note: in tile units from the chunk's top-left tile, so the shared edge of two neighbouring tiles comes out exactly equal for both
+    sim_aabb *Boxes = PushArray<sim_aabb>(ScratchArena, BoxCount, MEMORY_TAG_SCRATCH);
+    u32 BoxIndex = 0;
+
+    for (u32 TileIndex = 0; TileIndex < TileCount; ++TileIndex)
+    {
+        u32 GID = GIDs[TileIndex];
+
+        if (GID >= Grid->FirstGID && GID - Grid->FirstGID < Grid->TileIDCount)
+        {
+            u32 TileID = GID - Grid->FirstGID;
+
+            i32 TileX = (i32)TileIndex % Layer->ChunkWidth;
+            i32 TileY = -((i32)TileIndex / Layer->ChunkWidth);
+            sim_vec2 Tile = SimVec2(SimScalar((f32)TileX), SimScalar((f32)TileY));
+
+            for (u32 TileBoxIndex = Grid->TileBoxOffsets[TileID]; TileBoxIndex < Grid->TileBoxOffsets[TileID + 1]; ++TileBoxIndex)
+            {
+                sim_aabb *TileBox = Grid->TileBoxes + TileBoxIndex;
+                sim_aabb *Box = Boxes + BoxIndex++;
+
+                Box->Position = Tile + TileBox->Position;
+                Box->Size = TileBox->Size;
+            }
+        }
+    }
+
+    // note: the boxes come out ordered by their left edge, so the rows below list them left to right
+    u32 MergedBoxCount = MergeBoxes(Boxes, BoxCount, ScratchArena);
+
+    Grid->BoxCount += BoxCount;
+    Grid->MergedBoxCount += MergedBoxCount;
+
+    Chunk->BoxCount = MergedBoxCount;
+    Chunk->Boxes = PushArray<sim_aabb>(Arena, MergedBoxCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    Chunk->Spans = PushArray<tile_grid_span>(Arena, MergedBoxCount, MEMORY_TAG_COLLISION);
+    Chunk->RowOffsets = PushArray<u32>(Arena, Layer->ChunkHeight + 1, MEMORY_TAG_COLLISION);
+
+    for (i32 Row = 0; Row <= Layer->ChunkHeight; ++Row)
+    {
+        Chunk->RowOffsets[Row] = 0;
+    }
+
+    sim_vec2 ChunkTile = SimVec2(SimScalar((f32)X), SimScalar((f32)Y));
+
+    for (BoxIndex = 0; BoxIndex < MergedBoxCount; ++BoxIndex)
+    {
+        sim_aabb *TileUnitBox = Boxes + BoxIndex;
+        sim_vec2 Min = TileUnitBox->Position;
+        sim_vec2 Max = TileUnitBox->Position + TileUnitBox->Size;
+
+        i32 MinX = SimFloorToI32(Min.x);
+        i32 MaxX = LastTileBefore(Max.x);
+        i32 MinTileY = SimFloorToI32(Min.y);
+        i32 MaxTileY = LastTileBefore(Max.y);
+
+        // note: boxes sticking out of the chunk are only found from the chunk's own tiles, like they were per tile
+        tile_grid_span *Span = Chunk->Spans + BoxIndex;
+        Span->MinX = (u16)ClampTile(MinX, Layer->ChunkWidth);
+        Span->MaxX = (u16)ClampTile(MaxX > MinX ? MaxX : MinX, Layer->ChunkWidth);
+        Span->MinRow = (u16)ClampTile(-(MaxTileY > MinTileY ? MaxTileY : MinTileY), Layer->ChunkHeight);
+        Span->MaxRow = (u16)ClampTile(-MinTileY, Layer->ChunkHeight);
+
+        for (u32 Row = Span->MinRow; Row <= Span->MaxRow; ++Row)
+        {
+            ++Chunk->RowOffsets[Row + 1];
+        }
+
+        sim_aabb *Box = Chunk->Boxes + BoxIndex;
+        Box->Position = Grid->Origin + (ChunkTile + TileUnitBox->Position) * Grid->TileSize;
+        Box->Size = TileUnitBox->Size * Grid->TileSize;
+    }
+
+    for (i32 Row = 0; Row < Layer->ChunkHeight; ++Row)
+    {
+        Chunk->RowOffsets[Row + 1] += Chunk->RowOffsets[Row];
+    }
+
+    Chunk->RowBoxes = PushArray<u16>(Arena, Chunk->RowOffsets[Layer->ChunkHeight], MEMORY_TAG_COLLISION);
+
+    u32 *RowCursors = PushArray<u32>(ScratchArena, Layer->ChunkHeight, MEMORY_TAG_SCRATCH);
+
+    for (i32 Row = 0; Row < Layer->ChunkHeight; ++Row)
+    {
+        RowCursors[Row] = Chunk->RowOffsets[Row];
+    }
+
+    for (BoxIndex = 0; BoxIndex < MergedBoxCount; ++BoxIndex)
+    {
+        tile_grid_span *Span = Chunk->Spans + BoxIndex;
+
+        for (u32 Row = Span->MinRow; Row <= Span->MaxRow; ++Row)
+        {
+            Chunk->RowBoxes[RowCursors[Row]++] = (u16)BoxIndex;
+        }
+    }
+
+    EndTemporaryMemory(TempMemory);
+}
+
+// note: sweeps against the boxes covering the tiles MinX..MaxX by MinY..MaxY on every layer, chunks without boxes are skipped;
+// a box that spans several rows of the rect is only swept in the first of them
+internal void
+SweepTileRect(tile_grid *Grid, i32 MinX, i32 MinY, i32 MaxX, i32 MaxY, sim_vec2 Point, sim_vec2 Delta, sim_vec2 Padding, sim_vec2 *CollisionTime)
+{
+    // note: rows grow downwards
+    i32 MinRow = -MaxY;
+    i32 MaxRow = -MinY;
+
+    for (u32 LayerIndex = 0; LayerIndex < Grid->LayerCount; ++LayerIndex)
+    {
+        tile_grid_layer *Layer = Grid->Layers + LayerIndex;
+
+        i32 FirstGridX = TileToChunk(MinX, Layer->ChunkWidth, Layer->ChunkWidthShift) - Layer->MinChunkX;
+        i32 LastGridX = TileToChunk(MaxX, Layer->ChunkWidth, Layer->ChunkWidthShift) - Layer->MinChunkX;
+        i32 FirstGridY = TileToChunk(MinRow, Layer->ChunkHeight, Layer->ChunkHeightShift) - Layer->MinChunkRow;
+        i32 LastGridY = TileToChunk(MaxRow, Layer->ChunkHeight, Layer->ChunkHeightShift) - Layer->MinChunkRow;
+
+        FirstGridX = FirstGridX < 0 ? 0 : FirstGridX;
+        FirstGridY = FirstGridY < 0 ? 0 : FirstGridY;
+        LastGridX = LastGridX >= Layer->ChunkCountX ? Layer->ChunkCountX - 1 : LastGridX;
+        LastGridY = LastGridY >= Layer->ChunkCountY ? Layer->ChunkCountY - 1 : LastGridY;
+
+        for (i32 GridY = FirstGridY; GridY <= LastGridY; ++GridY)
+        {
+            for (i32 GridX = FirstGridX; GridX <= LastGridX; ++GridX)
+            {
+                tile_grid_chunk *Chunk = Layer->Chunks + GridY * Layer->ChunkCountX + GridX;
+
+                if (Chunk->BoxCount == 0)
+                {
+                    continue;
+                }
+
+                i32 ChunkMinX = (GridX + Layer->MinChunkX) * Layer->ChunkWidth;
+                i32 ChunkMinRow = (GridY + Layer->MinChunkRow) * Layer->ChunkHeight;
+
+                i32 FirstLocalX = MinX > ChunkMinX ? MinX - ChunkMinX : 0;
+                i32 LastLocalX = MaxX < ChunkMinX + Layer->ChunkWidth - 1 ? MaxX - ChunkMinX : Layer->ChunkWidth - 1;
+                i32 FirstLocalRow = MinRow > ChunkMinRow ? MinRow - ChunkMinRow : 0;
+                i32 LastLocalRow = MaxRow < ChunkMinRow + Layer->ChunkHeight - 1 ? MaxRow - ChunkMinRow : Layer->ChunkHeight - 1;
+
+                for (i32 LocalRow = FirstLocalRow; LocalRow <= LastLocalRow; ++LocalRow)
+                {
+                    for (u32 RowBoxIndex = Chunk->RowOffsets[LocalRow]; RowBoxIndex < Chunk->RowOffsets[LocalRow + 1]; ++RowBoxIndex)
+                    {
+                        u32 BoxIndex = Chunk->RowBoxes[RowBoxIndex];
+                        tile_grid_span *Span = Chunk->Spans + BoxIndex;
+
+                        // note: the row is ordered by the boxes' first column
+                        if ((i32)Span->MinX > LastLocalX)
+                        {
+                            break;
+                        }
+
+                        if ((i32)Span->MaxX >= FirstLocalX && ((i32)Span->MinRow == LocalRow || LocalRow == FirstLocalRow))
+                        {
+                            AccumulateCollisionTime(SweptAABB(Point, Delta, Chunk->Boxes[BoxIndex], Padding), CollisionTime);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// note: walks the tiles a box at Position moving by Move crosses, column by column along the longer axis of the move (rows for
+// mostly vertical moves) in the order the box reaches them, and stops at the first column entered after both collision times;
+// the columns also take the rows the box starts in, SweptAABB checks the other axis at the start position only
+internal u32
+SweepTileGrid(tile_grid *Grid, sim_vec2 Position, sim_vec2 Size, sim_vec2 Move, sim_vec2 *CollisionTime)
+{
+    u32 Result = 0;
+
+    if (Grid->LayerCount == 0)
+    {
+        return Result;
+    }
+
+    sim_f32 Zero = SimScalar(0.f);
+    sim_f32 One = SimScalar(1.f);
+
+    // note: in tile units from here on
+    sim_vec2 Start = SimVec2((Position.x - Grid->Origin.x) / Grid->TileSize.x, (Position.y - Grid->Origin.y) / Grid->TileSize.y);
+    sim_vec2 Extent = SimVec2(Size.x / Grid->TileSize.x, Size.y / Grid->TileSize.y);
+    sim_vec2 Delta = SimVec2(Move.x / Grid->TileSize.x, Move.y / Grid->TileSize.y);
+
+    // note: a is the axis walked, b the other one
+    b32 AlongY = SimAbs(Delta.y) > SimAbs(Delta.x);
+
+    sim_f32 StartA = AlongY ? Start.y : Start.x;
+    sim_f32 ExtentA = AlongY ? Extent.y : Extent.x;
+    sim_f32 DeltaA = AlongY ? Delta.y : Delta.x;
+
+    sim_f32 StartB = AlongY ? Start.x : Start.y;
+    sim_f32 ExtentB = AlongY ? Extent.x : Extent.y;
+    sim_f32 DeltaB = AlongY ? Delta.x : Delta.y;
+
+    i32 FirstStartColumn = SimFloorToI32(StartA);
+    i32 LastStartColumn = SimFloorToI32(StartA + ExtentA);
+
+    i32 Step = DeltaA < Zero ? -1 : 1;
+    i32 FirstColumn = Step > 0 ? FirstStartColumn : LastStartColumn;
+    i32 EndColumn = Step > 0 ?
+        SimFloorToI32(StartA + DeltaA + ExtentA) + 1 :
+        SimFloorToI32(StartA + DeltaA) - 1;
+
+    for (i32 Column = FirstColumn; Column != EndColumn; Column += Step)
+    {
+        sim_f32 EnterTime = Zero;
+        sim_f32 ExitTime = One;
+
+        if (Column < FirstStartColumn || Column > LastStartColumn)
+        {
+            // note: only moving boxes get past their start columns, so DeltaA isn't 0 here
+            sim_f32 Near = SimScalar((f32)(Step > 0 ? Column : Column + 1));
+            sim_f32 Far = SimScalar((f32)(Step > 0 ? Column + 1 : Column));
+
+            EnterTime = (Near - (Step > 0 ? StartA + ExtentA : StartA)) / DeltaA;
+            ExitTime = SimMin((Far - (Step > 0 ? StartA : StartA + ExtentA)) / DeltaA, One);
+
+            if (EnterTime > SimMax(CollisionTime->x, CollisionTime->y))
+            {
+                break;
+            }
+        }
+
+        sim_f32 EnterB = StartB + EnterTime * DeltaB;
+        sim_f32 ExitB = StartB + ExitTime * DeltaB;
+
+        i32 FirstRow = SimFloorToI32(SimMin(StartB, SimMin(EnterB, ExitB)));
+        i32 LastRow = SimFloorToI32(SimMax(StartB, SimMax(EnterB, ExitB)) + ExtentB);
+
+        if (AlongY)
+        {
+            SweepTileRect(Grid, FirstRow, Column, LastRow, Column, Position, Move, Size, CollisionTime);
+        }
+        else
+        {
+            SweepTileRect(Grid, Column, FirstRow, Column, LastRow, Position, Move, Size, CollisionTime);
+        }
+
+        Result += (u32)(LastRow - FirstRow + 1);
+    }
+
+    return Result;
+}
+
+// note: one fixed step of a body against the tiles and the boxes in the grid, BodyBoxes are moved along and never collide with each other;
+// only writes to the body, its boxes and Query, so bodies with their own queries can be stepped on different threads
+internal body_step
+StepBody(
+    body_component *Body,
+    sim_aabb *BodyBoxes,
+    u32 BodyBoxCount,
+    tile_grid *Tiles,
+    box_grid *Grid,
+    box_grid_query *Query,
+    sim_f32 dt
+)
+{
+    body_step Result = {};
+
+    sim_f32 Zero = SimScalar(0.f);
+    sim_f32 One = SimScalar(1.f);
+
+    // friction imitation
+    Body->Acceleration.x += SimScalar(-4.f) * Body->Velocity.x;
+    Body->Acceleration.y += SimScalar(-0.001f) * Body->Velocity.y;
+
+    Body->Velocity += Body->Acceleration * dt;
+
+    sim_vec2 Move = SimScalar(0.5f) * Body->Acceleration * SimSquare(dt) + Body->Velocity * dt;
+
+    Result.CollisionTime = SimVec2(One, One);
+
+    for (u32 BodyBoxIndex = 0; BodyBoxIndex < BodyBoxCount; ++BodyBoxIndex)
+    {
+        sim_aabb *BodyBox = BodyBoxes + BodyBoxIndex;
+
+        u32 CandidateCount = GatherSweptCandidates(Grid, Query, BodyBox, Move, BodyBoxes, BodyBoxCount);
+        SweepBoxSoa(BodyBox->Position, Move, BodyBox->Size, &Query->Candidates, &Result.CollisionTime);
+
+        Result.CandidatePairCount += CandidateCount;
+        Result.TileVisitCount += SweepTileGrid(Tiles, BodyBox->Position, BodyBox->Size, Move, &Result.CollisionTime);
+    }
+
+    Result.Move = Move * Result.CollisionTime;
+
+    Body->Acceleration.x = Zero;
+    // gravity (todo: 9.8)
+    Body->Acceleration.y = -One;
+
+    // collisions!
+    if (Result.CollisionTime.x < One)
+    {
+        Body->Velocity.x = Zero;
+    }
+
+    if (Result.CollisionTime.y < One)
+    {
+        Body->Velocity.y = Zero;
+    }
+
+    for (u32 BodyBoxIndex = 0; BodyBoxIndex < BodyBoxCount; ++BodyBoxIndex)
+    {
+        BodyBoxes[BodyBoxIndex].Position += Result.Move;
+    }
+
+    return Result;
+}
+
+internal void
+InitializePhysicsSystem(physics_system *System, u32 MaxBodyCount, tile_grid *Tiles, box_grid *Grid, memory_arena *Arena)
+{
+    *System = {};
+
+    System->MaxBodyCount = MaxBodyCount;
+    System->Bodies = PushArray<physics_body>(Arena, MaxBodyCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    System->Steps = PushArray<body_step>(Arena, MaxBodyCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+    System->Contacts = PushArray<body_contact>(Arena, MaxBodyCount, MEMORY_TAG_COLLISION, CACHE_LINE_SIZE);
+
+    System->Tiles = Tiles;
+    System->Grid = Grid;
+
+    for (u32 ChunkIndex = 0; ChunkIndex < PHYSICS_MAX_CHUNK_COUNT; ++ChunkIndex)
+    {
+        physics_chunk *Chunk = System->Chunks + ChunkIndex;
+
+        Chunk->System = System;
+        InitializeBoxGridQuery(&Chunk->Query, Grid, Arena);
+    }
+}
+
+internal
+PLATFORM_WORK_QUEUE_CALLBACK(StepPhysicsChunk)
+{
+    (void)Queue;
+
+    physics_chunk *Chunk = (physics_chunk *)Data;
+    physics_system *System = Chunk->System;
+
+    sim_f32 One = SimScalar(1.f);
+
+    body_contact *Contacts = System->Contacts + Chunk->FirstBody;
+
+    Chunk->ContactCount = 0;
+    Chunk->CandidatePairCount = 0;
+    Chunk->TileVisitCount = 0;
+
+    for (u32 BodyIndex = Chunk->FirstBody; BodyIndex < Chunk->OnePastLastBody; ++BodyIndex)
+    {
+        physics_body *Body = System->Bodies + BodyIndex;
+
+        body_step Step = StepBody(Body->Body, Body->Boxes, Body->BoxCount, System->Tiles, System->Grid, &Chunk->Query, System->dt);
+
+        *Body->Position += Step.Move;
+
+        if (Step.CollisionTime.x < One || Step.CollisionTime.y < One)
+        {
+            body_contact *Contact = Contacts + Chunk->ContactCount++;
+
+            Contact->BodyIndex = BodyIndex;
+            Contact->Position = *Body->Position;
+            Contact->CollisionTime = Step.CollisionTime;
+        }
+
+        Chunk->CandidatePairCount += Step.CandidatePairCount;
+        Chunk->TileVisitCount += Step.TileVisitCount;
+
+        System->Steps[BodyIndex] = Step;
+    }
+}
+
+// note: one fixed step of System->Bodies[0, BodyCount); the chunks go to WorkQueue when there is one with workers and run on the
+// calling thread otherwise, either way the contacts are merged in chunk order afterwards so the result is the same bit for bit
+internal void
+StepPhysics(physics_system *System, sim_f32 dt, work_queue *WorkQueue)
+{
+    Assert(System->BodyCount <= System->MaxBodyCount);
+
+    System->dt = dt;
+
+    u32 ChunkSize = (System->BodyCount + PHYSICS_MAX_CHUNK_COUNT - 1) / PHYSICS_MAX_CHUNK_COUNT;
+    if (ChunkSize < PHYSICS_MIN_CHUNK_SIZE)
+    {
+        ChunkSize = PHYSICS_MIN_CHUNK_SIZE;
+    }
+
+    System->ChunkCount = (System->BodyCount + ChunkSize - 1) / ChunkSize;
+
+    for (u32 ChunkIndex = 0; ChunkIndex < System->ChunkCount; ++ChunkIndex)
+    {
+        physics_chunk *Chunk = System->Chunks + ChunkIndex;
+
+        Chunk->FirstBody = ChunkIndex * ChunkSize;
+        Chunk->OnePastLastBody = Chunk->FirstBody + ChunkSize < System->BodyCount ? Chunk->FirstBody + ChunkSize : System->BodyCount;
+    }
+
+    if (WorkQueue && WorkQueue->WorkerCount > 0 && System->ChunkCount > 1)
+    {
+        for (u32 ChunkIndex = 0; ChunkIndex < System->ChunkCount; ++ChunkIndex)
+        {
+            WorkQueue->AddEntry(WorkQueue->Queue, StepPhysicsChunk, System->Chunks + ChunkIndex);
+        }
+
+        WorkQueue->CompleteAllWork(WorkQueue->Queue);
+    }
+    else
+    {
+        for (u32 ChunkIndex = 0; ChunkIndex < System->ChunkCount; ++ChunkIndex)
+        {
+            StepPhysicsChunk(0, System->Chunks + ChunkIndex);
+        }
+    }
+
+    // note: every chunk wrote its contacts at its first body, moving them down in chunk order keeps them in body order
+    System->ContactCount = 0;
+    System->CandidatePairCount = 0;
+    System->TileVisitCount = 0;
+
+    for (u32 ChunkIndex = 0; ChunkIndex < System->ChunkCount; ++ChunkIndex)
+    {
+        physics_chunk *Chunk = System->Chunks + ChunkIndex;
+
+        if (Chunk->ContactCount > 0 && System->ContactCount != Chunk->FirstBody)
+        {
+            memmove(System->Contacts + System->ContactCount, System->Contacts + Chunk->FirstBody, Chunk->ContactCount * sizeof(body_contact));
+        }
+
+        System->ContactCount += Chunk->ContactCount;
+        System->CandidatePairCount += Chunk->CandidatePairCount;
+        System->TileVisitCount += Chunk->TileVisitCount;
+    }
+}
+
+// note: fnv-1a over the raw bits of the simulation state, equal hashes across builds mean bit-identical trajectories
+inline u64
+HashSimState(u64 Hash, const void *Data, memory_index Size)
+{
+    const u8 *Bytes = (const u8 *)Data;
+
+    for (memory_index ByteIndex = 0; ByteIndex < Size; ++ByteIndex)
+    {
+        Hash ^= Bytes[ByteIndex];
+        Hash *= 0x100000001B3ull;
+    }
+
+    return Hash;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "fuzzy_fixed.h"
+#include "fuzzy_work_queue.h"
+
+#define SIM_STATE_HASH_SEED 0xCBF29CE484222325ull
+
+// note: a physics step is split into at most PHYSICS_MAX_CHUNK_COUNT jobs of at least PHYSICS_MIN_CHUNK_SIZE bodies
+#define PHYSICS_MIN_CHUNK_SIZE 64
+#define PHYSICS_MAX_CHUNK_COUNT 64
+
+// note: the simulation's copy of a collision box, the f32 aabb in fuzzy_tiled.h stays the asset format
+struct sim_aabb
+{
+    // top-left
+    sim_vec2 Position;
+    sim_vec2 Size;
+};
+
+struct body_component
+{
+    sim_vec2 Velocity;
+    sim_vec2 Acceleration;
+};
+
+// note: boxes as min/max corners in soa form, the layout the sweep kernels read
+struct box_soa
+{
+    u32 Count;
+
+    sim_f32 *MinX;
+    sim_f32 *MinY;
+    sim_f32 *MaxX;
+    sim_f32 *MaxY;
+};
+
+// note: static uniform grid over the collision boxes, every cell lists the boxes overlapping it back to back
+struct box_grid
+{
+    sim_vec2 Origin;
+    sim_f32 CellSize;
+
+    i32 CellCountX;
+    i32 CellCountY;
+
+    // note: CellCountX * CellCountY + 1 offsets into BoxIndices
+    u32 *CellOffsets;
+    u32 *BoxIndices;
+
+    u32 BoxCount;
+    sim_aabb *Boxes;
+    // note: copy of Boxes as they were when the grid was built, indexed the same way
+    box_soa StaticBoxes;
+};
+
+// note: scratch of the queries against one box_grid, the grid itself is read-only so every thread just needs its own of these
+struct box_grid_query
+{
+    // note: a box spanning several cells is gathered once per query, VisitMarks remember the query that took it last
+    u32 QueryIndex;
+    u32 *VisitMarks;
+    box_soa Candidates;
+};
+
+// note: the tiles a merged box came from, in the chunk's local columns and rows
+struct tile_grid_span
+{
+    u16 MinX;
+    u16 MaxX;
+    u16 MinRow;
+    u16 MaxRow;
+};
+
+// note: the tile boxes of one chunk merged into maximal rectangles and baked into world units, built once when the chunk is added;
+// local row r lists RowBoxes[RowOffsets[r]] to RowBoxes[RowOffsets[r + 1]], every box that covers the row ordered left to right,
+// so a box that spans several rows is listed in each of them
+struct tile_grid_chunk
+{
+    u32 BoxCount;
+    sim_aabb *Boxes;
+    tile_grid_span *Spans;
+
+    u32 *RowOffsets;
+    u16 *RowBoxes;
+};
+
+// note: dense index over the chunks of one tile layer, chunks of an infinite map all have the same size and sit on multiples of it;
+// chunk rows count down from the top like in the map file, while tile y grows upwards
+struct tile_grid_layer
+{
+    i32 ChunkWidth;
+    i32 ChunkHeight;
+    // note: log2 of the chunk size when it is a power of two (tiled's default is 16), -1 otherwise
+    i32 ChunkWidthShift;
+    i32 ChunkHeightShift;
+
+    i32 MinChunkX;
+    i32 MinChunkRow;
+    i32 ChunkCountX;
+    i32 ChunkCountY;
+
+    // note: row-major over the layer's chunks, BoxCount is 0 where the layer has no chunk or the chunk has no boxes
+    tile_grid_chunk *Chunks;
+};
+
+// note: static collision straight from the tile layers, tile (x, y) covers Origin + [x, x + 1] * TileSize by Origin + [y, y + 1] * TileSize
+struct tile_grid
+{
+    sim_vec2 Origin;
+    sim_vec2 TileSize;
+
+    u32 LayerCount;
+    tile_grid_layer *Layers;
+
+    u32 FirstGID;
+
+    // note: the boxes of tile id i are TileBoxes[TileBoxOffsets[i]] to TileBoxes[TileBoxOffsets[i + 1]], in tile units from the tile's bottom-left
+    u32 TileIDCount;
+    u32 *TileBoxOffsets;
+    sim_aabb *TileBoxes;
+
+    // note: over every chunk added so far, the boxes of the tiles and what is left of them after merging
+    u32 BoxCount;
+    u32 MergedBoxCount;
+};
+
+struct body_step
+{
+    // note: the move after it was clipped by the collisions
+    sim_vec2 Move;
+    sim_vec2 CollisionTime;
+
+    // note: body box vs dynamic box pairs that made it through the broadphase
+    u32 CandidatePairCount;
+    // note: tiles the body's boxes walked over
+    u32 TileVisitCount;
+};
+
+// note: what the physics step needs of one body, filled in by the game in the order the bodies are stepped
+struct physics_body
+{
+    body_component *Body;
+    sim_vec2 *Position;
+
+    // note: moved along with the body
+    sim_aabb *Boxes;
+    u32 BoxCount;
+};
+
+// note: a body whose move got clipped this step
+struct body_contact
+{
+    u32 BodyIndex;
+
+    // note: where the body ended up
+    sim_vec2 Position;
+    sim_vec2 CollisionTime;
+};
+
+// note: one job of a physics step, the bodies in [FirstBody, OnePastLastBody)
+struct alignas(CACHE_LINE_SIZE) physics_chunk
+{
+    struct physics_system *System;
+
+    u32 FirstBody;
+    u32 OnePastLastBody;
+
+    box_grid_query Query;
+
+    // note: the chunk's contacts go to System->Contacts + FirstBody in body order, a body has one at most
+    u32 ContactCount;
+    u32 CandidatePairCount;
+    u32 TileVisitCount;
+};
+
+// note: steps every body against the static world (the tiles and the boxes in the grid), bodies don't collide with each other,
+// so the bodies are independent and the step can be split across threads; the results only depend on the body order
+struct physics_system
+{
+    u32 MaxBodyCount;
+    u32 BodyCount;
+    physics_body *Bodies;
+
+    // note: indexed like Bodies
+    body_step *Steps;
+
+    tile_grid *Tiles;
+    box_grid *Grid;
+    sim_f32 dt;
+
+    u32 ChunkCount;
+    physics_chunk Chunks[PHYSICS_MAX_CHUNK_COUNT];
+
+    // note: the contacts of the last step in body order, whatever the threads finished first
+    u32 ContactCount;
+    body_contact *Contacts;
+
+    // note: totals of the last step
+    u32 CandidatePairCount;
+    u32 TileVisitCount;
+};
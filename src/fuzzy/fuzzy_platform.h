@@ -1,5 +1,8 @@
 #pragma once
 
+#include "fuzzy_memory.h"
+#include "fuzzy_work_queue.h"
+
 #define EXPORT __declspec(dllexport)
 
 #define ArrayCount(arr) (sizeof(arr) / sizeof(arr[0]))
@@ -22,6 +25,12 @@ typedef PLATFORM_READ_FILE(platform_read_file);
 #define PLATFORM_FREE_FILE(name) void name(read_file_result File)
 typedef PLATFORM_FREE_FILE(platform_free_file);
 
+#define PLATFORM_WRITE_FILE(name) b32 name(char *FileName, u32 Size, void *Contents)
+typedef PLATFORM_WRITE_FILE(platform_write_file);
+
+#define PLATFORM_GET_WALL_CLOCK(name) f64 name()
+typedef PLATFORM_GET_WALL_CLOCK(platform_get_wall_clock);
+
 #define PLATFORM_READ_IMAGE_FILE(name) u8 *name(const char *Filename, i32 *X, i32 *Y, i32 *Comp, i32 ReqComp)
 typedef PLATFORM_READ_IMAGE_FILE(platform_read_image_file);
 
@@ -36,9 +45,17 @@ struct platform_api
 
     platform_read_file *ReadFile;
     platform_free_file *FreeFile;
+    platform_write_file *WriteFile;
+
+    platform_commit_memory *CommitMemory;
+
+    // note: seconds
+    platform_get_wall_clock *GetWallClock;
 
     platform_read_image_file *ReadImageFile;
     platform_free_image_file *FreeImageFile;
+
+    work_queue WorkQueue;
 };
 
 #pragma region Renderer API
@@ -257,12 +274,19 @@ struct renderer_api
     gl_uniform_block_binding *glUniformBlockBinding;
 };
 
+// note: storage sizes are reserved address ranges, only the committed prefix is backed by memory
 struct game_memory
 {
+    // note: with large pages the whole block is committed up front
+    u64 PageSize;
+    b32 UsesLargePages;
+
     u64 PermanentStorageSize;
+    u64 PermanentStorageCommittedSize;
     void *PermanentStorage;
 
     u64 TransientStorageSize;
+    u64 TransientStorageCommittedSize;
     void *TransientStorage;
 
     platform_api Platform;
@@ -285,6 +309,9 @@ struct game_input
     key_state Jump;
     key_state Attack;
 
+    key_state DumpMemoryStats;
+    key_state Rewind;
+
     f32 MouseX;
     f32 MouseY;
 
@@ -292,6 +319,14 @@ struct game_input
     f32 ScrollY;
 };
 
+// note: hardware counters, filled in only where the platform can read them (win32: an etw pmc session, which needs admin rights);
+// the counts arrive in batches, so they are averaged over about a second of frames
+struct game_frame_counters
+{
+    b32 IsAvailable;
+    u64 DTLBMisses;
+};
+
 struct game_params
 {
     u32 ScreenWidth;
@@ -300,6 +335,7 @@ struct game_params
     f32 msPerFrame;
 
     game_input Input;
+    game_frame_counters Counters;
 };
 
 #define GAME_UPDATE_AND_RENDER(name) void name(game_memory *Memory, game_params *Params)
@@ -368,7 +404,8 @@ FormatString(wchar *String, u32 Size, wchar *Format, ...)
     va_list ArgPtr;
 
     va_start(ArgPtr, Format);
-    _vsnwprintf_s(String, Size, Size, Format, ArgPtr);
+    // note: text that doesn't fit is cut off instead of going to the invalid parameter handler
+    _vsnwprintf_s(String, Size, _TRUNCATE, Format, ArgPtr);
     va_end(ArgPtr);
 }
 
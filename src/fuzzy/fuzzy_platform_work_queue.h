@@ -0,0 +1,113 @@
+#pragma once
+
+#include <emmintrin.h>
+
+#include "fuzzy_types.h"
+#include "fuzzy_work_queue.h"
+
+// note: the platform side of fuzzy_work_queue.h, shared by win32_fuzzy and fuzzy_benchmark; the platform owns the worker threads
+// and decides how idle workers sleep, the ring only calls back into it when an entry was added
+#define PLATFORM_WORK_QUEUE_ENTRY_COUNT 256
+
+// note: wakes a worker for the entry that was just added, 0 when the workers spin on the queue
+#define PLATFORM_SIGNAL_WORK_QUEUE(name) void name(platform_work_queue *Queue)
+typedef PLATFORM_SIGNAL_WORK_QUEUE(platform_signal_work_queue);
+
+struct platform_work_queue_entry
+{
+    platform_work_queue_callback *Callback;
+    void *Data;
+};
+
+// note: single producer (the game thread) ring, workers take entries with a compare-exchange on NextEntryToRead
+struct platform_work_queue
+{
+    std::atomic<u32> CompletionGoal;
+    std::atomic<u32> CompletionCount;
+
+    std::atomic<u32> NextEntryToWrite;
+    std::atomic<u32> NextEntryToRead;
+
+    platform_signal_work_queue *Signal;
+    // note: whatever the platform's workers wait on, a semaphore handle on win32
+    void *SignalHandle;
+
+    platform_work_queue_entry Entries[PLATFORM_WORK_QUEUE_ENTRY_COUNT];
+};
+
+inline void
+InitializePlatformWorkQueue(platform_work_queue *Queue, platform_signal_work_queue *Signal, void *SignalHandle)
+{
+    Queue->CompletionGoal.store(0);
+    Queue->CompletionCount.store(0);
+    Queue->NextEntryToWrite.store(0);
+    Queue->NextEntryToRead.store(0);
+
+    Queue->Signal = Signal;
+    Queue->SignalHandle = SignalHandle;
+}
+
+internal
+PLATFORM_ADD_WORK_ENTRY(AddPlatformWorkEntry)
+{
+    u32 EntryToWrite = Queue->NextEntryToWrite.load(std::memory_order_relaxed);
+    u32 NewNextEntryToWrite = (EntryToWrite + 1) % PLATFORM_WORK_QUEUE_ENTRY_COUNT;
+    Assert(NewNextEntryToWrite != Queue->NextEntryToRead.load(std::memory_order_acquire));
+
+    platform_work_queue_entry *Entry = Queue->Entries + EntryToWrite;
+    Entry->Callback = Callback;
+    Entry->Data = Data;
+
+    Queue->CompletionGoal.fetch_add(1, std::memory_order_relaxed);
+
+    // note: publishes the entry, a worker that sees the new write position sees the entry as well
+    Queue->NextEntryToWrite.store(NewNextEntryToWrite, std::memory_order_release);
+
+    if (Queue->Signal)
+    {
+        Queue->Signal(Queue);
+    }
+}
+
+// note: returns false when there was nothing to take
+inline b32
+DoNextPlatformWorkQueueEntry(platform_work_queue *Queue)
+{
+    b32 Result = false;
+
+    u32 EntryToRead = Queue->NextEntryToRead.load(std::memory_order_relaxed);
+
+    if (EntryToRead != Queue->NextEntryToWrite.load(std::memory_order_acquire))
+    {
+        u32 NewNextEntryToRead = (EntryToRead + 1) % PLATFORM_WORK_QUEUE_ENTRY_COUNT;
+
+        // note: another thread may have taken the entry in the meantime, then this one just comes back for the next
+        if (Queue->NextEntryToRead.compare_exchange_strong(EntryToRead, NewNextEntryToRead, std::memory_order_acq_rel))
+        {
+            platform_work_queue_entry Entry = Queue->Entries[EntryToRead];
+            Entry.Callback(Queue, Entry.Data);
+
+            Queue->CompletionCount.fetch_add(1, std::memory_order_release);
+        }
+
+        Result = true;
+    }
+
+    return Result;
+}
+
+internal
+PLATFORM_COMPLETE_ALL_WORK(CompleteAllPlatformWork)
+{
+    while (Queue->CompletionCount.load(std::memory_order_acquire) != Queue->CompletionGoal.load(std::memory_order_relaxed))
+    {
+        if (!DoNextPlatformWorkQueueEntry(Queue))
+        {
+            // note: the remaining entries are running on the workers
+            _mm_pause();
+        }
+    }
+
+    Queue->CompletionGoal.store(0, std::memory_order_relaxed);
+    Queue->CompletionCount.store(0, std::memory_order_relaxed);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "fuzzy_types.h"
+#include "fuzzy_simd.h"
 
 struct random_sequence
 {
@@ -59,3 +60,184 @@ RandomBetween(random_sequence *Sequence, i32 Min, i32 Max)
 
     return Result;
 }
+
+#define RANDOM_LANE_COUNT 8
+
+// note: 2^-24, floats are made from the top 24 bits so every path converts them exactly
+#define RANDOM_UNIT_SCALE (1.f / 16777216.f)
+
+// note: independent xorshift128+ streams, one per simd lane, the state halves are soa so each loads with one instruction
+struct random_lanes
+{
+    u64 State0[RANDOM_LANE_COUNT];
+    u64 State1[RANDOM_LANE_COUNT];
+};
+
+inline u64
+SplitMix64(u64 *State)
+{
+    u64 Result = (*State += 0x9E3779B97F4A7C15ull);
+    Result = (Result ^ (Result >> 30)) * 0xBF58476D1CE4E5B9ull;
+    Result = (Result ^ (Result >> 27)) * 0x94D049BB133111EBull;
+    Result = Result ^ (Result >> 31);
+
+    return Result;
+}
+
+inline random_lanes
+RandomLanes(u32 Seed)
+{
+    random_lanes Result = {};
+
+    u64 SeedState = Seed;
+    for (u32 Lane = 0; Lane < RANDOM_LANE_COUNT; ++Lane)
+    {
+        Result.State0[Lane] = SplitMix64(&SeedState);
+        Result.State1[Lane] = SplitMix64(&SeedState);
+
+        // note: xorshift can't leave the all zero state
+        if (!Result.State0[Lane] && !Result.State1[Lane])
+        {
+            Result.State1[Lane] = 1;
+        }
+    }
+
+    return Result;
+}
+
+// note: every path steps the same streams, so the output doesn't depend on the instruction set
+internal void
+RandomNextLanes01Scalar(random_lanes *Lanes, f32 *Values)
+{
+    for (u32 Lane = 0; Lane < RANDOM_LANE_COUNT; ++Lane)
+    {
+        u64 X = Lanes->State0[Lane];
+        u64 Y = Lanes->State1[Lane];
+
+        Lanes->State0[Lane] = Y;
+        X ^= X << 23;
+        Lanes->State1[Lane] = X ^ Y ^ (X >> 17) ^ (Y >> 26);
+
+        u64 Next = Lanes->State1[Lane] + Y;
+        Values[Lane] = (f32)(u32)(Next >> 40) * RANDOM_UNIT_SCALE;
+    }
+}
+
+#if FUZZY_SSE2
+inline __m128i
+RandomStepSSE2(u64 *State0, u64 *State1)
+{
+    __m128i X = _mm_loadu_si128((__m128i *)State0);
+    __m128i Y = _mm_loadu_si128((__m128i *)State1);
+
+    _mm_storeu_si128((__m128i *)State0, Y);
+    X = _mm_xor_si128(X, _mm_slli_epi64(X, 23));
+    X = _mm_xor_si128(_mm_xor_si128(X, Y), _mm_xor_si128(_mm_srli_epi64(X, 17), _mm_srli_epi64(Y, 26)));
+    _mm_storeu_si128((__m128i *)State1, X);
+
+    // note: top 24 bits of each 64 bit lane, moved into the low dword
+    __m128i Result = _mm_srli_epi64(_mm_add_epi64(X, Y), 40);
+    return Result;
+}
+
+internal void
+RandomNextLanes01SSE2(random_lanes *Lanes, f32 *Values)
+{
+    __m128 Scale = _mm_set1_ps(RANDOM_UNIT_SCALE);
+
+    for (u32 Lane = 0; Lane < RANDOM_LANE_COUNT; Lane += 4)
+    {
+        __m128i Next01 = RandomStepSSE2(Lanes->State0 + Lane, Lanes->State1 + Lane);
+        __m128i Next23 = RandomStepSSE2(Lanes->State0 + Lane + 2, Lanes->State1 + Lane + 2);
+
+        __m128i Next = _mm_unpacklo_epi64(
+            _mm_shuffle_epi32(Next01, _MM_SHUFFLE(2, 0, 2, 0)),
+            _mm_shuffle_epi32(Next23, _MM_SHUFFLE(2, 0, 2, 0))
+        );
+
+        _mm_storeu_ps(Values + Lane, _mm_mul_ps(_mm_cvtepi32_ps(Next), Scale));
+    }
+}
+#endif
+
+#if FUZZY_AVX2
+inline FUZZY_AVX2_TARGET __m256i
+RandomStepAVX2(u64 *State0, u64 *State1)
+{
+    __m256i X = _mm256_loadu_si256((__m256i *)State0);
+    __m256i Y = _mm256_loadu_si256((__m256i *)State1);
+
+    _mm256_storeu_si256((__m256i *)State0, Y);
+    X = _mm256_xor_si256(X, _mm256_slli_epi64(X, 23));
+    X = _mm256_xor_si256(_mm256_xor_si256(X, Y), _mm256_xor_si256(_mm256_srli_epi64(X, 17), _mm256_srli_epi64(Y, 26)));
+    _mm256_storeu_si256((__m256i *)State1, X);
+
+    __m256i Result = _mm256_srli_epi64(_mm256_add_epi64(X, Y), 40);
+
+    // note: gathers the four low dwords into the lower 128 bits
+    Result = _mm256_permutevar8x32_epi32(Result, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    return Result;
+}
+
+internal FUZZY_AVX2_TARGET void
+RandomNextLanes01AVX2(random_lanes *Lanes, f32 *Values)
+{
+    __m256i Next0123 = RandomStepAVX2(Lanes->State0, Lanes->State1);
+    __m256i Next4567 = RandomStepAVX2(Lanes->State0 + 4, Lanes->State1 + 4);
+
+    __m256i Next = _mm256_inserti128_si256(Next0123, _mm256_castsi256_si128(Next4567), 1);
+
+    _mm256_storeu_ps(Values, _mm256_mul_ps(_mm256_cvtepi32_ps(Next), _mm256_set1_ps(RANDOM_UNIT_SCALE)));
+}
+#endif
+
+// note: writes RANDOM_LANE_COUNT values in [0, 1)
+inline void
+RandomNextLanes01(random_lanes *Lanes, f32 *Values)
+{
+#if FUZZY_AVX2
+    if (SimdHasAVX2)
+    {
+        RandomNextLanes01AVX2(Lanes, Values);
+        return;
+    }
+#endif
+
+#if FUZZY_SSE2
+    RandomNextLanes01SSE2(Lanes, Values);
+#else
+    RandomNextLanes01Scalar(Lanes, Values);
+#endif
+}
+
+internal void
+RandomFill01(random_lanes *Lanes, f32 *Values, u32 Count)
+{
+    u32 Index = 0;
+    for (; Index + RANDOM_LANE_COUNT <= Count; Index += RANDOM_LANE_COUNT)
+    {
+        RandomNextLanes01(Lanes, Values + Index);
+    }
+
+    if (Index < Count)
+    {
+        f32 Tail[RANDOM_LANE_COUNT];
+        RandomNextLanes01(Lanes, Tail);
+
+        for (u32 TailIndex = 0; Index < Count; ++Index, ++TailIndex)
+        {
+            Values[Index] = Tail[TailIndex];
+        }
+    }
+}
+
+internal void
+RandomFillBetween(random_lanes *Lanes, f32 *Values, u32 Count, f32 Min, f32 Max)
+{
+    RandomFill01(Lanes, Values, Count);
+
+    for (u32 Index = 0; Index < Count; ++Index)
+    {
+        Values[Index] = Lerp(Min, Values[Index], Max);
+    }
+}
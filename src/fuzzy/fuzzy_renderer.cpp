@@ -1,43 +1,29 @@
 #include "fuzzy_renderer.h"
 
 inline b32
-UniformKeyComparator(shader_uniform *Uniform, char *Key)
+UniformKeyComparator(shader_uniform *Uniform, string_id Key)
 {
-    b32 Result = StringEquals(Uniform->Name, Key);
-    return Result;
-}
-
-inline b32
-UniformKeyExists(shader_uniform *Uniform)
-{
-    b32 Result = false;
-
-    if (Uniform->Name)
-    {
-        Result = true;
-    }
-
+    b32 Result = Uniform->Id == Key;
     return Result;
 }
 
 inline void
-UniformKeySetter(shader_uniform *Uniform, char *Key)
+UniformKeySetter(shader_uniform *Uniform, string_id Key)
 {
-    Uniform->Name = Key;
+    Uniform->Id = Key;
 }
 
 inline shader_uniform *
-GetUniform(shader_program *ShaderProgram, char *Name)
+GetUniform(shader_program *ShaderProgram, string_id Id)
 {
-    shader_uniform *Result = Get<shader_uniform, char *>(&ShaderProgram->Uniforms, Name, UniformKeyComparator);
+    shader_uniform *Result = Get<shader_uniform, string_id>(&ShaderProgram->Uniforms, Id, UniformKeyComparator);
     return Result;
 }
 
 inline shader_uniform *
-CreateUniform(shader_program *ShaderProgram, char *Name, memory_arena *Arena)
+CreateUniform(shader_program *ShaderProgram, string_id Id)
 {
-    shader_uniform *Result = Create<shader_uniform, char *>(
-        &ShaderProgram->Uniforms, Name, UniformKeyExists, UniformKeySetter, Arena);
+    shader_uniform *Result = Create<shader_uniform, string_id>(&ShaderProgram->Uniforms, Id, UniformKeySetter);
     return Result;
 }
 
@@ -63,7 +49,7 @@ CreateShader(
         i32 LogLength;
         Renderer->glGetShaderiv(Shader, GL_INFO_LOG_LENGTH, &LogLength);
 
-        char *ErrorLog = PushString(&GameState->WorldArena, LogLength);
+        char *ErrorLog = PushString(&GameState->WorldArena, LogLength, MEMORY_TAG_SHADERS);
 
         Renderer->glGetShaderInfoLog(Shader, LogLength, NULL, ErrorLog);
 
@@ -106,7 +92,7 @@ CreateProgram(
         i32 LogLength;
         Renderer->glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &LogLength);
 
-        char *ErrorLog = PushString(&GameState->WorldArena, LogLength);
+        char *ErrorLog = PushString(&GameState->WorldArena, LogLength, MEMORY_TAG_SHADERS);
 
         Renderer->glGetProgramInfoLog(Program, LogLength, nullptr, ErrorLog);
 
@@ -230,18 +216,20 @@ CreateShaderProgram(
 {
     shader_program Result = {};
 
-    char *VertexShaderSource = (char *)Platform->ReadFile(VertexShaderFileName).Contents;
-    char *FragmentShaderSource = (char *)Platform->ReadFile(FragmentShaderFileName).Contents;
-    u32 VertexShader = CreateShader(Renderer, Platform, GameState, GL_VERTEX_SHADER, &VertexShaderSource[0]);
-    u32 FragmentShader = CreateShader(Renderer, Platform, GameState, GL_FRAGMENT_SHADER, &FragmentShaderSource[0]);
+    read_file_result VertexShaderFile = Platform->ReadFile(VertexShaderFileName);
+    read_file_result FragmentShaderFile = Platform->ReadFile(FragmentShaderFileName);
+    u32 VertexShader = CreateShader(Renderer, Platform, GameState, GL_VERTEX_SHADER, (char *)VertexShaderFile.Contents);
+    u32 FragmentShader = CreateShader(Renderer, Platform, GameState, GL_FRAGMENT_SHADER, (char *)FragmentShaderFile.Contents);
+
+    Platform->FreeFile(VertexShaderFile);
+    Platform->FreeFile(FragmentShaderFile);
 
     Result.ProgramHandle = CreateProgram(Renderer, Platform, GameState, VertexShader, FragmentShader);
 
     i32 UniformCount;
     Renderer->glGetProgramiv(Result.ProgramHandle, GL_ACTIVE_UNIFORMS, &UniformCount);
 
-    Result.Uniforms.Count = (u32)UniformCount;
-    Result.Uniforms.Values = PushArray<shader_uniform>(&GameState->WorldArena, Result.Uniforms.Count);
+    InitializeHashTable(&Result.Uniforms, (u32)UniformCount, &GameState->WorldArena, MEMORY_TAG_SHADERS);
 
     i32 MaxUniformLength;
     Renderer->glGetProgramiv(Result.ProgramHandle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &MaxUniformLength);
@@ -251,10 +239,11 @@ CreateShaderProgram(
         GLsizei Length;
         i32 Size;
         GLenum Type;
-        char *Name = PushString(&GameState->WorldArena, MaxUniformLength);
+        char *Name = PushString(&GameState->WorldArena, MaxUniformLength, MEMORY_TAG_SHADERS);
         Renderer->glGetActiveUniform(Result.ProgramHandle, UniformIndex, MaxUniformLength, &Length, &Size, &Type, Name);
         
-        shader_uniform *Uniform = CreateUniform(&Result, Name, &GameState->WorldArena);
+        shader_uniform *Uniform = CreateUniform(&Result, InternString(&GameState->Strings, Name));
+        Uniform->Name = Name;
         Uniform->Location = GetUniformLocation(Renderer, Result.ProgramHandle, Uniform->Name);
     }
 
@@ -312,8 +301,8 @@ DrawRectangle(
     Renderer->glBindVertexArray(GameState->QuadVertexBuffer.VAO);
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->QuadVertexBuffer.VBO);
 
-    shader_uniform *ModelUniform = GetUniform(&GameState->RectangleShaderProgram, "u_Model");
-    shader_uniform *ColorUniform = GetUniform(&GameState->RectangleShaderProgram, "u_Color");
+    shader_uniform *ModelUniform = GetUniform(&GameState->RectangleShaderProgram, SID("u_Model"));
+    shader_uniform *ColorUniform = GetUniform(&GameState->RectangleShaderProgram, SID("u_Color"));
 
     mat4 Model = mat4(1.f);
 
@@ -353,10 +342,10 @@ DrawRectangleOutline(
     Renderer->glBindVertexArray(GameState->QuadVertexBuffer.VAO);
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->QuadVertexBuffer.VBO);
 
-    shader_uniform *ModelUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, "u_Model");
-    shader_uniform *ColorUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, "u_Color");
-    shader_uniform *ThicknessUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, "u_Thickness");
-    shader_uniform *WidthOverHeightUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, "u_WidthOverHeight");
+    shader_uniform *ModelUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, SID("u_Model"));
+    shader_uniform *ColorUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, SID("u_Color"));
+    shader_uniform *ThicknessUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, SID("u_Thickness"));
+    shader_uniform *WidthOverHeightUniform = GetUniform(&GameState->RectangleOutlineShaderProgram, SID("u_WidthOverHeight"));
 
     SetShaderUniform(Renderer, WidthOverHeightUniform, Size.x / Size.y);
 
@@ -401,8 +390,8 @@ DrawSprite(
     Renderer->glBindVertexArray(GameState->QuadVertexBuffer.VAO);
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->QuadVertexBuffer.VBO);
 
-    shader_uniform *ModelUniform = GetUniform(&GameState->SpriteShaderProgram, "u_Model");
-    shader_uniform *UVUniform = GetUniform(&GameState->SpriteShaderProgram, "u_UVOffset");
+    shader_uniform *ModelUniform = GetUniform(&GameState->SpriteShaderProgram, SID("u_Model"));
+    shader_uniform *UVUniform = GetUniform(&GameState->SpriteShaderProgram, SID("u_UVOffset"));
 
     mat4 Model = mat4(1.f);
 
@@ -442,8 +431,8 @@ DrawTextLine(
     Renderer->glBindVertexArray(GameState->QuadVertexBuffer.VAO);
     Renderer->glBindBuffer(GL_ARRAY_BUFFER, GameState->QuadVertexBuffer.VBO);
 
-    shader_uniform *TextColorUniform = GetUniform(&GameState->TextShaderProgram, "u_TextColor");
-    SetShaderUniform(Renderer, TextColorUniform->Location, TextColor);
+    text_shader_uniforms *Uniforms = &GameState->TextUniforms;
+    SetShaderUniform(Renderer, Uniforms->TextColor->Location, TextColor);
 
     vec2 TextureAtlasSize = vec2(Font->TextureAtlas.Width, Font->TextureAtlas.Height);
 
@@ -458,15 +447,11 @@ DrawTextLine(
 
         glyph *GlyphInfo = GetCharacterGlyph(Font, Character);
         
-        shader_uniform *SpriteSizeUniform = GetUniform(&GameState->TextShaderProgram, "u_SpriteSize");
-        SetShaderUniform(Renderer, SpriteSizeUniform->Location, GlyphInfo->SpriteSize / TextureAtlasSize);
+        SetShaderUniform(Renderer, Uniforms->SpriteSize->Location, GlyphInfo->SpriteSize / TextureAtlasSize);
 
         vec2 Size = GlyphInfo->CharacterSize * GameState->PixelsToWorldUnits * TextScale;
         vec2 UV = GlyphInfo->UV;
 
-        shader_uniform *ModelUniform = GetUniform(&GameState->TextShaderProgram, "u_Model");
-        shader_uniform *UVUniform = GetUniform(&GameState->TextShaderProgram, "u_UVOffset");
-
         mat4 Model = mat4(1.f);
 
         vec2 Alignment = GlyphInfo->Alignment * GameState->PixelsToWorldUnits * TextScale;
@@ -483,8 +468,8 @@ DrawTextLine(
             Model = glm::translate(Model, vec3(-Size / 2.f, 0.f));
         }
 
-        SetShaderUniform(Renderer, ModelUniform->Location, Model);
-        SetShaderUniform(Renderer, UVUniform->Location, UV);
+        SetShaderUniform(Renderer, Uniforms->Model->Location, Model);
+        SetShaderUniform(Renderer, Uniforms->UVOffset->Location, UV);
 
         Renderer->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
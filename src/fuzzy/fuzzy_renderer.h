@@ -43,12 +43,14 @@ struct vertex_buffer
 
 struct shader_uniform
 {
+    string_id Id;
     char *Name;
     i32 Location;
-
-    shader_uniform *Next;
 };
 
+// note: budget for the distinct uniform names interned across all the shader programs
+#define MAX_UNIFORM_NAME_COUNT 64
+
 struct shader_program
 {
     u32 ProgramHandle;
@@ -56,6 +58,15 @@ struct shader_program
     hash_table<shader_uniform> Uniforms;
 };
 
+// note: resolved once after the text program is created, DrawTextLine sets them per glyph
+struct text_shader_uniforms
+{
+    shader_uniform *Model;
+    shader_uniform *UVOffset;
+    shader_uniform *SpriteSize;
+    shader_uniform *TextColor;
+};
+
 struct rotation_info
 {
     f32 AngleInRadians;
@@ -0,0 +1,70 @@
+#pragma once
+
+// note: x64 always has sse2, so the sse2 paths are picked at compile time; the avx2 kernels are compiled into every x64 build
+// without raising the baseline (msvc emits avx2 intrinsics anywhere, gcc and clang need FUZZY_AVX2_TARGET on each avx2 function)
+// and only run when the cpu has avx2, see SimdHasAVX2
+// define FUZZY_NO_SIMD to force the scalar fallbacks
+#if !defined(FUZZY_NO_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FUZZY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FUZZY_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#endif
+
+#if !defined(FUZZY_SSE2)
+#define FUZZY_SSE2 0
+#endif
+
+#if !defined(FUZZY_AVX2)
+#define FUZZY_AVX2 0
+#endif
+
+#if FUZZY_AVX2 && !defined(_MSC_VER)
+#define FUZZY_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define FUZZY_AVX2_TARGET
+#endif
+
+inline b32
+CpuSupportsAVX2()
+{
+    b32 Result = false;
+
+#if FUZZY_AVX2 && defined(_MSC_VER)
+    i32 Info[4];
+    __cpuid(Info, 0);
+
+    if (Info[0] >= 7)
+    {
+        __cpuid(Info, 1);
+
+        // note: the os has to save the ymm registers as well, osxsave and xcr0 bits 1 (sse) and 2 (avx)
+        b32 HasOSXSave = (Info[2] & (1 << 27)) != 0;
+        b32 HasAVX = (Info[2] & (1 << 28)) != 0;
+
+        if (HasOSXSave && HasAVX && (_xgetbv(0) & 6) == 6)
+        {
+            __cpuidex(Info, 7, 0);
+            Result = (Info[1] & (1 << 5)) != 0;
+        }
+    }
+#elif FUZZY_AVX2
+    // note: checks the os support as well
+    Result = __builtin_cpu_supports("avx2");
+#endif
+
+    return Result;
+}
+
+// note: checked once at startup, every avx2 kernel call is behind it
+global b32 SimdHasAVX2 = CpuSupportsAVX2();
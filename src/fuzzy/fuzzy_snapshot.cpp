@@ -0,0 +1,264 @@
+#include "fuzzy_snapshot.h"
+
+internal void
+InitializeSnapshotRing(
+    snapshot_ring *Ring,
+    void *State,
+    memory_index StorageSize,
+    u32 MaxSnapshotCount,
+    u32 TicksPerSnapshot,
+    u32 SnapshotsPerKeyframe,
+    memory_arena *Arena
+)
+{
+    *Ring = {};
+
+    Ring->State = (u8 *)State;
+
+    InitializeSubArena(&Ring->ShadowArena, Arena, AlignUp(StorageSize, SNAPSHOT_PAGE_SIZE), SNAPSHOT_PAGE_SIZE);
+    Ring->Shadow = (u8 *)Ring->ShadowArena.Base;
+    Ring->DirtyPages = PushArray<u32>(Arena, (u32)(Ring->ShadowArena.Size / SNAPSHOT_PAGE_SIZE), MEMORY_TAG_SNAPSHOTS);
+
+    Ring->StorageSize = StorageSize;
+    Ring->Storage = (u8 *)PushSize(Arena, StorageSize, MEMORY_TAG_SNAPSHOTS, SNAPSHOT_PAGE_SIZE);
+
+    Ring->MaxSnapshotCount = MaxSnapshotCount;
+    Ring->Snapshots = PushArray<snapshot>(Arena, MaxSnapshotCount, MEMORY_TAG_SNAPSHOTS);
+
+    Ring->TicksPerSnapshot = TicksPerSnapshot;
+    Ring->SnapshotsPerKeyframe = SnapshotsPerKeyframe;
+}
+
+inline memory_index
+GetSnapshotPageSize(memory_index StateSize, u32 PageIndex)
+{
+    memory_index PageOffset = PageIndex * SNAPSHOT_PAGE_SIZE;
+    memory_index Result = StateSize - PageOffset < SNAPSHOT_PAGE_SIZE ? StateSize - PageOffset : SNAPSHOT_PAGE_SIZE;
+
+    return Result;
+}
+
+inline snapshot *
+GetSnapshot(snapshot_ring *Ring, u32 Index)
+{
+    Assert(Index < Ring->SnapshotCount);
+
+    snapshot *Result = Ring->Snapshots + (Ring->FirstSnapshot + Index) % Ring->MaxSnapshotCount;
+    return Result;
+}
+
+inline void
+DropOldestSnapshot(snapshot_ring *Ring)
+{
+    Assert(Ring->SnapshotCount > 0);
+
+    Ring->FirstSnapshot = (Ring->FirstSnapshot + 1) % Ring->MaxSnapshotCount;
+    --Ring->SnapshotCount;
+}
+
+inline b32
+SnapshotOverlaps(snapshot *Snapshot, memory_index Offset, memory_index Size)
+{
+    b32 Result = Snapshot->Offset < (Offset + Size) && Offset < (Snapshot->Offset + Snapshot->Size);
+    return Result;
+}
+
+// note: storage is written front to back and wraps, so whatever is in the way of the new write is always the oldest data
+internal memory_index
+ReserveSnapshotStorage(snapshot_ring *Ring, memory_index Size)
+{
+    Assert(Size <= Ring->StorageSize);
+
+    if (Ring->SnapshotCount == Ring->MaxSnapshotCount)
+    {
+        DropOldestSnapshot(Ring);
+    }
+
+    if (Ring->WritePosition + Size > Ring->StorageSize)
+    {
+        // note: snapshots in the skipped tail are from the previous lap
+        while (Ring->SnapshotCount > 0 && GetSnapshot(Ring, 0)->Offset >= Ring->WritePosition)
+        {
+            DropOldestSnapshot(Ring);
+        }
+
+        Ring->WritePosition = 0;
+    }
+
+    while (Ring->SnapshotCount > 0 && SnapshotOverlaps(GetSnapshot(Ring, 0), Ring->WritePosition, Size))
+    {
+        DropOldestSnapshot(Ring);
+    }
+
+    // note: deltas can't be restored without their keyframe
+    while (Ring->SnapshotCount > 0 && !GetSnapshot(Ring, 0)->IsKeyframe)
+    {
+        DropOldestSnapshot(Ring);
+    }
+
+    memory_index Result = Ring->WritePosition;
+    Ring->WritePosition += Size;
+
+    return Result;
+}
+
+internal void
+CaptureSnapshot(snapshot_ring *Ring, memory_index StateSize, platform_api *Platform)
+{
+    f64 StartTime = Platform->GetWallClock();
+
+    Ring->TicksSinceSnapshot = 0;
+
+    // note: a keyframe of this state wouldn't fit in the storage, the overlay shows how many captures were lost
+    if (StateSize > Ring->StorageSize)
+    {
+        ++Ring->Stats.SkippedCount;
+        return;
+    }
+
+    if (StateSize > Ring->ShadowArena.Used)
+    {
+        PushSize(&Ring->ShadowArena, StateSize - Ring->ShadowArena.Used, MEMORY_TAG_SNAPSHOTS, 1);
+    }
+
+    b32 IsKeyframe =
+        Ring->SnapshotCount == 0 ||
+        Ring->ShadowStateSize != StateSize ||
+        Ring->SnapshotsSinceKeyframe + 1 >= Ring->SnapshotsPerKeyframe;
+
+    snapshot Snapshot = {};
+    Snapshot.Tick = Ring->Tick;
+    Snapshot.StateSize = StateSize;
+
+    if (!IsKeyframe)
+    {
+        u32 PageCount = (u32)(AlignUp(StateSize, SNAPSHOT_PAGE_SIZE) / SNAPSHOT_PAGE_SIZE);
+
+        for (u32 PageIndex = 0; PageIndex < PageCount; ++PageIndex)
+        {
+            memory_index PageOffset = PageIndex * SNAPSHOT_PAGE_SIZE;
+            memory_index PageSize = GetSnapshotPageSize(StateSize, PageIndex);
+
+            if (memcmp(Ring->State + PageOffset, Ring->Shadow + PageOffset, PageSize) != 0)
+            {
+                Ring->DirtyPages[Snapshot.PageCount++] = PageIndex;
+            }
+        }
+
+        // note: delta layout is a page index table followed by the page contents
+        Snapshot.Size = Snapshot.PageCount * (sizeof(u32) + SNAPSHOT_PAGE_SIZE);
+        Snapshot.Offset = ReserveSnapshotStorage(Ring, Snapshot.Size);
+
+        if (Ring->SnapshotCount == 0)
+        {
+            // note: making room evicted the keyframe this delta was based on, fall back to a keyframe
+            Ring->WritePosition = Snapshot.Offset;
+            Snapshot.PageCount = 0;
+            IsKeyframe = true;
+        }
+    }
+
+    if (IsKeyframe)
+    {
+        Snapshot.IsKeyframe = true;
+        Snapshot.Size = StateSize;
+        Snapshot.PageCount = (u32)(AlignUp(StateSize, SNAPSHOT_PAGE_SIZE) / SNAPSHOT_PAGE_SIZE);
+        Snapshot.Offset = ReserveSnapshotStorage(Ring, Snapshot.Size);
+
+        memcpy(Ring->Storage + Snapshot.Offset, Ring->State, StateSize);
+        memcpy(Ring->Shadow, Ring->State, StateSize);
+
+        Ring->ShadowStateSize = StateSize;
+        Ring->SnapshotsSinceKeyframe = 0;
+    }
+    else
+    {
+        u32 *PageIndices = (u32 *)(Ring->Storage + Snapshot.Offset);
+        u8 *Pages = Ring->Storage + Snapshot.Offset + Snapshot.PageCount * sizeof(u32);
+
+        for (u32 DirtyIndex = 0; DirtyIndex < Snapshot.PageCount; ++DirtyIndex)
+        {
+            u32 PageIndex = Ring->DirtyPages[DirtyIndex];
+            memory_index PageOffset = PageIndex * SNAPSHOT_PAGE_SIZE;
+            memory_index PageSize = GetSnapshotPageSize(StateSize, PageIndex);
+
+            PageIndices[DirtyIndex] = PageIndex;
+            memcpy(Pages + DirtyIndex * SNAPSHOT_PAGE_SIZE, Ring->State + PageOffset, PageSize);
+            memcpy(Ring->Shadow + PageOffset, Ring->State + PageOffset, PageSize);
+        }
+
+        ++Ring->SnapshotsSinceKeyframe;
+    }
+
+    // note: ReserveSnapshotStorage may have evicted the oldest snapshots, so the slot is picked afterwards
+    ++Ring->SnapshotCount;
+    *GetSnapshot(Ring, Ring->SnapshotCount - 1) = Snapshot;
+
+    f32 CaptureMs = (f32)((Platform->GetWallClock() - StartTime) * 1000.0);
+
+    Ring->Stats.LastCaptureMs = CaptureMs;
+    Ring->Stats.FrameCaptureMs += CaptureMs;
+    Ring->Stats.LastCaptureSize = Snapshot.Size;
+    Ring->Stats.LastDirtyPageCount = Snapshot.PageCount;
+    ++Ring->Stats.CaptureCount;
+}
+
+inline void
+ApplySnapshotDelta(snapshot_ring *Ring, snapshot *Snapshot)
+{
+    u32 *PageIndices = (u32 *)(Ring->Storage + Snapshot->Offset);
+    u8 *Pages = Ring->Storage + Snapshot->Offset + Snapshot->PageCount * sizeof(u32);
+
+    for (u32 DirtyIndex = 0; DirtyIndex < Snapshot->PageCount; ++DirtyIndex)
+    {
+        memory_index PageOffset = PageIndices[DirtyIndex] * SNAPSHOT_PAGE_SIZE;
+        memory_index PageSize = GetSnapshotPageSize(Snapshot->StateSize, PageIndices[DirtyIndex]);
+
+        memcpy(Ring->Shadow + PageOffset, Pages + DirtyIndex * SNAPSHOT_PAGE_SIZE, PageSize);
+    }
+}
+
+// note: restores the snapshot StepsBack before the newest one and discards everything newer than it
+internal b32
+RestoreSnapshot(snapshot_ring *Ring, u32 StepsBack, platform_api *Platform)
+{
+    b32 Result = false;
+
+    if (Ring->SnapshotCount > 0)
+    {
+        f64 StartTime = Platform->GetWallClock();
+
+        u32 TargetIndex = StepsBack < Ring->SnapshotCount ? Ring->SnapshotCount - 1 - StepsBack : 0;
+
+        u32 KeyframeIndex = TargetIndex;
+        while (!GetSnapshot(Ring, KeyframeIndex)->IsKeyframe)
+        {
+            Assert(KeyframeIndex > 0);
+            --KeyframeIndex;
+        }
+
+        snapshot *Keyframe = GetSnapshot(Ring, KeyframeIndex);
+        memcpy(Ring->Shadow, Ring->Storage + Keyframe->Offset, Keyframe->StateSize);
+
+        for (u32 DeltaIndex = KeyframeIndex + 1; DeltaIndex <= TargetIndex; ++DeltaIndex)
+        {
+            ApplySnapshotDelta(Ring, GetSnapshot(Ring, DeltaIndex));
+        }
+
+        snapshot *Target = GetSnapshot(Ring, TargetIndex);
+        memcpy(Ring->State, Ring->Shadow, Target->StateSize);
+
+        // note: the shadow now matches the target, so the next capture can keep extending its delta chain
+        Ring->ShadowStateSize = Target->StateSize;
+        Ring->SnapshotsSinceKeyframe = TargetIndex - KeyframeIndex;
+        Ring->SnapshotCount = TargetIndex + 1;
+        Ring->WritePosition = Target->Offset + Target->Size;
+        Ring->TicksSinceSnapshot = 0;
+
+        Ring->Stats.LastRestoreMs = (f32)((Platform->GetWallClock() - StartTime) * 1000.0);
+
+        Result = true;
+    }
+
+    return Result;
+}
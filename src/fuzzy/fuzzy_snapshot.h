@@ -0,0 +1,62 @@
+#pragma once
+
+#define SNAPSHOT_PAGE_SIZE Kilobytes(4)
+
+struct snapshot
+{
+    u32 Tick;
+    b32 IsKeyframe;
+
+    // note: size of the permanent storage prefix this snapshot describes
+    memory_index StateSize;
+
+    memory_index Offset;
+    memory_index Size;
+
+    u32 PageCount;
+};
+
+struct snapshot_stats
+{
+    f32 FrameCaptureMs;
+    f32 LastCaptureMs;
+    f32 LastRestoreMs;
+
+    memory_index LastCaptureSize;
+    u32 LastDirtyPageCount;
+
+    u32 CaptureCount;
+    u32 SkippedCount;
+};
+
+// note: keyframes copy the whole used prefix of permanent storage, in-between snapshots store only pages that changed since the previous one
+struct snapshot_ring
+{
+    u8 *State;
+
+    // note: copy of the state as of the newest snapshot, dirty pages are found by diffing against it;
+    // reserved as big as the storage (no keyframe could be bigger) and committed as the state grows
+    memory_arena ShadowArena;
+    u8 *Shadow;
+    memory_index ShadowStateSize;
+
+    u32 *DirtyPages;
+
+    u8 *Storage;
+    memory_index StorageSize;
+    memory_index WritePosition;
+
+    u32 MaxSnapshotCount;
+    u32 FirstSnapshot;
+    u32 SnapshotCount;
+    snapshot *Snapshots;
+
+    u32 TicksPerSnapshot;
+    u32 SnapshotsPerKeyframe;
+
+    u32 Tick;
+    u32 TicksSinceSnapshot;
+    u32 SnapshotsSinceKeyframe;
+
+    snapshot_stats Stats;
+};
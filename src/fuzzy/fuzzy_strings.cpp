@@ -0,0 +1,49 @@
+#include "fuzzy_strings.h"
+
+inline b32
+InternedStringKeyComparator(interned_string *InternedString, string_id Key)
+{
+    b32 Result = InternedString->Id == Key;
+    return Result;
+}
+
+inline void
+InternedStringKeySetter(interned_string *InternedString, string_id Key)
+{
+    InternedString->Id = Key;
+}
+
+// note: the string is not copied, it has to live at least as long as the table
+internal string_id
+InternString(hash_table<interned_string> *Strings, char *String)
+{
+    string_id Result = Hash(String);
+
+    interned_string *InternedString = Get<interned_string, string_id>(Strings, Result, InternedStringKeyComparator);
+    if (InternedString)
+    {
+        // two different strings with the same id
+        Assert(StringEquals(InternedString->String, String));
+    }
+    else
+    {
+        InternedString = Create<interned_string, string_id>(Strings, Result, InternedStringKeySetter);
+        InternedString->String = String;
+    }
+
+    return Result;
+}
+
+inline char *
+GetInternedString(hash_table<interned_string> *Strings, string_id Id)
+{
+    char *Result = nullptr;
+
+    interned_string *InternedString = Get<interned_string, string_id>(Strings, Id, InternedStringKeyComparator);
+    if (InternedString)
+    {
+        Result = InternedString->String;
+    }
+
+    return Result;
+}
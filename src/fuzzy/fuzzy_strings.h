@@ -0,0 +1,17 @@
+#pragma once
+
+typedef u32 string_id;
+
+// note: consteval makes sure literal keys are hashed at compile time
+consteval string_id
+SID(const char *String)
+{
+    string_id Result = Hash(String);
+    return Result;
+}
+
+struct interned_string
+{
+    string_id Id;
+    char *String;
+};
@@ -51,13 +51,6 @@ TileMetaInfoKeyComparator(tile_meta_info *TileMetaInfo, u32 Key)
     return Result;
 }
 
-inline b32
-TileMetaInfoKeyExists(tile_meta_info *TileMetaInfo)
-{
-    b32 Result = (b32)TileMetaInfo->Id;
-    return Result;
-}
-
 inline void
 TileMetaInfoKeySetter(tile_meta_info *TileMetaInfo, u32 Key)
 {
@@ -71,20 +64,12 @@ GetTileMetaInfo(tileset *Tileset, u32 ID)
     return Result;
 }
 
-inline tile_meta_info *
-CreateTileMetaInfo(tileset *Tileset, u32 ID, memory_arena *Arena)
-{
-    tile_meta_info *Result = Create<tile_meta_info, u32>(
-        &Tileset->Tiles, ID, TileMetaInfoKeyExists, TileMetaInfoKeySetter, Arena);
-    return Result;
-}
-
+// note: the document lives in Region, so strings that must outlive the parsing should be copied
 internal DocumentType
 ParseJSON(const char *Json, u64 ValueBufferSize, u64 ParseBufferSize, memory_arena *Region) 
 {
-    // todo: temporary memory for document storage
-    void *ValueBuffer = PushSize(Region, ValueBufferSize);
-    void *ParseBuffer = PushSize(Region, ParseBufferSize);
+    void *ValueBuffer = PushSize(Region, ValueBufferSize, MEMORY_TAG_SCRATCH);
+    void *ParseBuffer = PushSize(Region, ParseBufferSize, MEMORY_TAG_SCRATCH);
 
     MemoryPoolAllocator<> ValueAllocator(ValueBuffer, ValueBufferSize);
     MemoryPoolAllocator<> ParseAllocator(ParseBuffer, ParseBufferSize);
@@ -96,12 +81,14 @@ ParseJSON(const char *Json, u64 ValueBufferSize, u64 ParseBufferSize, memory_are
 }
 
 internal void
-LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_api *Platform) 
+LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, memory_arena *ScratchArena, platform_api *Platform) 
 {
+    temporary_memory ParseMemory = BeginTemporaryMemory(ScratchArena);
+
     // todo: think more about the sizes
     constexpr u64 ValueBufferSize = Kilobytes(512);
     constexpr u64 ParseBufferSize = Kilobytes(32);
-    DocumentType Document = ParseJSON(Json, ValueBufferSize, ParseBufferSize, Arena);
+    DocumentType Document = ParseJSON(Json, ValueBufferSize, ParseBufferSize, ScratchArena);
 
     const char *ImagePath = Document["image"].GetString();
 
@@ -149,27 +136,33 @@ LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_ap
     Tileset->TilesetWidthPixelsToWorldUnits = Tileset->TileWidthInWorldUnits / Tileset->TileWidthInPixels;
     Tileset->TilesetHeightPixelsToWorldUnits = Tileset->TileHeightInWorldUnits / Tileset->TileHeightInPixels;
 
-    Tileset->Tiles.Count = Document["tilecount"].GetUint();
-    Tileset->Tiles.Values = PushArray<tile_meta_info>(Arena, Tileset->Tiles.Count);
-
     if (Document.HasMember("tiles")) 
     {
         const Value& Tiles = Document["tiles"];
         Assert(Tiles.IsArray());
 
+        // only tiles with extra info are listed, so the table is sized by them rather than by "tilecount"
+        u32 *TileIds = PushArray<u32>(ScratchArena, Tiles.Size(), MEMORY_TAG_SCRATCH);
+        for (SizeType TileIndex = 0; TileIndex < Tiles.Size(); ++TileIndex) 
+        {
+            TileIds[TileIndex] = Tiles[TileIndex]["id"].GetUint();
+        }
+
+        BuildHashTable(&Tileset->Tiles, TileIds, Tiles.Size(), TileMetaInfoKeySetter, Arena, MEMORY_TAG_TILEMAP);
+
         for (SizeType TileIndex = 0; TileIndex < Tiles.Size(); ++TileIndex) 
         {
             const Value& Tile = Tiles[TileIndex];
 
             u32 TileId = Tile["id"].GetUint();
 
-            tile_meta_info *TileInfo = CreateTileMetaInfo(Tileset, TileId, Arena);
+            tile_meta_info *TileInfo = GetTileMetaInfo(Tileset, TileId);
             TileInfo->BoxCount = 0;
             TileInfo->AnimationFrameCount = 0;
 
             if (Tile.HasMember("type"))
             {
-                TileInfo->Type = const_cast<char*>(Tile["type"].GetString());
+                TileInfo->Type = PushStringCopy(Arena, Tile["type"].GetString(), MEMORY_TAG_TILEMAP);
             }
 
             if (Tile.HasMember("objectgroup")) 
@@ -179,7 +172,7 @@ LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_ap
                 Assert(TileObjects.IsArray());
 
                 TileInfo->BoxCount = TileObjects.Size();
-                TileInfo->Boxes = PushArray<aabb>(Arena, TileInfo->BoxCount);
+                TileInfo->Boxes = PushArray<aabb>(Arena, TileInfo->BoxCount, MEMORY_TAG_TILEMAP);
 
                 for (SizeType ObjectIndex = 0; ObjectIndex < TileObjects.Size(); ++ObjectIndex) 
                 {
@@ -202,7 +195,7 @@ LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_ap
                 Assert(Animation.IsArray());
 
                 TileInfo->AnimationFrameCount = Animation.Size();
-                TileInfo->AnimationFrames = PushArray<tile_animation_frame>(Arena, TileInfo->AnimationFrameCount);
+                TileInfo->AnimationFrames = PushArray<tile_animation_frame>(Arena, TileInfo->AnimationFrameCount, MEMORY_TAG_TILEMAP);
 
                 for (SizeType AnimationFrameIndex = 0; AnimationFrameIndex < Animation.Size(); ++AnimationFrameIndex) 
                 {
@@ -221,7 +214,7 @@ LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_ap
                 Assert(CustomTileProperties.IsArray());
 
                 TileInfo->CustomPropertiesCount = CustomTileProperties.Size();
-                TileInfo->CustomProperties = PushArray<tile_custom_property>(Arena, TileInfo->CustomPropertiesCount);
+                TileInfo->CustomProperties = PushArray<tile_custom_property>(Arena, TileInfo->CustomPropertiesCount, MEMORY_TAG_TILEMAP);
 
                 if (CustomTileProperties.IsArray())
                 {
@@ -232,28 +225,28 @@ LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_ap
                         tile_custom_property *CustomTileProperty = TileInfo->CustomProperties + CustomTilePropertyIndex;
 
                         *CustomTileProperty = {};
-                        CustomTileProperty->Name = const_cast<char*>(CustomTilePropertyValue["name"].GetString());
-                        CustomTileProperty->Type = const_cast<char*>(CustomTilePropertyValue["type"].GetString());
+                        CustomTileProperty->Name = PushStringCopy(Arena, CustomTilePropertyValue["name"].GetString(), MEMORY_TAG_TILEMAP);
+                        CustomTileProperty->Type = PushStringCopy(Arena, CustomTilePropertyValue["type"].GetString(), MEMORY_TAG_TILEMAP);
 
                         if (StringEquals(CustomTileProperty->Type, "string"))
                         {
                             u32 StringLength = CustomTilePropertyValue["value"].GetStringLength() + 1;
-                            CustomTileProperty->Value = PushString(Arena, StringLength);
+                            CustomTileProperty->Value = PushString(Arena, StringLength, MEMORY_TAG_TILEMAP);
                             CopyString(CustomTilePropertyValue["value"].GetString(), (char *)CustomTileProperty->Value, StringLength);
                         }
                         else if (StringEquals(CustomTileProperty->Type, "float"))
                         {
-                            CustomTileProperty->Value = PushSize(Arena, sizeof(f32));
+                            CustomTileProperty->Value = PushSize(Arena, sizeof(f32), MEMORY_TAG_TILEMAP);
                             *(f32 *)CustomTileProperty->Value = CustomTilePropertyValue["value"].GetFloat();
                         }
                         else if (StringEquals(CustomTileProperty->Type, "int"))
                         {
-                            CustomTileProperty->Value = PushSize(Arena, sizeof(i32));
+                            CustomTileProperty->Value = PushSize(Arena, sizeof(i32), MEMORY_TAG_TILEMAP);
                             *(i32 *)CustomTileProperty->Value = CustomTilePropertyValue["value"].GetInt();
                         }
                         else if (StringEquals(CustomTileProperty->Type, "bool"))
                         {
-                            CustomTileProperty->Value = PushSize(Arena, sizeof(b32));
+                            CustomTileProperty->Value = PushSize(Arena, sizeof(b32), MEMORY_TAG_TILEMAP);
                             *(b32 *)CustomTileProperty->Value = CustomTilePropertyValue["value"].GetBool();
                         }
                         else
@@ -266,15 +259,23 @@ LoadTileset(tileset *Tileset, const char *Json, memory_arena *Arena, platform_ap
             }
         }
     }
+    else
+    {
+        InitializeHashTable(&Tileset->Tiles, 0, Arena, MEMORY_TAG_TILEMAP);
+    }
+
+    EndTemporaryMemory(ParseMemory);
 }
 
 internal void
-LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platform) 
+LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, memory_arena *ScratchArena, platform_api *Platform) 
 {
+    temporary_memory ParseMemory = BeginTemporaryMemory(ScratchArena);
+
     // todo: think more about the sizes
     constexpr u64 ValueBufferSize = Megabytes(32);
     constexpr u64 ParseBufferSize = Megabytes(1);
-    DocumentType Document = ParseJSON(Json, ValueBufferSize, ParseBufferSize, Arena);
+    DocumentType Document = ParseJSON(Json, ValueBufferSize, ParseBufferSize, ScratchArena);
 
     Assert(Document.HasMember("tilesets"));
 
@@ -282,7 +283,7 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
     const Value& Tileset = Document["tilesets"].GetArray()[0];
 
     Map->TilesetCount = 1;
-    Map->Tilesets = PushArray<tileset_source>(Arena, Map->TilesetCount);
+    Map->Tilesets = PushArray<tileset_source>(Arena, Map->TilesetCount, MEMORY_TAG_TILEMAP);
     Map->Tilesets[0].FirstGID = Tileset["firstgid"].GetUint();
 
     char *TilesetSource = const_cast<char*>(Tileset["source"].GetString());
@@ -291,10 +292,12 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
     char FullTilesetPath[256];
     FormatString(FullTilesetPath, sizeof(FullTilesetPath), "%s%s", "tilesets/", TilesetPath);
 
-    char *TilesetJson = (char*)Platform->ReadFile(FullTilesetPath).Contents;
+    read_file_result TilesetFile = Platform->ReadFile(FullTilesetPath);
 
     Map->Tilesets[0].Source = {};
-    LoadTileset(&Map->Tilesets[0].Source, TilesetJson, Arena, Platform);
+    LoadTileset(&Map->Tilesets[0].Source, (char *)TilesetFile.Contents, Arena, ScratchArena, Platform);
+
+    Platform->FreeFile(TilesetFile);
 
     const Value& Layers = Document["layers"];
     Assert(Layers.IsArray());
@@ -322,10 +325,10 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
     }
 
     Map->TileLayerCount = TileLayerCount;
-    Map->TileLayers = PushArray<tile_layer>(Arena, Map->TileLayerCount);
+    Map->TileLayers = PushArray<tile_layer>(Arena, Map->TileLayerCount, MEMORY_TAG_TILEMAP);
 
     Map->ObjectLayerCount = ObjectGroupCount;
-    Map->ObjectLayers = PushArray<object_layer>(Arena, Map->ObjectLayerCount);
+    Map->ObjectLayers = PushArray<object_layer>(Arena, Map->ObjectLayerCount, MEMORY_TAG_TILEMAP);
 
     u32 TileLayerIndex = 0;
     u32 ObjectLayerIndex = 0;
@@ -351,7 +354,7 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
             Assert(Chunks.IsArray());
 
             TileLayer->ChunkCount = Chunks.Size();
-            TileLayer->Chunks = PushArray<map_chunk>(Arena, TileLayer->ChunkCount);
+            TileLayer->Chunks = PushArray<map_chunk>(Arena, TileLayer->ChunkCount, MEMORY_TAG_TILEMAP);
 
             for (SizeType ChunkIndex = 0; ChunkIndex < Chunks.Size(); ++ChunkIndex)
             {
@@ -369,7 +372,7 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
                 Assert(ChunkData.IsArray());
 
                 MapChunk->GIDCount = ChunkData.Size();
-                MapChunk->GIDs = PushArray<u32>(Arena, MapChunk->GIDCount);
+                MapChunk->GIDs = PushArray<u32>(Arena, MapChunk->GIDCount, MEMORY_TAG_TILEMAP);
 
                 for (SizeType ChunkDataIndex = 0; ChunkDataIndex < ChunkData.Size(); ++ChunkDataIndex)
                 {
@@ -389,7 +392,7 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
             Assert(Objects.IsArray());
 
             ObjectLayer->ObjectCount = Objects.Size();
-            ObjectLayer->Objects = PushArray<map_object>(Arena, ObjectLayer->ObjectCount);
+            ObjectLayer->Objects = PushArray<map_object>(Arena, ObjectLayer->ObjectCount, MEMORY_TAG_TILEMAP);
 
             for (SizeType ObjectIndex = 0; ObjectIndex < Objects.Size(); ++ObjectIndex) 
             {
@@ -432,4 +435,6 @@ LoadMap(tilemap *Map, const char *Json, memory_arena *Arena, platform_api *Platf
             InvalidCodePath;
         }
     }
+
+    EndTemporaryMemory(ParseMemory);
 }
@@ -52,8 +52,6 @@ struct tile_meta_info
 
     u32 CustomPropertiesCount;
     tile_custom_property *CustomProperties;
-
-    tile_meta_info *Next;
 };
 
 struct tileset
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "fuzzy_types.h"
+
+// note: implemented by the platform layer, the game only ever sees the opaque queue
+struct platform_work_queue;
+
+#define PLATFORM_WORK_QUEUE_CALLBACK(name) void name(platform_work_queue *Queue, void *Data)
+typedef PLATFORM_WORK_QUEUE_CALLBACK(platform_work_queue_callback);
+
+// note: game thread only, the entry may start running on a worker right away
+#define PLATFORM_ADD_WORK_ENTRY(name) void name(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+typedef PLATFORM_ADD_WORK_ENTRY(platform_add_work_entry);
+
+// note: the game thread works through the queue as well and returns once every entry added so far has finished
+#define PLATFORM_COMPLETE_ALL_WORK(name) void name(platform_work_queue *Queue)
+typedef PLATFORM_COMPLETE_ALL_WORK(platform_complete_all_work);
+
+struct work_queue
+{
+    platform_work_queue *Queue;
+    // note: threads besides the game thread, 0 means there is no point in splitting work
+    u32 WorkerCount;
+
+    platform_add_work_entry *AddEntry;
+    platform_complete_all_work *CompleteAllWork;
+};
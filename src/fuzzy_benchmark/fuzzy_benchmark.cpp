@@ -0,0 +1,2027 @@
+// Standalone microbenchmarks for the containers, the arena, hashing and the rng, plus a replay determinism check.
+// Only depends on the platform independent part of the game code, so it builds on Linux as well:
+//   g++ -O2 -std=c++20 -pthread -Iexternals/glm -Isrc/fuzzy src/fuzzy_benchmark/fuzzy_benchmark.cpp -o fuzzy_benchmark
+// or with the CMakeLists.txt next to this file, -DFUZZY_FIXED_POINT=ON stands for the define below
+// the avx2 kernels are built in on x64 and only run (and get checked) when the cpu has avx2
+// with -DFUZZY_FIXED_POINT=1 the replay hash has to match BENCHMARK_REPLAY_HASH at every optimization level (-O0 / -O2 / -O3 -ffast-math),
+// a mismatch is reported and makes the tool exit with 1, and so does a sweep kernel or the tile grid query disagreeing with SweptAABB,
+// or the physics step coming out different on the worker threads than on one thread, or the memory pool not reusing or skipping freed slots,
+// or the mpsc queue losing a value or handing out a producer's values out of order
+// Usage: fuzzy_benchmark [output.json]
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "fuzzy_types.h"
+#include "fuzzy_memory.h"
+
+#include "fuzzy_math.cpp"
+#include "fuzzy_random.cpp"
+#include "fuzzy_containers.cpp"
+#include "fuzzy_physics.cpp"
+#include "fuzzy_platform_work_queue.h"
+
+#define BENCHMARK_WARMUP_RUNS 5
+#define BENCHMARK_RUNS 101
+#define BENCHMARK_MAX_RESULTS 64
+#define BENCHMARK_MAX_PRODUCERS 16
+
+#define BENCHMARK_ARENA_SIZE Megabytes(256)
+
+#define BENCHMARK_REPLAY_TICKS 600
+// note: only meaningful for the fixed-point build, update it whenever StepBody intentionally changes
+#define BENCHMARK_REPLAY_HASH 0x8995B7747B2DB6D4ull
+
+struct benchmark_result
+{
+    const char *Name;
+
+    u32 OperationsPerRun;
+    u32 RunCount;
+
+    f64 MedianNsPerOperation;
+    f64 P99NsPerOperation;
+    f64 MinNsPerOperation;
+};
+
+struct benchmark_context
+{
+    memory_arena Arena;
+    random_sequence Entropy;
+
+    // note: everything a benchmark computes ends up here and gets printed, so the compiler can't drop the work
+    u64 Sink;
+
+    std::chrono::steady_clock::time_point TimerStart;
+    f64 ElapsedNs;
+
+    u32 ResultCount;
+    benchmark_result Results[BENCHMARK_MAX_RESULTS];
+};
+
+typedef void benchmark_function(benchmark_context *Context, u32 OperationCount);
+
+// note: benchmarks time only their measured part, setup before StartTimer isn't counted
+inline void
+StartTimer(benchmark_context *Context)
+{
+    Context->TimerStart = std::chrono::steady_clock::now();
+}
+
+inline void
+StopTimer(benchmark_context *Context)
+{
+    std::chrono::duration<f64, std::nano> Elapsed = std::chrono::steady_clock::now() - Context->TimerStart;
+    Context->ElapsedNs = Elapsed.count();
+}
+
+internal void
+RunBenchmark(benchmark_context *Context, const char *Name, benchmark_function *Function, u32 OperationCount)
+{
+    Assert(Context->ResultCount < BENCHMARK_MAX_RESULTS);
+
+    f64 Samples[BENCHMARK_RUNS];
+
+    for (u32 RunIndex = 0; RunIndex < BENCHMARK_WARMUP_RUNS + BENCHMARK_RUNS; ++RunIndex)
+    {
+        temporary_memory RunMemory = BeginTemporaryMemory(&Context->Arena);
+
+        Context->ElapsedNs = 0.0;
+        Function(Context, OperationCount);
+
+        EndTemporaryMemory(RunMemory);
+
+        if (RunIndex >= BENCHMARK_WARMUP_RUNS)
+        {
+            Samples[RunIndex - BENCHMARK_WARMUP_RUNS] = Context->ElapsedNs / OperationCount;
+        }
+    }
+
+    std::sort(Samples, Samples + BENCHMARK_RUNS);
+
+    benchmark_result *Result = Context->Results + Context->ResultCount++;
+    Result->Name = Name;
+    Result->OperationsPerRun = OperationCount;
+    Result->RunCount = BENCHMARK_RUNS;
+    Result->MedianNsPerOperation = Samples[BENCHMARK_RUNS / 2];
+    Result->P99NsPerOperation = Samples[(BENCHMARK_RUNS * 99 + 99) / 100 - 1];
+    Result->MinNsPerOperation = Samples[0];
+
+    printf("%-32s %10.2f %10.2f %10.2f\n", Name, Result->MedianNsPerOperation, Result->P99NsPerOperation, Result->MinNsPerOperation);
+}
+
+internal b32
+WriteResultsJson(benchmark_context *Context, const char *FileName)
+{
+    FILE *File = fopen(FileName, "w");
+
+    if (!File)
+    {
+        return false;
+    }
+
+    fprintf(File, "{\n  \"warmup_runs\": %u,\n  \"benchmarks\": [\n", BENCHMARK_WARMUP_RUNS);
+
+    for (u32 ResultIndex = 0; ResultIndex < Context->ResultCount; ++ResultIndex)
+    {
+        benchmark_result *Result = Context->Results + ResultIndex;
+
+        fprintf(File,
+            "    {\"name\": \"%s\", \"operations_per_run\": %u, \"runs\": %u, "
+            "\"median_ns_per_op\": %.3f, \"p99_ns_per_op\": %.3f, \"min_ns_per_op\": %.3f}%s\n",
+            Result->Name, Result->OperationsPerRun, Result->RunCount,
+            Result->MedianNsPerOperation, Result->P99NsPerOperation, Result->MinNsPerOperation,
+            ResultIndex + 1 < Context->ResultCount ? "," : "");
+    }
+
+    fprintf(File, "  ]\n}\n");
+    fclose(File);
+
+    return true;
+}
+
+#pragma region Keys
+struct benchmark_entry
+{
+    u32 Key;
+    u32 Value;
+};
+
+inline b32
+BenchmarkEntryKeyComparator(benchmark_entry *Entry, u32 Key)
+{
+    b32 Result = Entry->Key == Key;
+    return Result;
+}
+
+inline void
+BenchmarkEntryKeySetter(benchmark_entry *Entry, u32 Key)
+{
+    Entry->Key = Key;
+}
+
+// note: distinct keys in random order, 0 excluded
+internal u32 *
+PushRandomKeys(benchmark_context *Context, u32 Count)
+{
+    u32 *Result = PushArray<u32>(&Context->Arena, Count);
+
+    for (u32 KeyIndex = 0; KeyIndex < Count; ++KeyIndex)
+    {
+        Result[KeyIndex] = KeyIndex + 1;
+    }
+
+    for (u32 KeyIndex = Count - 1; KeyIndex > 0; --KeyIndex)
+    {
+        u32 SwapIndex = RandomNextU32(&Context->Entropy) % (KeyIndex + 1);
+        std::swap(Result[KeyIndex], Result[SwapIndex]);
+    }
+
+    return Result;
+}
+
+internal char **
+PushRandomStrings(benchmark_context *Context, u32 Count, u32 Length)
+{
+    char **Result = PushArray<char *>(&Context->Arena, Count);
+
+    for (u32 StringIndex = 0; StringIndex < Count; ++StringIndex)
+    {
+        char *String = PushString(&Context->Arena, Length + 1);
+
+        for (u32 CharIndex = 0; CharIndex < Length; ++CharIndex)
+        {
+            String[CharIndex] = 'A' + (char)(RandomNextU32(&Context->Entropy) % 26);
+        }
+
+        String[Length] = 0;
+        Result[StringIndex] = String;
+    }
+
+    return Result;
+}
+#pragma endregion
+
+#pragma region Hashing and rng
+internal void
+BenchmarkHashU32(benchmark_context *Context, u32 OperationCount)
+{
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Accumulator += Hash(Index ^ Accumulator);
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+internal void
+BenchmarkHashString(benchmark_context *Context, u32 OperationCount)
+{
+    char **Strings = PushRandomStrings(Context, OperationCount, 16);
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Accumulator += Hash(Strings[Index]);
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+internal void
+BenchmarkRandomNextU32(benchmark_context *Context, u32 OperationCount)
+{
+    random_sequence Sequence = RandomSequence(0x9E3779B9);
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Accumulator += RandomNextU32(&Sequence);
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+internal void
+BenchmarkRandomBetweenScalar(benchmark_context *Context, u32 OperationCount)
+{
+    random_sequence Sequence = RandomSequence(0x9E3779B9);
+    f32 *Values = PushArray<f32>(&Context->Arena, OperationCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Values[Index] = RandomBetween(&Sequence, 0.75f, 1.f);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)Values[OperationCount - 1];
+}
+
+// note: one operation is one value, so the lane paths compare directly against the scalar generator
+internal void
+BenchmarkRandomLanesScalar(benchmark_context *Context, u32 OperationCount)
+{
+    random_lanes Lanes = RandomLanes(0x9E3779B9);
+    f32 *Values = PushArray<f32>(&Context->Arena, OperationCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index + RANDOM_LANE_COUNT <= OperationCount; Index += RANDOM_LANE_COUNT)
+    {
+        RandomNextLanes01Scalar(&Lanes, Values + Index);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)Values[0];
+}
+
+#if FUZZY_SSE2
+internal void
+BenchmarkRandomLanesSSE2(benchmark_context *Context, u32 OperationCount)
+{
+    random_lanes Lanes = RandomLanes(0x9E3779B9);
+    f32 *Values = PushArray<f32>(&Context->Arena, OperationCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index + RANDOM_LANE_COUNT <= OperationCount; Index += RANDOM_LANE_COUNT)
+    {
+        RandomNextLanes01SSE2(&Lanes, Values + Index);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)Values[0];
+}
+#endif
+
+#if FUZZY_AVX2
+internal void
+BenchmarkRandomLanesAVX2(benchmark_context *Context, u32 OperationCount)
+{
+    random_lanes Lanes = RandomLanes(0x9E3779B9);
+    f32 *Values = PushArray<f32>(&Context->Arena, OperationCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index + RANDOM_LANE_COUNT <= OperationCount; Index += RANDOM_LANE_COUNT)
+    {
+        RandomNextLanes01AVX2(&Lanes, Values + Index);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)Values[0];
+}
+#endif
+
+internal void
+BenchmarkRandomFillBetween(benchmark_context *Context, u32 OperationCount)
+{
+    random_lanes Lanes = RandomLanes(0x9E3779B9);
+    f32 *Values = PushArray<f32>(&Context->Arena, OperationCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    StartTimer(Context);
+    RandomFillBetween(&Lanes, Values, OperationCount, 0.75f, 1.f);
+    StopTimer(Context);
+
+    Context->Sink += (u64)Values[OperationCount - 1];
+}
+#pragma endregion
+
+#pragma region Instance transforms
+struct benchmark_instances
+{
+    f32 *X;
+    f32 *Y;
+    f32 *Width;
+    f32 *Height;
+
+    mat4 *Models;
+    instance_transform *Transforms;
+};
+
+internal benchmark_instances
+PushRandomInstances(benchmark_context *Context, u32 Count)
+{
+    benchmark_instances Result = {};
+    Result.X = PushArray<f32>(&Context->Arena, Count, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result.Y = PushArray<f32>(&Context->Arena, Count, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result.Width = PushArray<f32>(&Context->Arena, Count, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result.Height = PushArray<f32>(&Context->Arena, Count, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result.Models = PushArray<mat4>(&Context->Arena, Count, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result.Transforms = PushArray<instance_transform>(&Context->Arena, Count, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    for (u32 Index = 0; Index < Count; ++Index)
+    {
+        Result.X[Index] = (f32)(RandomNextU32(&Context->Entropy) % 1024);
+        Result.Y[Index] = (f32)(RandomNextU32(&Context->Entropy) % 1024);
+        Result.Width[Index] = 1.f + (f32)(RandomNextU32(&Context->Entropy) % 4);
+        Result.Height[Index] = 1.f + (f32)(RandomNextU32(&Context->Entropy) % 4);
+    }
+
+    return Result;
+}
+
+// note: the mat4 per instance path the game used before the compact transforms
+internal void
+BenchmarkInstanceModelsGlm(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_instances Instances = PushRandomInstances(Context, OperationCount);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        mat4 *Model = Instances.Models + Index;
+
+        *Model = mat4(1.f);
+        *Model = translate(*Model, vec3(Instances.X[Index], Instances.Y[Index], 0.f));
+        *Model = scale(*Model, vec3(Instances.Width[Index], Instances.Height[Index], 0.f));
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)Instances.Models[OperationCount - 1][3][0];
+}
+
+internal void
+BenchmarkInstanceTransformsScalar(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_instances Instances = PushRandomInstances(Context, OperationCount);
+
+    StartTimer(Context);
+    BuildInstanceTransformsScalar(
+        OperationCount, Instances.X, Instances.Y, Instances.Width, Instances.Height, Instances.Transforms, sizeof(instance_transform));
+    StopTimer(Context);
+
+    Context->Sink += (u64)Instances.Transforms[OperationCount - 1].Position.x;
+}
+
+#if FUZZY_SSE2
+internal void
+BenchmarkInstanceTransformsSSE2(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_instances Instances = PushRandomInstances(Context, OperationCount);
+
+    StartTimer(Context);
+    BuildInstanceTransformsSSE2(
+        OperationCount, Instances.X, Instances.Y, Instances.Width, Instances.Height, Instances.Transforms, sizeof(instance_transform));
+    StopTimer(Context);
+
+    Context->Sink += (u64)Instances.Transforms[OperationCount - 1].Position.x;
+}
+#endif
+
+#if FUZZY_AVX2
+internal void
+BenchmarkInstanceTransformsAVX2(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_instances Instances = PushRandomInstances(Context, OperationCount);
+
+    StartTimer(Context);
+    BuildInstanceTransformsAVX2(
+        OperationCount, Instances.X, Instances.Y, Instances.Width, Instances.Height, Instances.Transforms, sizeof(instance_transform));
+    StopTimer(Context);
+
+    Context->Sink += (u64)Instances.Transforms[OperationCount - 1].Position.x;
+}
+#endif
+#pragma endregion
+
+#pragma region Arena
+internal void
+BenchmarkPushSize(benchmark_context *Context, u32 OperationCount)
+{
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        u8 *Memory = (u8 *)PushSize(&Context->Arena, 24, MEMORY_TAG_UNTAGGED, 8);
+        Memory[0] = (u8)Index;
+    }
+    StopTimer(Context);
+
+    Context->Sink += Context->Arena.Used;
+}
+
+internal void
+BenchmarkPushSizeAligned(benchmark_context *Context, u32 OperationCount)
+{
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        u8 *Memory = (u8 *)PushSize(&Context->Arena, 24, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+        Memory[0] = (u8)Index;
+    }
+    StopTimer(Context);
+
+    Context->Sink += Context->Arena.Used;
+}
+#pragma endregion
+
+#pragma region Hash table
+internal void
+BenchmarkHashTableCreate(benchmark_context *Context, u32 OperationCount)
+{
+    u32 *Keys = PushRandomKeys(Context, OperationCount);
+
+    hash_table<benchmark_entry> Table;
+    InitializeHashTable(&Table, OperationCount, &Context->Arena);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        benchmark_entry *Entry = Create<benchmark_entry, u32>(&Table, Keys[Index], BenchmarkEntryKeySetter);
+        Entry->Value = Index;
+    }
+    StopTimer(Context);
+
+    Context->Sink += Table.Count;
+}
+
+internal void
+BenchmarkHashTableBuild(benchmark_context *Context, u32 OperationCount)
+{
+    u32 *Keys = PushRandomKeys(Context, OperationCount);
+
+    hash_table<benchmark_entry> Table;
+
+    StartTimer(Context);
+    BuildHashTable(&Table, Keys, OperationCount, BenchmarkEntryKeySetter, &Context->Arena);
+    StopTimer(Context);
+
+    Context->Sink += Table.Count;
+}
+
+internal void
+BenchmarkHashTableGet(benchmark_context *Context, u32 OperationCount, b32 Hit)
+{
+    u32 *Keys = PushRandomKeys(Context, OperationCount * 2);
+
+    hash_table<benchmark_entry> Table;
+    BuildHashTable(&Table, Keys, OperationCount, BenchmarkEntryKeySetter, &Context->Arena);
+
+    // note: the second half of the keys was never inserted
+    u32 *LookupKeys = Hit ? Keys : Keys + OperationCount;
+    u32 FoundCount = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        benchmark_entry *Entry = Get<benchmark_entry, u32>(&Table, LookupKeys[Index], BenchmarkEntryKeyComparator);
+        FoundCount += Entry != nullptr;
+    }
+    StopTimer(Context);
+
+    Assert(FoundCount == (Hit ? OperationCount : 0));
+    Context->Sink += FoundCount;
+}
+
+internal void
+BenchmarkHashTableGetHit(benchmark_context *Context, u32 OperationCount)
+{
+    BenchmarkHashTableGet(Context, OperationCount, true);
+}
+
+internal void
+BenchmarkHashTableGetMiss(benchmark_context *Context, u32 OperationCount)
+{
+    BenchmarkHashTableGet(Context, OperationCount, false);
+}
+#pragma endregion
+
+#pragma region Chained hash table
+// note: the chained table hash_table replaced, kept as the baseline for the hash table cases:
+// one bucket per entry, modulo indexing, collisions chained off the bucket into nodes pushed on demand
+struct chained_benchmark_entry
+{
+    u32 Key;
+    u32 Value;
+
+    chained_benchmark_entry *Next;
+};
+
+struct chained_hash_table
+{
+    u32 Count;
+    chained_benchmark_entry *Values;
+};
+
+internal void
+InitializeChainedHashTable(chained_hash_table *HashTable, u32 Count, memory_arena *Arena)
+{
+    HashTable->Count = Count;
+    HashTable->Values = PushArray<chained_benchmark_entry>(Arena, Count);
+
+    memset(HashTable->Values, 0, Count * sizeof(chained_benchmark_entry));
+}
+
+internal chained_benchmark_entry *
+Get(chained_hash_table *HashTable, u32 Key)
+{
+    chained_benchmark_entry *Result = nullptr;
+    chained_benchmark_entry *Value = HashTable->Values + Hash(Key) % HashTable->Count;
+
+    do
+    {
+        if (Value->Key == Key)
+        {
+            Result = Value;
+            break;
+        }
+
+        Value = Value->Next;
+    }
+    while (Value);
+
+    return Result;
+}
+
+internal chained_benchmark_entry *
+Create(chained_hash_table *HashTable, u32 Key, memory_arena *Arena)
+{
+    chained_benchmark_entry *Result = nullptr;
+    chained_benchmark_entry *Value = HashTable->Values + Hash(Key) % HashTable->Count;
+
+    do
+    {
+        if (!Value->Key)
+        {
+            Result = Value;
+            Result->Key = Key;
+            break;
+        }
+
+        if (!Value->Next)
+        {
+            Value->Next = PushStruct<chained_benchmark_entry>(Arena);
+            *Value->Next = {};
+        }
+
+        Value = Value->Next;
+    }
+    while (Value);
+
+    return Result;
+}
+
+internal void
+BenchmarkChainedHashTableCreate(benchmark_context *Context, u32 OperationCount)
+{
+    u32 *Keys = PushRandomKeys(Context, OperationCount);
+
+    chained_hash_table Table;
+    InitializeChainedHashTable(&Table, OperationCount, &Context->Arena);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        chained_benchmark_entry *Entry = Create(&Table, Keys[Index], &Context->Arena);
+        Entry->Value = Index;
+    }
+    StopTimer(Context);
+
+    Context->Sink += Table.Values[0].Value;
+}
+
+internal void
+BenchmarkChainedHashTableGet(benchmark_context *Context, u32 OperationCount, b32 Hit)
+{
+    u32 *Keys = PushRandomKeys(Context, OperationCount * 2);
+
+    chained_hash_table Table;
+    InitializeChainedHashTable(&Table, OperationCount, &Context->Arena);
+
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Create(&Table, Keys[Index], &Context->Arena)->Value = Index;
+    }
+
+    // note: the second half of the keys was never inserted
+    u32 *LookupKeys = Hit ? Keys : Keys + OperationCount;
+    u32 FoundCount = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        chained_benchmark_entry *Entry = Get(&Table, LookupKeys[Index]);
+        FoundCount += Entry != nullptr;
+    }
+    StopTimer(Context);
+
+    Assert(FoundCount == (Hit ? OperationCount : 0));
+    Context->Sink += FoundCount;
+}
+
+internal void
+BenchmarkChainedHashTableGetHit(benchmark_context *Context, u32 OperationCount)
+{
+    BenchmarkChainedHashTableGet(Context, OperationCount, true);
+}
+
+internal void
+BenchmarkChainedHashTableGetMiss(benchmark_context *Context, u32 OperationCount)
+{
+    BenchmarkChainedHashTableGet(Context, OperationCount, false);
+}
+#pragma endregion
+
+#pragma region Stack and queues
+internal void
+BenchmarkStackPushPop(benchmark_context *Context, u32 OperationCount)
+{
+    stack<u32> Stack = {};
+    Stack.MaxCount = OperationCount + 1;
+    Stack.Values = PushArray<u32>(&Context->Arena, Stack.MaxCount);
+
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Push(&Stack, Index);
+    }
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Accumulator += Pop(&Stack);
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+internal void
+BenchmarkQueueEnqueueDequeue(benchmark_context *Context, u32 OperationCount)
+{
+    queue<u32> Queue = {};
+    Queue.MaxCount = 1024;
+    Queue.Values = PushArray<u32>(&Context->Arena, Queue.MaxCount);
+
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Enqueue(&Queue, Index);
+
+        if ((Index & 511) == 511)
+        {
+            while (Queue.Head != Queue.Tail)
+            {
+                Accumulator += Dequeue(&Queue);
+            }
+        }
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+internal void
+BenchmarkMpscQueueSingleThread(benchmark_context *Context, u32 OperationCount)
+{
+    mpsc_queue<u32> *Queue = PushStruct<mpsc_queue<u32>>(&Context->Arena);
+    InitializeMpscQueue(Queue, 1024, &Context->Arena);
+
+    u32 Batch[512];
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        TryEnqueue(Queue, Index);
+
+        if ((Index & 511) == 511)
+        {
+            u32 Count = DequeueBatch(Queue, Batch, 512);
+
+            for (u32 BatchIndex = 0; BatchIndex < Count; ++BatchIndex)
+            {
+                Accumulator += Batch[BatchIndex];
+            }
+        }
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+// note: values carry the producer in the high bits and its running sequence number in the low ones
+#define MPSC_SEQUENCE_BITS 24
+#define MPSC_SEQUENCE_MASK ((1u << MPSC_SEQUENCE_BITS) - 1)
+
+internal void
+MpscProducer(mpsc_queue<u32> *Queue, u32 ProducerIndex, u32 OperationCount, std::atomic<u32> *FinishedCount)
+{
+    for (u32 Sequence = 0; Sequence < OperationCount;)
+    {
+        if (TryEnqueue(Queue, (ProducerIndex << MPSC_SEQUENCE_BITS) | Sequence))
+        {
+            ++Sequence;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    FinishedCount->fetch_add(1, std::memory_order_release);
+}
+
+// note: the consumer runs on the calling thread, every producer's values have to arrive in the order they were enqueued,
+// returns the number of values that came out of order or from an unknown producer plus the ones that never arrived
+internal u32
+RunContendedMpscQueue(mpsc_queue<u32> *Queue, u32 ProducerCount, u32 OperationsPerProducer)
+{
+    Assert(ProducerCount <= BENCHMARK_MAX_PRODUCERS);
+    Assert(OperationsPerProducer <= MPSC_SEQUENCE_MASK);
+
+    std::thread Producers[BENCHMARK_MAX_PRODUCERS];
+    u32 NextSequences[BENCHMARK_MAX_PRODUCERS] = {};
+    std::atomic<u32> FinishedCount = 0;
+
+    u32 TotalCount = OperationsPerProducer * ProducerCount;
+    u32 Batch[256];
+    u32 ReceivedCount = 0;
+    u32 ErrorCount = 0;
+
+    for (u32 ProducerIndex = 0; ProducerIndex < ProducerCount; ++ProducerIndex)
+    {
+        Producers[ProducerIndex] = std::thread(MpscProducer, Queue, ProducerIndex, OperationsPerProducer, &FinishedCount);
+    }
+
+    while (ReceivedCount < TotalCount)
+    {
+        // note: checked before dequeuing, once every producer is done an empty queue means the missing values are lost
+        b32 ProducersAreDone = FinishedCount.load(std::memory_order_acquire) == ProducerCount;
+        u32 Count = DequeueBatch(Queue, Batch, 256);
+
+        if (!Count)
+        {
+            if (ProducersAreDone)
+            {
+                break;
+            }
+
+            std::this_thread::yield();
+        }
+
+        for (u32 BatchIndex = 0; BatchIndex < Count; ++BatchIndex)
+        {
+            u32 ProducerIndex = Batch[BatchIndex] >> MPSC_SEQUENCE_BITS;
+            u32 Sequence = Batch[BatchIndex] & MPSC_SEQUENCE_MASK;
+
+            if (ProducerIndex < ProducerCount && Sequence == NextSequences[ProducerIndex])
+            {
+                ++NextSequences[ProducerIndex];
+            }
+            else
+            {
+                ++ErrorCount;
+            }
+        }
+
+        ReceivedCount += Count;
+    }
+
+    for (u32 ProducerIndex = 0; ProducerIndex < ProducerCount; ++ProducerIndex)
+    {
+        Producers[ProducerIndex].join();
+
+        ErrorCount += OperationsPerProducer - std::min(NextSequences[ProducerIndex], OperationsPerProducer);
+    }
+
+    return ErrorCount;
+}
+
+// note: one consumer on the calling thread against every other hardware thread producing
+internal void
+BenchmarkMpscQueueContended(benchmark_context *Context, u32 OperationCount)
+{
+    mpsc_queue<u32> *Queue = PushStruct<mpsc_queue<u32>>(&Context->Arena);
+    InitializeMpscQueue(Queue, 4096, &Context->Arena);
+
+    u32 ProducerCount = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+    ProducerCount = std::min<u32>(ProducerCount, BENCHMARK_MAX_PRODUCERS);
+
+    u32 OperationsPerProducer = OperationCount / ProducerCount;
+    u32 TotalCount = OperationsPerProducer * ProducerCount;
+
+    StartTimer(Context);
+    u32 ErrorCount = RunContendedMpscQueue(Queue, ProducerCount, OperationsPerProducer);
+    StopTimer(Context);
+
+    // note: the harness divides by OperationCount, scale for the part lost to rounding
+    Context->ElapsedNs *= (f64)OperationCount / (f64)TotalCount;
+    Context->Sink += TotalCount + ErrorCount;
+}
+
+// note: at least 3 producers even on a single core, so they still get preempted in the middle of an enqueue
+internal b32
+CheckMpscQueue(benchmark_context *Context)
+{
+    mpsc_queue<u32> *Queue = PushStruct<mpsc_queue<u32>>(&Context->Arena);
+    InitializeMpscQueue(Queue, 256, &Context->Arena);
+
+    u32 ProducerCount = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+    ProducerCount = std::clamp<u32>(ProducerCount, 3, BENCHMARK_MAX_PRODUCERS);
+
+    u32 OperationsPerProducer = 1 << 16;
+    u32 ErrorCount = RunContendedMpscQueue(Queue, ProducerCount, OperationsPerProducer);
+
+    b32 Result = ErrorCount == 0;
+    printf("mpsc queue: %u producers x %u values, %u out of order or missing: %s\n",
+        ProducerCount, OperationsPerProducer, ErrorCount, Result ? "ok" : "MISMATCH");
+
+    return Result;
+}
+#pragma endregion
+
+#pragma region Slot map and sparse set
+internal void
+BenchmarkSlotMapInsertRemove(benchmark_context *Context, u32 OperationCount)
+{
+    slot_map<u32> SlotMap;
+    InitializeSlotMap(&SlotMap, OperationCount, &Context->Arena);
+
+    slot_handle *Handles = PushArray<slot_handle>(&Context->Arena, OperationCount);
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Handles[Index] = Insert(&SlotMap, Index);
+    }
+    for (u32 Index = 0; Index < OperationCount; Index += 2)
+    {
+        Remove(&SlotMap, Handles[Index]);
+    }
+    StopTimer(Context);
+
+    Context->Sink += SlotMap.Count;
+}
+
+internal void
+BenchmarkSlotMapGet(benchmark_context *Context, u32 OperationCount)
+{
+    slot_map<u32> SlotMap;
+    InitializeSlotMap(&SlotMap, OperationCount, &Context->Arena);
+
+    slot_handle *Handles = PushArray<slot_handle>(&Context->Arena, OperationCount);
+    u32 *Order = PushRandomKeys(Context, OperationCount);
+
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Handles[Index] = Insert(&SlotMap, Index);
+    }
+
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Accumulator += *Get(&SlotMap, Handles[Order[Index] - 1]);
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+internal void
+BenchmarkSparseSetGet(benchmark_context *Context, u32 OperationCount)
+{
+    slot_map<u32> Entities;
+    InitializeSlotMap(&Entities, OperationCount, &Context->Arena);
+
+    sparse_set<u32> Components;
+    InitializeSparseSet(&Components, OperationCount, OperationCount, &Context->Arena);
+
+    slot_handle *Handles = PushArray<slot_handle>(&Context->Arena, OperationCount);
+    u32 *Order = PushRandomKeys(Context, OperationCount);
+
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Handles[Index] = Insert(&Entities, Index);
+
+        // note: every other entity has the component
+        if (Index & 1)
+        {
+            *Add(&Components, Handles[Index]) = Index;
+        }
+    }
+
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        u32 *Component = Get(&Components, Handles[Order[Index] - 1]);
+
+        if (Component)
+        {
+            Accumulator += *Component;
+        }
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator;
+}
+
+// note: one operation is one alloc and one free, every other value is freed and allocated again before the live ones are walked
+internal void
+BenchmarkMemoryPoolAllocFree(benchmark_context *Context, u32 OperationCount)
+{
+    memory_pool<u32> Pool;
+    InitializeMemoryPool(&Pool, &Context->Arena, 64, true);
+
+    u32 **Values = PushArray<u32 *>(&Context->Arena, OperationCount);
+    u32 Accumulator = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        Values[Index] = PoolAlloc(&Pool);
+        *Values[Index] = Index;
+    }
+
+    for (u32 Index = 0; Index < OperationCount; Index += 2)
+    {
+        PoolFree(&Pool, Values[Index]);
+    }
+
+    for (u32 Index = 0; Index < OperationCount; Index += 2)
+    {
+        Values[Index] = PoolAlloc(&Pool);
+        *Values[Index] = Index;
+    }
+
+    memory_pool_iterator<u32> Iterator = IterateMemoryPool(&Pool);
+    while (u32 *Value = NextPoolValue(&Pool, &Iterator))
+    {
+        Accumulator += *Value;
+    }
+
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        PoolFree(&Pool, Values[Index]);
+    }
+    StopTimer(Context);
+
+    Context->Sink += Accumulator + Pool.BlockCount;
+}
+
+// note: freed slots have to be handed out again before the pool grows, and walking the pool must only visit live values
+internal b32
+CheckMemoryPool(benchmark_context *Context)
+{
+    u32 ValueCount = 1000;
+
+    memory_pool<u32> Pool;
+    InitializeMemoryPool(&Pool, &Context->Arena, 64, true);
+
+    u32 **Values = PushArray<u32 *>(&Context->Arena, ValueCount);
+
+    for (u32 Index = 0; Index < ValueCount; ++Index)
+    {
+        Values[Index] = PoolAlloc(&Pool);
+        *Values[Index] = Index;
+    }
+
+    u32 BlockCount = Pool.BlockCount;
+
+    // note: every third value is freed, the rest keeps its index
+    u32 FreedCount = 0;
+    for (u32 Index = 0; Index < ValueCount; Index += 3)
+    {
+        PoolFree(&Pool, Values[Index]);
+        ++FreedCount;
+    }
+
+    u32 VisitedCount = 0;
+    u32 FreedVisitCount = 0;
+
+    memory_pool_iterator<u32> Iterator = IterateMemoryPool(&Pool);
+    while (u32 *Value = NextPoolValue(&Pool, &Iterator))
+    {
+        FreedVisitCount += *Value % 3 == 0;
+        ++VisitedCount;
+    }
+
+    b32 IteratesLiveOnly = VisitedCount == ValueCount - FreedCount && FreedVisitCount == 0 && Pool.LiveCount == VisitedCount;
+
+    u32 ReusedCount = 0;
+    for (u32 Index = 0; Index < ValueCount; Index += 3)
+    {
+        u32 *Value = PoolAlloc(&Pool);
+        *Value = Index;
+
+        for (u32 FreedIndex = 0; FreedIndex < ValueCount; FreedIndex += 3)
+        {
+            if (Values[FreedIndex] == Value)
+            {
+                ++ReusedCount;
+                break;
+            }
+        }
+    }
+
+    b32 ReusesSlots = ReusedCount == FreedCount && Pool.BlockCount == BlockCount && Pool.LiveCount == ValueCount;
+
+    b32 Result = IteratesLiveOnly && ReusesSlots;
+    printf("memory pool: %u of %u values visited after %u frees, %u of %u slots reused: %s\n",
+        VisitedCount, ValueCount, FreedCount, ReusedCount, FreedCount, Result ? "ok" : "MISMATCH");
+
+    return Result;
+}
+#pragma endregion
+
+#pragma region Replay determinism
+struct benchmark_replay
+{
+    // note: the body's own box comes first, like the player's boxes sit inside GameState->Boxes
+    u32 BoxCount;
+    sim_aabb *Boxes;
+    box_grid Grid;
+    box_grid_query Query;
+    // note: stays empty, the scene's boxes all go through the grid
+    tile_grid Tiles;
+
+    body_component Body;
+};
+
+inline sim_aabb
+ReplayBox(f32 X, f32 Y, f32 Width, f32 Height)
+{
+    sim_aabb Result;
+    Result.Position = SimVec2(vec2(X, Y));
+    Result.Size = SimVec2(vec2(Width, Height));
+
+    return Result;
+}
+
+// note: a closed room with a floor, a few platforms and a row of steps
+internal benchmark_replay
+PushReplayScene(benchmark_context *Context)
+{
+    benchmark_replay Result = {};
+
+    u32 StepCount = 32;
+    Result.Boxes = PushArray<sim_aabb>(&Context->Arena, 6 + StepCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    Result.Boxes[Result.BoxCount++] = ReplayBox(0.f, 1.f, 0.8f, 1.5f);
+    Result.Boxes[Result.BoxCount++] = ReplayBox(-20.f, -1.f, 40.f, 1.f);
+    Result.Boxes[Result.BoxCount++] = ReplayBox(-21.f, -1.f, 1.f, 20.f);
+    Result.Boxes[Result.BoxCount++] = ReplayBox(20.f, -1.f, 1.f, 20.f);
+    Result.Boxes[Result.BoxCount++] = ReplayBox(3.f, 2.5f, 4.f, 0.5f);
+    Result.Boxes[Result.BoxCount++] = ReplayBox(-8.f, 4.f, 3.f, 0.5f);
+
+    for (u32 StepIndex = 0; StepIndex < StepCount; ++StepIndex)
+    {
+        Result.Boxes[Result.BoxCount++] = ReplayBox(8.f + StepIndex * 0.375f, 0.f, 0.375f, 0.125f * (StepIndex % 4));
+    }
+
+    InitializeBoxGrid(&Result.Grid, Result.Boxes, Result.BoxCount, SimScalar(4.f), &Context->Arena);
+    InitializeBoxGridQuery(&Result.Query, &Result.Grid, &Context->Arena);
+
+    Result.Body.Acceleration = SimVec2(vec2(0.f, -1.f));
+
+    return Result;
+}
+
+// note: stands in for ProcessInput, runs back and forth with a jump and a dive every 90 ticks
+inline void
+ApplyReplayInput(body_component *Body, u32 Tick)
+{
+    Body->Acceleration.x = SimScalar(Tick % 240 < 120 ? 5.f : -5.f);
+
+    if (Tick % 90 == 30)
+    {
+        Body->Acceleration.y = SimScalar(25.f);
+        Body->Velocity.y = SimScalar(0.f);
+    }
+    else if (Tick % 90 == 60)
+    {
+        Body->Acceleration.y = SimScalar(-25.f);
+        Body->Velocity.y = SimScalar(0.f);
+    }
+}
+
+internal u64
+RunReplay(benchmark_replay *Replay, u32 TickCount)
+{
+    u64 Hash = SIM_STATE_HASH_SEED;
+    sim_f32 dt = SimScalar(0.1f);
+
+    for (u32 Tick = 0; Tick < TickCount; ++Tick)
+    {
+        ApplyReplayInput(&Replay->Body, Tick);
+
+        body_step Step = StepBody(&Replay->Body, Replay->Boxes, 1, &Replay->Tiles, &Replay->Grid, &Replay->Query, dt);
+
+        Hash = HashSimState(Hash, &Step.Move, sizeof(Step.Move));
+        Hash = HashSimState(Hash, &Step.CollisionTime, sizeof(Step.CollisionTime));
+        Hash = HashSimState(Hash, &Replay->Body, sizeof(Replay->Body));
+        Hash = HashSimState(Hash, Replay->Boxes, sizeof(sim_aabb));
+    }
+
+    return Hash;
+}
+
+internal void
+BenchmarkPhysicsStep(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_replay Replay = PushReplayScene(Context);
+
+    StartTimer(Context);
+    u64 Hash = RunReplay(&Replay, OperationCount);
+    StopTimer(Context);
+
+    Context->Sink += Hash;
+}
+
+// note: a large map of scattered one unit boxes with the body in the middle, narrow phase cost should only grow with the first
+struct benchmark_large_map
+{
+    u32 BoxCount;
+    sim_aabb *Boxes;
+    box_grid Grid;
+    box_grid_query Query;
+
+    sim_aabb BodyBox;
+    sim_vec2 Move;
+};
+
+internal benchmark_large_map
+PushLargeMap(benchmark_context *Context, u32 BoxCount)
+{
+    benchmark_large_map Result = {};
+
+    u32 Side = 1;
+    while (Side * Side < BoxCount)
+    {
+        ++Side;
+    }
+
+    Result.BoxCount = BoxCount;
+    Result.Boxes = PushArray<sim_aabb>(&Context->Arena, BoxCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    for (u32 BoxIndex = 0; BoxIndex < BoxCount; ++BoxIndex)
+    {
+        f32 X = 2.f * (BoxIndex % Side) + (f32)(RandomNextU32(&Context->Entropy) % 8) * 0.125f;
+        f32 Y = 2.f * (BoxIndex / Side) + (f32)(RandomNextU32(&Context->Entropy) % 8) * 0.125f;
+
+        Result.Boxes[BoxIndex] = ReplayBox(X, Y, 1.f, 1.f);
+    }
+
+    InitializeBoxGrid(&Result.Grid, Result.Boxes, BoxCount, SimScalar(4.f), &Context->Arena);
+    InitializeBoxGridQuery(&Result.Query, &Result.Grid, &Context->Arena);
+
+    Result.BodyBox = ReplayBox((f32)Side, (f32)Side + 1.f, 0.8f, 1.5f);
+    Result.Move = SimVec2(vec2(0.3f, -0.2f));
+
+    return Result;
+}
+
+// note: the reference the soa kernels have to agree with, one SweptAABB call per box
+internal void
+SweepBoxesAoS(sim_aabb *BodyBox, sim_vec2 Move, sim_aabb *Boxes, u32 BoxCount, sim_vec2 *CollisionTime)
+{
+    for (u32 BoxIndex = 0; BoxIndex < BoxCount; ++BoxIndex)
+    {
+        sim_vec2 Time = SweptAABB(BodyBox->Position, Move, Boxes[BoxIndex], BodyBox->Size);
+        AccumulateCollisionTime(Time, CollisionTime);
+    }
+}
+
+internal void
+BenchmarkSweepAoS(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_large_map Map = PushLargeMap(Context, 16384);
+    sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        SweepBoxesAoS(&Map.BodyBox, Map.Move, Map.Boxes, Map.BoxCount, &CollisionTime);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)ToF32(CollisionTime.x * SimScalar(1000.f));
+}
+
+internal void
+BenchmarkSweepSoaScalar(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_large_map Map = PushLargeMap(Context, 16384);
+    sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        SweepBoxSoaScalar(Map.BodyBox.Position, Map.Move, Map.BodyBox.Size, &Map.Grid.StaticBoxes, 0, &CollisionTime);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)ToF32(CollisionTime.x * SimScalar(1000.f));
+}
+
+#if !FUZZY_FIXED_POINT && FUZZY_SSE2
+internal void
+BenchmarkSweepSoaSSE2(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_large_map Map = PushLargeMap(Context, 16384);
+    sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        SweepBoxSoaSSE2(Map.BodyBox.Position, Map.Move, Map.BodyBox.Size, &Map.Grid.StaticBoxes, &CollisionTime);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)ToF32(CollisionTime.x * SimScalar(1000.f));
+}
+#endif
+
+#if !FUZZY_FIXED_POINT && FUZZY_AVX2
+internal void
+BenchmarkSweepSoaAVX2(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_large_map Map = PushLargeMap(Context, 16384);
+    sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        SweepBoxSoaAVX2(Map.BodyBox.Position, Map.Move, Map.BodyBox.Size, &Map.Grid.StaticBoxes, &CollisionTime);
+    }
+    StopTimer(Context);
+
+    Context->Sink += (u64)ToF32(CollisionTime.x * SimScalar(1000.f));
+}
+#endif
+
+internal void
+BenchmarkBroadphaseGrid(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_large_map Map = PushLargeMap(Context, 16384);
+    sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+    u64 CandidatePairCount = 0;
+
+    StartTimer(Context);
+    for (u32 Index = 0; Index < OperationCount; ++Index)
+    {
+        CandidatePairCount += GatherSweptCandidates(&Map.Grid, &Map.Query, &Map.BodyBox, Map.Move, &Map.BodyBox, 1);
+        SweepBoxSoa(Map.BodyBox.Position, Map.Move, Map.BodyBox.Size, &Map.Query.Candidates, &CollisionTime);
+    }
+    StopTimer(Context);
+
+    Context->Sink += CandidatePairCount + (u64)ToF32(CollisionTime.x * SimScalar(1000.f));
+}
+
+inline b32
+CollisionTimesMatch(sim_vec2 A, sim_vec2 B)
+{
+    // note: == on purpose, the lanes may fold a -0 where the reference keeps a +0
+    b32 Result = A.x == B.x && A.y == B.y;
+    return Result;
+}
+
+// note: random queries over the large map, every soa kernel has to give exactly the SweptAABB reference's collision times
+internal b32
+CheckSweepKernels(benchmark_context *Context)
+{
+    u32 BoxCount = 4099;
+    benchmark_large_map Map = PushLargeMap(Context, BoxCount);
+
+    u32 QueryCount = 4096;
+    u32 MismatchCount = 0;
+
+    for (u32 QueryIndex = 0; QueryIndex < QueryCount; ++QueryIndex)
+    {
+        sim_aabb BodyBox = ReplayBox(
+            RandomBetween(&Context->Entropy, 0.f, 130.f), RandomBetween(&Context->Entropy, 0.f, 130.f),
+            RandomBetween(&Context->Entropy, 0.25f, 2.f), RandomBetween(&Context->Entropy, 0.25f, 2.f));
+
+        // note: axis aligned moves every now and then, those take the Delta == 0 paths
+        vec2 Move = vec2(RandomBetween(&Context->Entropy, -3.f, 3.f), RandomBetween(&Context->Entropy, -3.f, 3.f));
+        if (QueryIndex % 4 == 1)
+        {
+            Move.x = 0.f;
+        }
+        else if (QueryIndex % 4 == 2)
+        {
+            Move.y = 0.f;
+        }
+
+        sim_vec2 SimMove = SimVec2(Move);
+        sim_vec2 One = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+        sim_vec2 Expected = One;
+        SweepBoxesAoS(&BodyBox, SimMove, Map.Boxes, BoxCount, &Expected);
+
+        sim_vec2 Scalar = One;
+        SweepBoxSoaScalar(BodyBox.Position, SimMove, BodyBox.Size, &Map.Grid.StaticBoxes, 0, &Scalar);
+        MismatchCount += !CollisionTimesMatch(Expected, Scalar);
+
+#if !FUZZY_FIXED_POINT && FUZZY_SSE2
+        sim_vec2 SSE2 = One;
+        SweepBoxSoaSSE2(BodyBox.Position, SimMove, BodyBox.Size, &Map.Grid.StaticBoxes, &SSE2);
+        MismatchCount += !CollisionTimesMatch(Expected, SSE2);
+#endif
+
+#if !FUZZY_FIXED_POINT && FUZZY_AVX2
+        if (SimdHasAVX2)
+        {
+            sim_vec2 AVX2 = One;
+            SweepBoxSoaAVX2(BodyBox.Position, SimMove, BodyBox.Size, &Map.Grid.StaticBoxes, &AVX2);
+            MismatchCount += !CollisionTimesMatch(Expected, AVX2);
+        }
+#endif
+    }
+
+    b32 Result = MismatchCount == 0;
+    printf("sweep kernels vs SweptAABB: %u queries, %u mismatches: %s\n", QueryCount, MismatchCount, Result ? "ok" : "MISMATCH");
+
+    return Result;
+}
+
+// note: 16x16 tile chunks with every fifth one missing, the tiles mimic the tileset's full tiles, floor strips, poles and pegs
+struct benchmark_tile_map
+{
+    tile_grid Tiles;
+    tile_grid_layer Layer;
+
+    // note: every tile box in world units, one per tile like the map file has them
+    u32 TileBoxCount;
+    sim_aabb *TileBoxes;
+
+    // note: the chunks' merged boxes, what the tile grid query has to agree with
+    u32 BoxCount;
+    sim_aabb *Boxes;
+    box_grid Grid;
+    box_grid_query Query;
+
+    vec2 Min;
+    vec2 Max;
+};
+
+internal benchmark_tile_map
+PushTileMap(benchmark_context *Context, i32 ChunkCountX, i32 ChunkCountY)
+{
+    benchmark_tile_map Result = {};
+
+    i32 ChunkSize = 16;
+
+    tile_grid *Tiles = &Result.Tiles;
+    Tiles->Origin = SimVec2(vec2(3.25f, -1.5f));
+    Tiles->TileSize = SimVec2(vec2(0.5f, 0.5f));
+    Tiles->FirstGID = 1;
+
+    Tiles->TileIDCount = 4;
+    Tiles->TileBoxOffsets = PushArray<u32>(&Context->Arena, Tiles->TileIDCount + 1);
+    Tiles->TileBoxes = PushArray<sim_aabb>(&Context->Arena, 5);
+
+    u32 TileBoxCount = 0;
+    Tiles->TileBoxOffsets[0] = TileBoxCount;
+    Tiles->TileBoxes[TileBoxCount++] = ReplayBox(0.f, 0.f, 1.f, 1.f);
+    Tiles->TileBoxOffsets[1] = TileBoxCount;
+    Tiles->TileBoxes[TileBoxCount++] = ReplayBox(0.f, 0.9375f, 1.f, 0.0625f);
+    Tiles->TileBoxOffsets[2] = TileBoxCount;
+    Tiles->TileBoxes[TileBoxCount++] = ReplayBox(0.4375f, 0.f, 0.125f, 1.f);
+    Tiles->TileBoxOffsets[3] = TileBoxCount;
+    Tiles->TileBoxes[TileBoxCount++] = ReplayBox(0.f, 0.f, 0.125f, 0.125f);
+    Tiles->TileBoxes[TileBoxCount++] = ReplayBox(0.875f, 0.875f, 0.125f, 0.125f);
+    Tiles->TileBoxOffsets[4] = TileBoxCount;
+
+    i32 MinX = -(ChunkCountX / 2) * ChunkSize;
+    i32 MaxX = MinX + (ChunkCountX - 1) * ChunkSize;
+    i32 MaxY = (ChunkCountY / 2) * ChunkSize;
+    i32 MinY = MaxY - (ChunkCountY - 1) * ChunkSize;
+
+    InitializeTileGridLayer(&Result.Layer, ChunkSize, ChunkSize, MinX, MaxX, MinY, MaxY, &Context->Arena);
+    Tiles->LayerCount = 1;
+    Tiles->Layers = &Result.Layer;
+
+    u32 MaxBoxCount = (u32)(ChunkCountX * ChunkCountY * ChunkSize * ChunkSize) * 2;
+    Result.TileBoxes = PushArray<sim_aabb>(&Context->Arena, MaxBoxCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    memory_arena ScratchArena;
+    InitializeSubArena(&ScratchArena, &Context->Arena, Kilobytes(64));
+
+    for (i32 ChunkY = 0; ChunkY < ChunkCountY; ++ChunkY)
+    {
+        for (i32 ChunkX = 0; ChunkX < ChunkCountX; ++ChunkX)
+        {
+            if ((ChunkY * ChunkCountX + ChunkX) % 5 == 4)
+            {
+                continue;
+            }
+
+            i32 X = MinX + ChunkX * ChunkSize;
+            i32 Y = MaxY - ChunkY * ChunkSize;
+
+            u32 *GIDs = PushArray<u32>(&Context->Arena, ChunkSize * ChunkSize);
+
+            for (i32 GIDIndex = 0; GIDIndex < ChunkSize * ChunkSize; ++GIDIndex)
+            {
+                u32 Roll = RandomNextU32(&Context->Entropy) % 10;
+                GIDs[GIDIndex] = Roll < 6 ? 0 : Roll - 5;
+
+                if (GIDs[GIDIndex])
+                {
+                    sim_vec2 Tile = SimVec2(SimScalar((f32)(X + GIDIndex % ChunkSize)), SimScalar((f32)(Y - GIDIndex / ChunkSize)));
+                    u32 TileID = GIDs[GIDIndex] - Tiles->FirstGID;
+
+                    for (u32 BoxIndex = Tiles->TileBoxOffsets[TileID]; BoxIndex < Tiles->TileBoxOffsets[TileID + 1]; ++BoxIndex)
+                    {
+                        sim_aabb *TileBox = Tiles->TileBoxes + BoxIndex;
+                        sim_aabb *Box = Result.TileBoxes + Result.TileBoxCount++;
+
+                        Box->Position = Tiles->Origin + (Tile + TileBox->Position) * Tiles->TileSize;
+                        Box->Size = TileBox->Size * Tiles->TileSize;
+                    }
+                }
+            }
+
+            SetTileGridChunk(Tiles, &Result.Layer, X, Y, GIDs, &Context->Arena, &ScratchArena);
+        }
+    }
+
+    Result.Boxes = PushArray<sim_aabb>(&Context->Arena, Tiles->MergedBoxCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    for (i32 ChunkIndex = 0; ChunkIndex < ChunkCountX * ChunkCountY; ++ChunkIndex)
+    {
+        tile_grid_chunk *Chunk = Result.Layer.Chunks + ChunkIndex;
+
+        for (u32 BoxIndex = 0; BoxIndex < Chunk->BoxCount; ++BoxIndex)
+        {
+            Result.Boxes[Result.BoxCount++] = Chunk->Boxes[BoxIndex];
+        }
+    }
+
+    InitializeBoxGrid(&Result.Grid, Result.Boxes, Result.BoxCount, SimScalar(2.f), &Context->Arena);
+    InitializeBoxGridQuery(&Result.Query, &Result.Grid, &Context->Arena);
+
+    Result.Min = ToVec2(Tiles->Origin) + vec2((f32)MinX, (f32)(MinY - ChunkSize + 1)) * ToVec2(Tiles->TileSize);
+    Result.Max = ToVec2(Tiles->Origin) + vec2((f32)(MaxX + ChunkSize), (f32)(MaxY + 1)) * ToVec2(Tiles->TileSize);
+
+    return Result;
+}
+
+struct benchmark_tile_query
+{
+    sim_aabb Box;
+    sim_vec2 Move;
+};
+
+// note: some queries are points like the particles, and a few moves are axis aligned or longer than a tile
+internal benchmark_tile_query
+GetRandomTileQuery(benchmark_context *Context, benchmark_tile_map *Map, u32 QueryIndex)
+{
+    benchmark_tile_query Result;
+
+    f32 Width = QueryIndex % 3 == 0 ? 0.f : RandomBetween(&Context->Entropy, 0.1f, 1.2f);
+    f32 Height = QueryIndex % 3 == 0 ? 0.f : RandomBetween(&Context->Entropy, 0.1f, 1.2f);
+
+    Result.Box = ReplayBox(
+        RandomBetween(&Context->Entropy, Map->Min.x - 1.f, Map->Max.x + 1.f),
+        RandomBetween(&Context->Entropy, Map->Min.y - 1.f, Map->Max.y + 1.f),
+        Width, Height);
+
+    f32 Reach = QueryIndex % 7 == 0 ? 4.f : 0.4f;
+    vec2 Move = vec2(RandomBetween(&Context->Entropy, -Reach, Reach), RandomBetween(&Context->Entropy, -Reach, Reach));
+
+    if (QueryIndex % 5 == 1)
+    {
+        Move.x = 0.f;
+    }
+    else if (QueryIndex % 5 == 2)
+    {
+        Move.y = 0.f;
+    }
+
+    Result.Move = SimVec2(Move);
+
+    return Result;
+}
+
+internal void
+BenchmarkTileGridSweep(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_tile_map Map = PushTileMap(Context, 16, 16);
+
+    benchmark_tile_query *Queries = PushArray<benchmark_tile_query>(&Context->Arena, OperationCount);
+    for (u32 QueryIndex = 0; QueryIndex < OperationCount; ++QueryIndex)
+    {
+        Queries[QueryIndex] = GetRandomTileQuery(Context, &Map, QueryIndex);
+    }
+
+    u64 TileVisitCount = 0;
+    sim_f32 Accumulator = SimScalar(0.f);
+
+    StartTimer(Context);
+    for (u32 QueryIndex = 0; QueryIndex < OperationCount; ++QueryIndex)
+    {
+        benchmark_tile_query *Query = Queries + QueryIndex;
+        sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+        TileVisitCount += SweepTileGrid(&Map.Tiles, Query->Box.Position, Query->Box.Size, Query->Move, &CollisionTime);
+        Accumulator += CollisionTime.x;
+    }
+    StopTimer(Context);
+
+    Context->Sink += TileVisitCount + (u64)ToF32(Accumulator);
+}
+
+internal void
+BenchmarkTileBoxGridSweep(benchmark_context *Context, u32 OperationCount)
+{
+    benchmark_tile_map Map = PushTileMap(Context, 16, 16);
+
+    benchmark_tile_query *Queries = PushArray<benchmark_tile_query>(&Context->Arena, OperationCount);
+    for (u32 QueryIndex = 0; QueryIndex < OperationCount; ++QueryIndex)
+    {
+        Queries[QueryIndex] = GetRandomTileQuery(Context, &Map, QueryIndex);
+    }
+
+    u64 CandidatePairCount = 0;
+    sim_f32 Accumulator = SimScalar(0.f);
+
+    StartTimer(Context);
+    for (u32 QueryIndex = 0; QueryIndex < OperationCount; ++QueryIndex)
+    {
+        benchmark_tile_query *Query = Queries + QueryIndex;
+        sim_vec2 CollisionTime = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+        CandidatePairCount += GatherSweptCandidates(&Map.Grid, &Map.Query, &Query->Box, Query->Move, 0, 0);
+        SweepBoxSoa(Query->Box.Position, Query->Move, Query->Box.Size, &Map.Query.Candidates, &CollisionTime);
+        Accumulator += CollisionTime.x;
+    }
+    StopTimer(Context);
+
+    Context->Sink += CandidatePairCount + (u64)ToF32(Accumulator);
+}
+
+// note: the tile walk has to find exactly what sweeping every merged box of the map finds
+internal b32
+CheckTileGridQueries(benchmark_context *Context)
+{
+    benchmark_tile_map Map = PushTileMap(Context, 6, 5);
+
+    u32 QueryCount = 4096;
+    u32 MismatchCount = 0;
+    u32 HitCount = 0;
+
+    for (u32 QueryIndex = 0; QueryIndex < QueryCount; ++QueryIndex)
+    {
+        benchmark_tile_query Query = GetRandomTileQuery(Context, &Map, QueryIndex);
+        sim_vec2 One = SimVec2(SimScalar(1.f), SimScalar(1.f));
+
+        sim_vec2 Expected = One;
+        SweepBoxesAoS(&Query.Box, Query.Move, Map.Boxes, Map.BoxCount, &Expected);
+
+        sim_vec2 CollisionTime = One;
+        SweepTileGrid(&Map.Tiles, Query.Box.Position, Query.Box.Size, Query.Move, &CollisionTime);
+
+        MismatchCount += !CollisionTimesMatch(Expected, CollisionTime);
+        HitCount += Expected.x < One.x || Expected.y < One.y;
+    }
+
+    b32 Result = MismatchCount == 0;
+    printf("tile grid vs all merged boxes: %u queries, %u hits, %u mismatches: %s\n",
+        QueryCount, HitCount, MismatchCount, Result ? "ok" : "MISMATCH");
+
+    return Result;
+}
+
+// note: the tile boxes don't overlap, so the merged boxes have to cover the same area without overlapping each other
+internal b32
+CheckTileBoxMerge(benchmark_context *Context)
+{
+    benchmark_tile_map Map = PushTileMap(Context, 6, 5);
+
+    // note: the sizes are multiples of 1/32, so the sums are exact
+    f64 TileBoxArea = 0.0;
+    for (u32 BoxIndex = 0; BoxIndex < Map.TileBoxCount; ++BoxIndex)
+    {
+        sim_aabb *Box = Map.TileBoxes + BoxIndex;
+        TileBoxArea += (f64)ToF32(Box->Size.x) * (f64)ToF32(Box->Size.y);
+    }
+
+    f64 MergedArea = 0.0;
+    u32 OverlapCount = 0;
+    for (u32 BoxIndex = 0; BoxIndex < Map.BoxCount; ++BoxIndex)
+    {
+        sim_aabb *Box = Map.Boxes + BoxIndex;
+        MergedArea += (f64)ToF32(Box->Size.x) * (f64)ToF32(Box->Size.y);
+
+        for (u32 OtherIndex = BoxIndex + 1; OtherIndex < Map.BoxCount; ++OtherIndex)
+        {
+            sim_aabb *Other = Map.Boxes + OtherIndex;
+
+            OverlapCount +=
+                Box->Position.x < Other->Position.x + Other->Size.x && Other->Position.x < Box->Position.x + Box->Size.x &&
+                Box->Position.y < Other->Position.y + Other->Size.y && Other->Position.y < Box->Position.y + Box->Size.y;
+        }
+    }
+
+    b32 Result = Map.BoxCount < Map.TileBoxCount && MergedArea == TileBoxArea && OverlapCount == 0;
+    printf("tile box merge: %u boxes into %u, area %.4f vs %.4f, %u overlaps: %s\n",
+        Map.TileBoxCount, Map.BoxCount, TileBoxArea, MergedArea, OverlapCount, Result ? "ok" : "MISMATCH");
+
+    return Result;
+}
+
+// note: the f32 build only reports its hash, it's allowed to differ between compilers and flags
+internal b32
+CheckReplayDeterminism(benchmark_context *Context)
+{
+    benchmark_replay Replay = PushReplayScene(Context);
+    u64 Hash = RunReplay(&Replay, BENCHMARK_REPLAY_TICKS);
+
+    b32 Result = true;
+
+#if FUZZY_FIXED_POINT
+    Result = Hash == BENCHMARK_REPLAY_HASH;
+    printf("replay hash (fixed-point): 0x%016llx, expected 0x%016llx: %s\n",
+        (unsigned long long)Hash, (unsigned long long)BENCHMARK_REPLAY_HASH, Result ? "ok" : "MISMATCH");
+#else
+    printf("replay hash (f32): 0x%016llx\n", (unsigned long long)Hash);
+#endif
+
+    return Result;
+}
+#pragma endregion
+
+#pragma region Physics system
+#define BENCHMARK_PHYSICS_BODY_COUNT 4096
+#define BENCHMARK_PHYSICS_TICKS 8
+
+// note: the game's queue with plain threads, the workers spin on it instead of waiting on a semaphore
+struct benchmark_work_queue
+{
+    platform_work_queue Queue;
+
+    std::atomic<b32> IsRunning;
+
+    u32 WorkerCount;
+    std::thread Workers[BENCHMARK_MAX_PRODUCERS];
+};
+
+internal void
+BenchmarkWorker(benchmark_work_queue *WorkQueue)
+{
+    while (WorkQueue->IsRunning.load(std::memory_order_relaxed))
+    {
+        if (!DoNextPlatformWorkQueueEntry(&WorkQueue->Queue))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// note: one worker per hardware thread besides the calling one, 0 workers makes StepPhysics run everything itself
+internal work_queue
+StartWorkQueue(benchmark_work_queue *WorkQueue, u32 WorkerCount)
+{
+    InitializePlatformWorkQueue(&WorkQueue->Queue, 0, 0);
+    WorkQueue->IsRunning.store(true);
+
+    WorkQueue->WorkerCount = std::min<u32>(WorkerCount, BENCHMARK_MAX_PRODUCERS);
+
+    for (u32 WorkerIndex = 0; WorkerIndex < WorkQueue->WorkerCount; ++WorkerIndex)
+    {
+        WorkQueue->Workers[WorkerIndex] = std::thread(BenchmarkWorker, WorkQueue);
+    }
+
+    work_queue Result = {};
+    Result.Queue = &WorkQueue->Queue;
+    Result.WorkerCount = WorkQueue->WorkerCount;
+    Result.AddEntry = AddPlatformWorkEntry;
+    Result.CompleteAllWork = CompleteAllPlatformWork;
+
+    return Result;
+}
+
+internal void
+StopWorkQueue(benchmark_work_queue *WorkQueue)
+{
+    WorkQueue->IsRunning.store(false);
+
+    for (u32 WorkerIndex = 0; WorkerIndex < WorkQueue->WorkerCount; ++WorkerIndex)
+    {
+        WorkQueue->Workers[WorkerIndex].join();
+    }
+}
+
+inline u32
+GetBenchmarkWorkerCount()
+{
+    u32 Result = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0;
+    return Result;
+}
+
+// note: bodies dropped all over a tile map, one box each, nothing else in the grid
+struct benchmark_physics_scene
+{
+    benchmark_tile_map Map;
+    box_grid Grid;
+
+    body_component *Bodies;
+    sim_vec2 *Positions;
+    sim_aabb *Boxes;
+
+    physics_system System;
+};
+
+internal benchmark_physics_scene *
+PushPhysicsScene(benchmark_context *Context, u32 BodyCount)
+{
+    benchmark_physics_scene *Result = PushStruct<benchmark_physics_scene>(&Context->Arena, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    Result->Map = PushTileMap(Context, 8, 8);
+    // note: the copy's layer pointer still points at the returned map's layer
+    Result->Map.Tiles.Layers = &Result->Map.Layer;
+    InitializeBoxGrid(&Result->Grid, 0, 0, SimScalar(4.f), &Context->Arena);
+    InitializePhysicsSystem(&Result->System, BodyCount, &Result->Map.Tiles, &Result->Grid, &Context->Arena);
+
+    Result->Bodies = PushArray<body_component>(&Context->Arena, BodyCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result->Positions = PushArray<sim_vec2>(&Context->Arena, BodyCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    Result->Boxes = PushArray<sim_aabb>(&Context->Arena, BodyCount, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+
+    for (u32 BodyIndex = 0; BodyIndex < BodyCount; ++BodyIndex)
+    {
+        vec2 Position = vec2(
+            RandomBetween(&Context->Entropy, Result->Map.Min.x, Result->Map.Max.x - 0.4f),
+            RandomBetween(&Context->Entropy, Result->Map.Min.y, Result->Map.Max.y - 0.4f));
+
+        Result->Bodies[BodyIndex] = {};
+        Result->Bodies[BodyIndex].Velocity = SimVec2(vec2(RandomBetween(&Context->Entropy, -2.f, 2.f), 0.f));
+        Result->Bodies[BodyIndex].Acceleration = SimVec2(vec2(0.f, -1.f));
+
+        Result->Positions[BodyIndex] = SimVec2(Position);
+        Result->Boxes[BodyIndex] = ReplayBox(Position.x, Position.y, 0.4f, 0.4f);
+
+        physics_body *PhysicsBody = Result->System.Bodies + BodyIndex;
+        PhysicsBody->Body = Result->Bodies + BodyIndex;
+        PhysicsBody->Position = Result->Positions + BodyIndex;
+        PhysicsBody->Boxes = Result->Boxes + BodyIndex;
+        PhysicsBody->BoxCount = 1;
+    }
+
+    Result->System.BodyCount = BodyCount;
+
+    return Result;
+}
+
+// note: every body runs back and forth and jumps once in a while, each on its own schedule
+internal u64
+RunPhysicsScene(benchmark_physics_scene *Scene, u32 TickCount, work_queue *WorkQueue, u64 Hash)
+{
+    sim_f32 dt = SimScalar(0.1f);
+    physics_system *System = &Scene->System;
+
+    for (u32 Tick = 0; Tick < TickCount; ++Tick)
+    {
+        for (u32 BodyIndex = 0; BodyIndex < System->BodyCount; ++BodyIndex)
+        {
+            ApplyReplayInput(Scene->Bodies + BodyIndex, Tick + BodyIndex);
+        }
+
+        StepPhysics(System, dt, WorkQueue);
+
+        Hash = HashSimState(Hash, System->Contacts, System->ContactCount * sizeof(body_contact));
+    }
+
+    return Hash;
+}
+
+internal void
+BenchmarkPhysicsBodies(benchmark_context *Context, u32 OperationCount, u32 WorkerCount)
+{
+    benchmark_physics_scene *Scene = PushPhysicsScene(Context, OperationCount);
+
+    benchmark_work_queue *Queue = PushStruct<benchmark_work_queue>(&Context->Arena, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    new (Queue) benchmark_work_queue();
+    work_queue WorkQueue = StartWorkQueue(Queue, WorkerCount);
+
+    StartTimer(Context);
+    u64 Hash = RunPhysicsScene(Scene, BENCHMARK_PHYSICS_TICKS, &WorkQueue, SIM_STATE_HASH_SEED);
+    StopTimer(Context);
+
+    StopWorkQueue(Queue);
+    Queue->~benchmark_work_queue();
+
+    // note: reported per body and tick
+    Context->ElapsedNs /= BENCHMARK_PHYSICS_TICKS;
+    Context->Sink += Hash + Scene->System.TileVisitCount;
+}
+
+internal void
+BenchmarkPhysicsBodiesSerial(benchmark_context *Context, u32 OperationCount)
+{
+    BenchmarkPhysicsBodies(Context, OperationCount, 0);
+}
+
+internal void
+BenchmarkPhysicsBodiesParallel(benchmark_context *Context, u32 OperationCount)
+{
+    BenchmarkPhysicsBodies(Context, OperationCount, GetBenchmarkWorkerCount());
+}
+
+// note: the chunks may finish in any order, the merged contacts and the bodies have to come out the same as stepping on one thread
+internal b32
+CheckPhysicsDeterminism(benchmark_context *Context)
+{
+    temporary_memory TempMemory = BeginTemporaryMemory(&Context->Arena);
+
+    u32 TickCount = 120;
+    random_sequence Entropy = Context->Entropy;
+
+    benchmark_physics_scene *SerialScene = PushPhysicsScene(Context, BENCHMARK_PHYSICS_BODY_COUNT);
+    u64 SerialHash = RunPhysicsScene(SerialScene, TickCount, 0, SIM_STATE_HASH_SEED);
+    SerialHash = HashSimState(SerialHash, SerialScene->Positions, BENCHMARK_PHYSICS_BODY_COUNT * sizeof(sim_vec2));
+
+    Context->Entropy = Entropy;
+
+    benchmark_physics_scene *ParallelScene = PushPhysicsScene(Context, BENCHMARK_PHYSICS_BODY_COUNT);
+
+    benchmark_work_queue *Queue = PushStruct<benchmark_work_queue>(&Context->Arena, MEMORY_TAG_UNTAGGED, CACHE_LINE_SIZE);
+    new (Queue) benchmark_work_queue();
+    // note: a few workers even on a single core, the threaded path is what this checks
+    work_queue WorkQueue = StartWorkQueue(Queue, std::max<u32>(GetBenchmarkWorkerCount(), 3));
+
+    u64 ParallelHash = RunPhysicsScene(ParallelScene, TickCount, &WorkQueue, SIM_STATE_HASH_SEED);
+    ParallelHash = HashSimState(ParallelHash, ParallelScene->Positions, BENCHMARK_PHYSICS_BODY_COUNT * sizeof(sim_vec2));
+
+    StopWorkQueue(Queue);
+    Queue->~benchmark_work_queue();
+
+    b32 Result = SerialHash == ParallelHash;
+    printf("physics %u bodies x %u ticks, %u workers: serial 0x%016llx, parallel 0x%016llx, %u contacts last tick: %s\n",
+        BENCHMARK_PHYSICS_BODY_COUNT, TickCount, WorkQueue.WorkerCount, (unsigned long long)SerialHash, (unsigned long long)ParallelHash,
+        ParallelScene->System.ContactCount, Result ? "ok" : "MISMATCH");
+
+    EndTemporaryMemory(TempMemory);
+
+    return Result;
+}
+#pragma endregion
+
+int
+main(int ArgumentCount, char **Arguments)
+{
+    const char *OutputFileName = ArgumentCount > 1 ? Arguments[1] : "fuzzy_benchmark.json";
+
+    persist benchmark_context Context;
+
+    void *ArenaMemory = malloc(BENCHMARK_ARENA_SIZE);
+    if (!ArenaMemory)
+    {
+        printf("Failed to allocate benchmark memory\n");
+        return 1;
+    }
+
+    InitializeMemoryArena(&Context.Arena, BENCHMARK_ARENA_SIZE, ArenaMemory);
+    Context.Entropy = RandomSequence(1337);
+
+    u32 OperationCount = 1 << 16;
+
+    printf("%-32s %10s %10s %10s\n", "ns/op", "median", "p99", "min");
+
+    RunBenchmark(&Context, "hash_u32", BenchmarkHashU32, OperationCount);
+    RunBenchmark(&Context, "hash_string_16", BenchmarkHashString, OperationCount);
+    RunBenchmark(&Context, "random_next_u32", BenchmarkRandomNextU32, OperationCount);
+    RunBenchmark(&Context, "random_between_scalar", BenchmarkRandomBetweenScalar, OperationCount);
+    RunBenchmark(&Context, "random_fill_between_lanes", BenchmarkRandomFillBetween, OperationCount);
+    RunBenchmark(&Context, "random_lanes_scalar", BenchmarkRandomLanesScalar, OperationCount);
+#if FUZZY_SSE2
+    RunBenchmark(&Context, "random_lanes_sse2", BenchmarkRandomLanesSSE2, OperationCount);
+#endif
+#if FUZZY_AVX2
+    if (SimdHasAVX2)
+    {
+        RunBenchmark(&Context, "random_lanes_avx2", BenchmarkRandomLanesAVX2, OperationCount);
+    }
+#endif
+
+    RunBenchmark(&Context, "instance_models_glm", BenchmarkInstanceModelsGlm, OperationCount);
+    RunBenchmark(&Context, "instance_transforms_scalar", BenchmarkInstanceTransformsScalar, OperationCount);
+#if FUZZY_SSE2
+    RunBenchmark(&Context, "instance_transforms_sse2", BenchmarkInstanceTransformsSSE2, OperationCount);
+#endif
+#if FUZZY_AVX2
+    if (SimdHasAVX2)
+    {
+        RunBenchmark(&Context, "instance_transforms_avx2", BenchmarkInstanceTransformsAVX2, OperationCount);
+    }
+#endif
+
+    RunBenchmark(&Context, "arena_push_size", BenchmarkPushSize, OperationCount);
+    RunBenchmark(&Context, "arena_push_size_aligned_64", BenchmarkPushSizeAligned, OperationCount);
+
+    RunBenchmark(&Context, "hash_table_create", BenchmarkHashTableCreate, OperationCount);
+    RunBenchmark(&Context, "hash_table_build", BenchmarkHashTableBuild, OperationCount);
+    RunBenchmark(&Context, "hash_table_get_hit", BenchmarkHashTableGetHit, OperationCount);
+    RunBenchmark(&Context, "hash_table_get_miss", BenchmarkHashTableGetMiss, OperationCount);
+    RunBenchmark(&Context, "chained_hash_table_create", BenchmarkChainedHashTableCreate, OperationCount);
+    RunBenchmark(&Context, "chained_hash_table_get_hit", BenchmarkChainedHashTableGetHit, OperationCount);
+    RunBenchmark(&Context, "chained_hash_table_get_miss", BenchmarkChainedHashTableGetMiss, OperationCount);
+
+    RunBenchmark(&Context, "stack_push_pop", BenchmarkStackPushPop, OperationCount);
+    RunBenchmark(&Context, "queue_enqueue_dequeue", BenchmarkQueueEnqueueDequeue, OperationCount);
+    RunBenchmark(&Context, "mpsc_queue_single_thread", BenchmarkMpscQueueSingleThread, OperationCount);
+    RunBenchmark(&Context, "mpsc_queue_contended", BenchmarkMpscQueueContended, OperationCount);
+
+    RunBenchmark(&Context, "slot_map_insert_remove", BenchmarkSlotMapInsertRemove, OperationCount);
+    RunBenchmark(&Context, "slot_map_get", BenchmarkSlotMapGet, OperationCount);
+    RunBenchmark(&Context, "sparse_set_get", BenchmarkSparseSetGet, OperationCount);
+    RunBenchmark(&Context, "memory_pool_alloc_free", BenchmarkMemoryPoolAllocFree, OperationCount);
+
+    RunBenchmark(&Context, "physics_step_replay", BenchmarkPhysicsStep, BENCHMARK_REPLAY_TICKS);
+    RunBenchmark(&Context, "sweep_aos_scalar_16k", BenchmarkSweepAoS, 64);
+    RunBenchmark(&Context, "sweep_soa_scalar_16k", BenchmarkSweepSoaScalar, 64);
+#if !FUZZY_FIXED_POINT && FUZZY_SSE2
+    RunBenchmark(&Context, "sweep_soa_sse2_16k", BenchmarkSweepSoaSSE2, 64);
+#endif
+#if !FUZZY_FIXED_POINT && FUZZY_AVX2
+    if (SimdHasAVX2)
+    {
+        RunBenchmark(&Context, "sweep_soa_avx2_16k", BenchmarkSweepSoaAVX2, 64);
+    }
+#endif
+    RunBenchmark(&Context, "broadphase_grid_16k", BenchmarkBroadphaseGrid, 64);
+    RunBenchmark(&Context, "tile_grid_sweep", BenchmarkTileGridSweep, 4096);
+    RunBenchmark(&Context, "tile_box_grid_sweep", BenchmarkTileBoxGridSweep, 4096);
+    RunBenchmark(&Context, "physics_bodies_4k_serial", BenchmarkPhysicsBodiesSerial, BENCHMARK_PHYSICS_BODY_COUNT);
+    RunBenchmark(&Context, "physics_bodies_4k_parallel", BenchmarkPhysicsBodiesParallel, BENCHMARK_PHYSICS_BODY_COUNT);
+
+    b32 IsDeterministic = CheckReplayDeterminism(&Context);
+    b32 SweepKernelsMatch = CheckSweepKernels(&Context);
+    b32 TileGridMatches = CheckTileGridQueries(&Context);
+    b32 TileBoxesMerge = CheckTileBoxMerge(&Context);
+    b32 PhysicsIsDeterministic = CheckPhysicsDeterminism(&Context);
+    b32 MemoryPoolWorks = CheckMemoryPool(&Context);
+    b32 MpscQueueIsOrdered = CheckMpscQueue(&Context);
+
+    if (!WriteResultsJson(&Context, OutputFileName))
+    {
+        printf("Failed to write %s\n", OutputFileName);
+        return 1;
+    }
+
+    printf("Results written to %s (sink %llu)\n", OutputFileName, (unsigned long long)Context.Sink);
+
+    free(ArenaMemory);
+
+    return IsDeterministic && SweepKernelsMatch && TileGridMatches && TileBoxesMerge && PhysicsIsDeterministic && MemoryPoolWorks && MpscQueueIsOrdered ? 0 : 1;
+}
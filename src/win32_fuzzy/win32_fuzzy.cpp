@@ -1,4 +1,7 @@
 #include <windows.h>
+#include <evntrace.h>
+#include <evntcons.h>
+#include <wctype.h>
 #include <cstdlib>
 #include <string>
 #include <cassert>
@@ -13,6 +16,7 @@
 #include "fuzzy_types.h"
 #include "fuzzy_memory.h"
 #include "fuzzy_platform.h"
+#include "fuzzy_platform_work_queue.h"
 #include "win32_fuzzy.h"
 
 #pragma warning(disable:4302)
@@ -212,6 +216,424 @@ PLATFORM_READ_FILE(PlatformReadFile)
     return Result;
 }
 
+PLATFORM_COMMIT_MEMORY(PlatformCommitMemory)
+{
+    void *Result = VirtualAlloc(Base, Size, MEM_COMMIT, PAGE_READWRITE);
+    return Result != 0;
+}
+
+// note: large pages need SeLockMemoryPrivilege ("Lock pages in memory" in the local security policy)
+internal b32
+Win32EnableLockMemoryPrivilege()
+{
+    b32 Result = false;
+
+    HANDLE Token;
+    if (OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &Token))
+    {
+        TOKEN_PRIVILEGES Privileges = {};
+        Privileges.PrivilegeCount = 1;
+        Privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+        if (LookupPrivilegeValueA(0, "SeLockMemoryPrivilege", &Privileges.Privileges[0].Luid))
+        {
+            AdjustTokenPrivileges(Token, FALSE, &Privileges, 0, 0, 0);
+            // note: AdjustTokenPrivileges succeeds even if the privilege wasn't granted
+            Result = (GetLastError() == ERROR_SUCCESS);
+        }
+
+        CloseHandle(Token);
+    }
+
+    return Result;
+}
+
+// note: returns false when the block couldn't be reserved or the start of permanent storage couldn't be committed
+internal b32
+Win32AllocateGameMemory(win32_state *State, game_memory *GameMemory, void *BaseAddress)
+{
+    SYSTEM_INFO SystemInfo;
+    GetSystemInfo(&SystemInfo);
+
+    GameMemory->PageSize = SystemInfo.dwPageSize;
+    GameMemory->UsesLargePages = false;
+
+    if (State->UseLargePages)
+    {
+        u64 LargePageSize = GetLargePageMinimum();
+
+        if (!LargePageSize)
+        {
+            PlatformPrintOutput("Large pages are not supported\n");
+        }
+        else if (!Win32EnableLockMemoryPrivilege())
+        {
+            PlatformPrintOutput("Large pages need the lock pages in memory privilege\n");
+        }
+        else
+        {
+            // note: large pages can't be committed lazily, so the block is smaller and fully backed
+            GameMemory->PermanentStorageSize = AlignUp(Megabytes(256), LargePageSize);
+            GameMemory->TransientStorageSize = AlignUp(Megabytes(768), LargePageSize);
+
+            State->TotalSize = GameMemory->PermanentStorageSize + GameMemory->TransientStorageSize;
+            State->GameMemoryBlock = VirtualAlloc(BaseAddress, State->TotalSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+            if (State->GameMemoryBlock)
+            {
+                GameMemory->PageSize = LargePageSize;
+                GameMemory->UsesLargePages = true;
+
+                GameMemory->PermanentStorageCommittedSize = GameMemory->PermanentStorageSize;
+                GameMemory->TransientStorageCommittedSize = GameMemory->TransientStorageSize;
+            }
+            else
+            {
+                PlatformPrintOutput("Failed to allocate game memory with large pages\n");
+            }
+        }
+    }
+
+    if (!State->GameMemoryBlock)
+    {
+        // note: only address space is reserved here, arenas commit pages as they grow
+        GameMemory->PermanentStorageSize = Gigabytes(4);
+        GameMemory->TransientStorageSize = Gigabytes(4);
+
+        State->TotalSize = GameMemory->PermanentStorageSize + GameMemory->TransientStorageSize;
+        State->GameMemoryBlock = VirtualAlloc(BaseAddress, State->TotalSize, MEM_RESERVE, PAGE_NOACCESS);
+
+        if (!State->GameMemoryBlock)
+        {
+            return false;
+        }
+
+        // note: game_state lives at the start of permanent storage, so it has to be backed before the first frame
+        GameMemory->PermanentStorageCommittedSize = Megabytes(1);
+        GameMemory->TransientStorageCommittedSize = 0;
+
+        if (!PlatformCommitMemory(State->GameMemoryBlock, GameMemory->PermanentStorageCommittedSize))
+        {
+            return false;
+        }
+    }
+
+    GameMemory->PermanentStorage = State->GameMemoryBlock;
+    GameMemory->TransientStorage = (u8*)GameMemory->PermanentStorage + GameMemory->PermanentStorageSize;
+
+    char Report[256];
+    sprintf_s(Report, sizeof(Report), "Game memory: %llu MB reserved, %llu KB pages%s\n", 
+        State->TotalSize / Megabytes(1), GameMemory->PageSize / Kilobytes(1), GameMemory->UsesLargePages ? " (large)" : "");
+    PlatformPrintOutput(Report);
+
+    return true;
+}
+
+PLATFORM_WRITE_FILE(PlatformWriteFile)
+{
+    b32 Result = false;
+
+    HANDLE FileHandle = CreateFileA(FileName, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, 0, 0);
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        DWORD BytesWritten;
+        if (WriteFile(FileHandle, Contents, Size, &BytesWritten, 0))
+        {
+            Result = (BytesWritten == Size);
+        }
+        else
+        {
+            // todo: logging
+        }
+
+        CloseHandle(FileHandle);
+    }
+    else
+    {
+        // todo: logging
+    }
+
+    return Result;
+}
+
+internal
+PLATFORM_SIGNAL_WORK_QUEUE(Win32SignalWorkQueue)
+{
+    if (!ReleaseSemaphore((HANDLE)Queue->SignalHandle, 1, 0))
+    {
+        // note: the count is already at its maximum, so the workers have more wakeups pending than there are entries
+        Assert(GetLastError() == ERROR_TOO_MANY_POSTS);
+    }
+}
+
+internal DWORD WINAPI
+Win32WorkerThreadProc(LPVOID Parameter)
+{
+    platform_work_queue *Queue = (platform_work_queue *)Parameter;
+
+    for (;;)
+    {
+        if (!DoNextPlatformWorkQueueEntry(Queue))
+        {
+            WaitForSingleObjectEx((HANDLE)Queue->SignalHandle, INFINITE, FALSE);
+        }
+    }
+}
+
+// note: ThreadIds gets the ids of the ThreadCount workers
+internal void
+Win32InitializeWorkQueue(platform_work_queue *Queue, u32 ThreadCount, DWORD *ThreadIds)
+{
+    // note: one pending wakeup per entry the ring can hold, workers that find entries without waiting leave theirs behind
+    HANDLE SemaphoreHandle = CreateSemaphoreExA(0, 0, PLATFORM_WORK_QUEUE_ENTRY_COUNT, 0, 0, SEMAPHORE_ALL_ACCESS);
+    Assert(SemaphoreHandle);
+
+    InitializePlatformWorkQueue(Queue, Win32SignalWorkQueue, SemaphoreHandle);
+
+    for (u32 ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        HANDLE ThreadHandle = CreateThread(0, 0, Win32WorkerThreadProc, Queue, 0, ThreadIds + ThreadIndex);
+        CloseHandle(ThreadHandle);
+    }
+}
+
+// note: kernel thread events, CSwitch is opcode 36
+global const GUID Win32ThreadEventsGuid = { 0x3d6fa8d1, 0xfe05, 0x11d0, { 0x9d, 0xda, 0x00, 0xc0, 0x4f, 0xd7, 0xba, 0x7c } };
+global const GUID Win32PmcSessionGuid = { 0x6a2c1d4e, 0x93b7, 0x4f0e, { 0x8c, 0x51, 0x2e, 0x7a, 0x0b, 0x94, 0xd3, 0x16 } };
+
+#define WIN32_CSWITCH_OPCODE 36
+
+internal EVENT_TRACE_PROPERTIES *
+Win32ResetPmcSessionProperties(win32_pmc_sampler *Sampler)
+{
+    ZeroMemory(Sampler->PropertiesBuffer, sizeof(Sampler->PropertiesBuffer));
+
+    EVENT_TRACE_PROPERTIES *Result = (EVENT_TRACE_PROPERTIES *)Sampler->PropertiesBuffer;
+    Result->Wnode.BufferSize = sizeof(Sampler->PropertiesBuffer);
+    Result->Wnode.Flags = WNODE_FLAG_TRACED_GUID;
+    // note: query performance counter timestamps
+    Result->Wnode.ClientContext = 1;
+    Result->Wnode.Guid = Win32PmcSessionGuid;
+    Result->LogFileMode = EVENT_TRACE_REAL_TIME_MODE | EVENT_TRACE_SYSTEM_LOGGER_MODE;
+    Result->FlushTimer = 1;
+    Result->LoggerNameOffset = sizeof(EVENT_TRACE_PROPERTIES);
+
+    return Result;
+}
+
+inline b32
+Win32IsPmcTrackedThread(win32_pmc_sampler *Sampler, DWORD ThreadId)
+{
+    b32 Result = false;
+
+    for (u32 ThreadIndex = 0; ThreadIndex < Sampler->ThreadCount; ++ThreadIndex)
+    {
+        if (Sampler->ThreadIds[ThreadIndex] == ThreadId)
+        {
+            Result = true;
+            break;
+        }
+    }
+
+    return Result;
+}
+
+internal void WINAPI
+Win32PmcEventRecordCallback(EVENT_RECORD *EventRecord)
+{
+    win32_pmc_sampler *Sampler = (win32_pmc_sampler *)EventRecord->UserContext;
+
+    if (EventRecord->EventHeader.EventDescriptor.Opcode != WIN32_CSWITCH_OPCODE || 
+        !IsEqualGUID(EventRecord->EventHeader.ProviderId, Win32ThreadEventsGuid) || 
+        EventRecord->UserDataLength < 2 * sizeof(u32))
+    {
+        return;
+    }
+
+    EVENT_EXTENDED_ITEM_PMC_COUNTERS *Counters = 0;
+
+    for (u32 ItemIndex = 0; ItemIndex < EventRecord->ExtendedDataCount; ++ItemIndex)
+    {
+        EVENT_HEADER_EXTENDED_DATA_ITEM *Item = EventRecord->ExtendedData + ItemIndex;
+
+        if (Item->ExtType == EVENT_HEADER_EXT_TYPE_PMC_COUNTERS)
+        {
+            Counters = (EVENT_EXTENDED_ITEM_PMC_COUNTERS *)Item->DataPtr;
+        }
+    }
+
+    u32 Processor = EventRecord->BufferContext.ProcessorIndex;
+
+    if (Counters && Processor < WIN32_PMC_MAX_PROCESSORS)
+    {
+        // note: CSwitch starts with the new and the old thread id
+        u32 *ThreadIds = (u32 *)EventRecord->UserData;
+        u64 Count = Counters->Counter[0];
+
+        if (Sampler->IsTrackedThreadRunning[Processor] && Win32IsPmcTrackedThread(Sampler, ThreadIds[1]))
+        {
+            Sampler->DTLBMisses.fetch_add(Count - Sampler->SwitchInCounts[Processor], std::memory_order_relaxed);
+        }
+
+        Sampler->IsTrackedThreadRunning[Processor] = Win32IsPmcTrackedThread(Sampler, ThreadIds[0]);
+        Sampler->SwitchInCounts[Processor] = Count;
+    }
+}
+
+internal DWORD WINAPI
+Win32PmcConsumerThreadProc(LPVOID Parameter)
+{
+    win32_pmc_sampler *Sampler = (win32_pmc_sampler *)Parameter;
+
+    // note: returns once the session is stopped
+    ProcessTrace(&Sampler->TraceHandle, 1, 0, 0);
+
+    return 0;
+}
+
+// note: the profile source has to be registered first, windows only lists a handful of generic ones by default
+internal b32
+Win32FindDTLBMissProfileSource(ULONG *Source)
+{
+    b32 Result = false;
+
+    persist u8 Buffer[Kilobytes(16)];
+    ULONG ReturnLength = 0;
+
+    if (TraceQueryInformation(0, TraceProfileSourceListInfo, Buffer, sizeof(Buffer), &ReturnLength) == ERROR_SUCCESS)
+    {
+        PROFILE_SOURCE_INFO *Info = (PROFILE_SOURCE_INFO *)Buffer;
+
+        for (;;)
+        {
+            wchar Description[64] = {};
+            for (u32 CharIndex = 0; CharIndex < ArrayCount(Description) - 1 && Info->Description[CharIndex]; ++CharIndex)
+            {
+                Description[CharIndex] = (wchar)towlower(Info->Description[CharIndex]);
+            }
+
+            if (wcsstr(Description, L"dtlb"))
+            {
+                *Source = Info->Source;
+                Result = true;
+                break;
+            }
+
+            if (Info->NextEntryOffset == 0)
+            {
+                break;
+            }
+
+            Info = (PROFILE_SOURCE_INFO *)((u8 *)Info + Info->NextEntryOffset);
+        }
+    }
+
+    return Result;
+}
+
+internal void
+Win32StopPmcSampler(win32_pmc_sampler *Sampler)
+{
+    if (Sampler->IsRunning)
+    {
+        ControlTraceA(Sampler->SessionHandle, 0, Win32ResetPmcSessionProperties(Sampler), EVENT_TRACE_CONTROL_STOP);
+        CloseTrace(Sampler->TraceHandle);
+
+        Sampler->IsRunning = false;
+    }
+}
+
+// note: ThreadIds are the threads whose misses are counted; failing leaves the counters unavailable, the reason goes to the output
+internal b32
+Win32StartPmcSampler(win32_pmc_sampler *Sampler, DWORD *ThreadIds, u32 ThreadCount)
+{
+    Sampler->ThreadCount = ThreadCount < WIN32_PMC_MAX_THREADS ? ThreadCount : WIN32_PMC_MAX_THREADS;
+    for (u32 ThreadIndex = 0; ThreadIndex < Sampler->ThreadCount; ++ThreadIndex)
+    {
+        Sampler->ThreadIds[ThreadIndex] = ThreadIds[ThreadIndex];
+    }
+
+    ULONG Source;
+    if (!Win32FindDTLBMissProfileSource(&Source))
+    {
+        PlatformPrintOutput("No dtlb miss profile source is registered, dtlb misses are unavailable\n");
+        return false;
+    }
+
+    ULONG Status = StartTraceA(&Sampler->SessionHandle, WIN32_PMC_SESSION_NAME, Win32ResetPmcSessionProperties(Sampler));
+
+    if (Status == ERROR_ALREADY_EXISTS)
+    {
+        // note: left over from a run that didn't shut down cleanly
+        ControlTraceA(0, WIN32_PMC_SESSION_NAME, Win32ResetPmcSessionProperties(Sampler), EVENT_TRACE_CONTROL_STOP);
+        Status = StartTraceA(&Sampler->SessionHandle, WIN32_PMC_SESSION_NAME, Win32ResetPmcSessionProperties(Sampler));
+    }
+
+    if (Status != ERROR_SUCCESS)
+    {
+        PlatformPrintOutput(Status == ERROR_ACCESS_DENIED ? 
+            "Counting dtlb misses needs admin rights, dtlb misses are unavailable\n" : 
+            "Failed to start the pmc trace session, dtlb misses are unavailable\n");
+        return false;
+    }
+
+    // note: counters and the events that sample them have to be set before the events are enabled
+    CLASSIC_EVENT_ID SwitchEvent = {};
+    SwitchEvent.EventGuid = Win32ThreadEventsGuid;
+    SwitchEvent.Type = WIN32_CSWITCH_OPCODE;
+
+    ULONG EnableFlags[8] = { EVENT_TRACE_FLAG_CSWITCH };
+
+    b32 IsConfigured = 
+        TraceSetInformation(Sampler->SessionHandle, TracePmcCounterListInfo, &Source, sizeof(Source)) == ERROR_SUCCESS &&
+        TraceSetInformation(Sampler->SessionHandle, TracePmcEventListInfo, &SwitchEvent, sizeof(SwitchEvent)) == ERROR_SUCCESS &&
+        TraceSetInformation(Sampler->SessionHandle, TraceSystemTraceEnableFlagsInfo, EnableFlags, sizeof(EnableFlags)) == ERROR_SUCCESS;
+
+    char LoggerName[] = WIN32_PMC_SESSION_NAME;
+
+    EVENT_TRACE_LOGFILEA LogFile = {};
+    LogFile.LoggerName = LoggerName;
+    LogFile.ProcessTraceMode = PROCESS_TRACE_MODE_REAL_TIME | PROCESS_TRACE_MODE_EVENT_RECORD;
+    LogFile.EventRecordCallback = Win32PmcEventRecordCallback;
+    LogFile.Context = Sampler;
+
+    Sampler->TraceHandle = IsConfigured ? OpenTraceA(&LogFile) : INVALID_PROCESSTRACE_HANDLE;
+
+    if (Sampler->TraceHandle == INVALID_PROCESSTRACE_HANDLE)
+    {
+        ControlTraceA(Sampler->SessionHandle, 0, Win32ResetPmcSessionProperties(Sampler), EVENT_TRACE_CONTROL_STOP);
+        PlatformPrintOutput("Failed to set up the pmc trace session, dtlb misses are unavailable\n");
+        return false;
+    }
+
+    Sampler->IsRunning = true;
+
+    HANDLE ThreadHandle = CreateThread(0, 0, Win32PmcConsumerThreadProc, Sampler, 0, 0);
+    CloseHandle(ThreadHandle);
+
+    return true;
+}
+
+// note: once a frame on the game thread
+internal void
+Win32UpdateFrameCounters(win32_pmc_sampler *Sampler, game_frame_counters *Counters, f64 Time)
+{
+    Counters->IsAvailable = Sampler->IsRunning;
+
+    ++Sampler->FramesSinceSample;
+
+    if (Sampler->IsRunning && Time - Sampler->LastSampleTime >= 1.0)
+    {
+        u64 DTLBMisses = Sampler->DTLBMisses.load(std::memory_order_relaxed);
+
+        Counters->DTLBMisses = (DTLBMisses - Sampler->SampledDTLBMisses) / Sampler->FramesSinceSample;
+
+        Sampler->SampledDTLBMisses = DTLBMisses;
+        Sampler->FramesSinceSample = 0;
+        Sampler->LastSampleTime = Time;
+    }
+}
+
 #if 0
 int CALLBACK WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 #else
@@ -221,26 +643,56 @@ int main(int argc, char *argv[])
     win32_state Win32State = {};
     game_memory GameMemory = {};
 
-    GameMemory.PermanentStorageSize = Megabytes(64);
-    GameMemory.TransientStorageSize = Megabytes(128);
+    for (i32 ArgIndex = 1; ArgIndex < argc; ++ArgIndex)
+    {
+        if (strcmp(argv[ArgIndex], "-largepages") == 0)
+        {
+            Win32State.UseLargePages = true;
+        }
+    }
 
     void *BaseAddress = (void*)Terabytes(2);
-
-    Win32State.TotalSize = GameMemory.PermanentStorageSize + GameMemory.TransientStorageSize;
-    Win32State.GameMemoryBlock = VirtualAlloc(BaseAddress, Win32State.TotalSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
-
-    GameMemory.PermanentStorage = Win32State.GameMemoryBlock;
-    GameMemory.TransientStorage = (u8*)GameMemory.PermanentStorage + GameMemory.PermanentStorageSize;
+    if (!Win32AllocateGameMemory(&Win32State, &GameMemory, BaseAddress))
+    {
+        OutputDebugStringA("Failed to allocate game memory\n");
+        return EXIT_FAILURE;
+    }
 
     GameMemory.Platform = {};
     GameMemory.Platform.ReadFile = PlatformReadFile;
     GameMemory.Platform.FreeFile = PlatformFreeFile;
+    GameMemory.Platform.WriteFile = PlatformWriteFile;
+    GameMemory.Platform.CommitMemory = PlatformCommitMemory;
+    GameMemory.Platform.GetWallClock = glfwGetTime;
     GameMemory.Platform.PrintOutput = PlatformPrintOutput;
 
     // todo: these functions will be in asset builder
     GameMemory.Platform.ReadImageFile = stbi_load;
     GameMemory.Platform.FreeImageFile = stbi_image_free;
 
+    // note: one worker per logical core besides the game thread, which helps out in CompleteAllWork
+    SYSTEM_INFO SystemInfo;
+    GetSystemInfo(&SystemInfo);
+
+    u32 WorkerCount = SystemInfo.dwNumberOfProcessors > 1 ? SystemInfo.dwNumberOfProcessors - 1 : 0;
+
+    // note: the game thread first, then the workers
+    DWORD GameThreadIds[WIN32_PMC_MAX_THREADS];
+    GameThreadIds[0] = GetCurrentThreadId();
+
+    WorkerCount = WorkerCount < WIN32_PMC_MAX_THREADS - 1 ? WorkerCount : WIN32_PMC_MAX_THREADS - 1;
+
+    platform_work_queue WorkQueue = {};
+    Win32InitializeWorkQueue(&WorkQueue, WorkerCount, GameThreadIds + 1);
+
+    persist win32_pmc_sampler PmcSampler = {};
+    Win32StartPmcSampler(&PmcSampler, GameThreadIds, WorkerCount + 1);
+
+    GameMemory.Platform.WorkQueue.Queue = &WorkQueue;
+    GameMemory.Platform.WorkQueue.WorkerCount = WorkerCount;
+    GameMemory.Platform.WorkQueue.AddEntry = AddPlatformWorkEntry;
+    GameMemory.Platform.WorkQueue.CompleteAllWork = CompleteAllPlatformWork;
+
     Win32InitOpenGLRenderer(&GameMemory);
 
     Win32GetFullPathToEXEDirectory(&Win32State);
@@ -320,6 +772,12 @@ int main(int argc, char *argv[])
             case GLFW_KEY_S:
                 GameParams.Input.Attack.isPressed = true;
                 break;
+            case GLFW_KEY_F1:
+                GameParams.Input.DumpMemoryStats.isPressed = true;
+                break;
+            case GLFW_KEY_F2:
+                GameParams.Input.Rewind.isPressed = true;
+                break;
             default:
                 break;
             }
@@ -352,6 +810,14 @@ int main(int argc, char *argv[])
                 GameParams.Input.Attack.isPressed = false;
                 GameParams.Input.Attack.isProcessed = false;
                 break;
+            case GLFW_KEY_F1:
+                GameParams.Input.DumpMemoryStats.isPressed = false;
+                GameParams.Input.DumpMemoryStats.isProcessed = false;
+                break;
+            case GLFW_KEY_F2:
+                GameParams.Input.Rewind.isPressed = false;
+                GameParams.Input.Rewind.isProcessed = false;
+                break;
             default:
                 break;
             }
@@ -407,6 +873,8 @@ int main(int argc, char *argv[])
         TotalTime = glfwGetTime();
         GameParams.msPerFrame = (f32)(TotalTime - LastTime) * 1000.f;
         LastTime = TotalTime;
+
+        Win32UpdateFrameCounters(&PmcSampler, &GameParams.Counters, TotalTime);
         
         if (GameCode.IsValid) 
         {
@@ -417,6 +885,8 @@ int main(int argc, char *argv[])
         glfwSwapBuffers(Window);
     }
 
+    Win32StopPmcSampler(&PmcSampler);
+
     glfwTerminate();
     return EXIT_SUCCESS;
 }
@@ -5,6 +5,7 @@ struct win32_state
 {
     u64 TotalSize;
     void *GameMemoryBlock;
+    b32 UseLargePages;
 
     char EXEDirectoryFullPath[WIN32_FILE_PATH];
 };
@@ -18,3 +19,34 @@ struct win32_game_code
 
     b32 IsValid;
 };
+
+#define WIN32_PMC_SESSION_NAME "fuzzy_pmc"
+#define WIN32_PMC_MAX_THREADS 64
+#define WIN32_PMC_MAX_PROCESSORS 256
+
+// note: kernel trace session that samples a dtlb miss profile source on every context switch; a thread's misses are the
+// difference between the processor's counter when it was switched in and when it was switched out
+struct win32_pmc_sampler
+{
+    b32 IsRunning;
+
+    TRACEHANDLE SessionHandle;
+    TRACEHANDLE TraceHandle;
+
+    u8 PropertiesBuffer[sizeof(EVENT_TRACE_PROPERTIES) + sizeof(WIN32_PMC_SESSION_NAME)];
+
+    // note: the game thread and the work queue's workers
+    u32 ThreadCount;
+    DWORD ThreadIds[WIN32_PMC_MAX_THREADS];
+
+    // note: only touched by the consumer thread
+    b32 IsTrackedThreadRunning[WIN32_PMC_MAX_PROCESSORS];
+    u64 SwitchInCounts[WIN32_PMC_MAX_PROCESSORS];
+
+    std::atomic<u64> DTLBMisses;
+
+    // note: game thread side, the per-frame figure is refreshed about once a second
+    u64 SampledDTLBMisses;
+    u32 FramesSinceSample;
+    f64 LastSampleTime;
+};